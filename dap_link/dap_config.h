@@ -6,6 +6,7 @@
 
 /*- Includes ----------------------------------------------------------------*/
 #include <furi_hal_gpio.h>
+#include <furi_hal_cortex.h>
 
 /*- Definitions -------------------------------------------------------------*/
 #define DAP_CONFIG_ENABLE_JTAG
@@ -14,7 +15,7 @@
 #define DAP_CONFIG_DEFAULT_CLOCK 4200000 // Hz
 
 #define DAP_CONFIG_PACKET_SIZE 64
-#define DAP_CONFIG_PACKET_COUNT 1
+#define DAP_CONFIG_PACKET_COUNT 4
 
 #define DAP_CONFIG_JTAG_DEV_COUNT 8
 
@@ -28,7 +29,9 @@
 #define DAP_CONFIG_VENDOR_FN dap_app_vendor_cmd
 
 // Attribute to use for performance-critical functions
-#define DAP_CONFIG_PERFORMANCE_ATTR
+// The app is loaded into SRAM by the FAP loader, so the bit loops already run from RAM,
+// they only need to be built with full optimization instead of the default -Os
+#define DAP_CONFIG_PERFORMANCE_ATTR __attribute__((hot, optimize("O3")))
 
 // A value at which dap_clock_test() produces 1 kHz output on the SWCLK pin
 // #define DAP_CONFIG_DELAY_CONSTANT 19000
@@ -38,6 +41,33 @@
 // This is the frequency produced by dap_clock_test(1) on the SWCLK pin
 #define DAP_CONFIG_FAST_CLOCK 2400000 // Hz
 
+// dap_init() measures the SWCLK frequency of every delay with the cycle counter and
+// dap_swj_clock() picks from that table instead of the two constants above
+#define DAP_CONFIG_CYCLE_COUNTER() (DWT->CYCCNT)
+#define DAP_CONFIG_CPU_FREQ (furi_hal_cortex_instructions_per_microsecond() * 1000000U)
+
+// Count, execution time, WAIT and FAULT retries of every command, see dap_profile_get()
+#define DAP_CONFIG_ENABLE_PROFILE
+#define DAP_CONFIG_PROFILE_COUNTER() DAP_CONFIG_CYCLE_COUNTER()
+
+// SWO capture in UART mode on LPUART1, see swo/dap_swo.h
+#define DAP_CONFIG_ENABLE_SWO
+#define DAP_CONFIG_SWO_BUFFER_SIZE (16 * 1024)
+#define DAP_CONFIG_SWO_START dap_swo_start
+#define DAP_CONFIG_SWO_STOP dap_swo_stop
+#define DAP_CONFIG_SWO_BAUDRATE dap_swo_baudrate
+#define DAP_CONFIG_SWO_COUNT dap_swo_count
+#define DAP_CONFIG_SWO_READ dap_swo_read
+#define DAP_CONFIG_SWO_ERRORS dap_swo_errors
+
+// Clock the SWD transfers of DAP_TransferBlock with TIM2 and DMA2 instead of the CPU,
+// see swd/dap_swd_dma.h. Blocks fall back to the CPU if the timer is in use.
+// #define DAP_CONFIG_SWD_ENGINE
+#define DAP_CONFIG_SWD_ENGINE_START dap_swd_dma_start
+#define DAP_CONFIG_SWD_ENGINE_STOP dap_swd_dma_stop
+#define DAP_CONFIG_SWD_ENGINE_WRITE dap_swd_dma_write
+#define DAP_CONFIG_SWD_ENGINE_READ dap_swd_dma_read
+
 /*- Prototypes --------------------------------------------------------------*/
 extern char usb_serial_number[16];
 
@@ -48,6 +78,34 @@ extern GpioPin flipper_dap_reset_pin;
 extern GpioPin flipper_dap_tdo_pin;
 extern GpioPin flipper_dap_tdi_pin;
 
+// Ports and masks of the pins used in the bit loops, filled in by dap_init_gpio()
+typedef struct {
+    GPIO_TypeDef* swclk_port;
+    uint32_t swclk_mask;
+    GPIO_TypeDef* swdio_port;
+    uint32_t swdio_mask;
+    uint32_t swdio_moder_mask;
+    uint32_t swdio_moder_output;
+    GPIO_TypeDef* tdi_port;
+    uint32_t tdi_mask;
+    GPIO_TypeDef* tdo_port;
+    uint32_t tdo_mask;
+} DapGpio;
+
+extern DapGpio flipper_dap_gpio;
+
+extern bool dap_swd_dma_start(uint32_t clock);
+extern void dap_swd_dma_stop(void);
+extern void dap_swd_dma_write(uint64_t value, int size);
+extern uint64_t dap_swd_dma_read(int size);
+
+extern bool dap_swo_start(uint32_t baudrate, bool streaming);
+extern void dap_swo_stop(void);
+extern uint32_t dap_swo_baudrate(uint32_t baudrate);
+extern uint32_t dap_swo_count(void);
+extern uint32_t dap_swo_read(uint8_t* data, uint32_t size);
+extern uint8_t dap_swo_errors(void);
+
 extern void dap_app_vendor_cmd(uint8_t cmd);
 extern void dap_app_target_reset();
 extern void dap_app_disconnect();
@@ -56,18 +114,18 @@ extern void dap_app_connect_jtag();
 
 //-----------------------------------------------------------------------------
 static inline void DAP_CONFIG_SWCLK_TCK_write(int value) {
-    furi_hal_gpio_write(&flipper_dap_swclk_pin, value);
+    flipper_dap_gpio.swclk_port->BSRR = flipper_dap_gpio.swclk_mask << (value ? 0 : 16);
 }
 
 //-----------------------------------------------------------------------------
 static inline void DAP_CONFIG_SWDIO_TMS_write(int value) {
-    furi_hal_gpio_write(&flipper_dap_swdio_pin, value);
+    flipper_dap_gpio.swdio_port->BSRR = flipper_dap_gpio.swdio_mask << (value ? 0 : 16);
 }
 
 //-----------------------------------------------------------------------------
 static inline void DAP_CONFIG_TDI_write(int value) {
 #ifdef DAP_CONFIG_ENABLE_JTAG
-    furi_hal_gpio_write(&flipper_dap_tdi_pin, value);
+    flipper_dap_gpio.tdi_port->BSRR = flipper_dap_gpio.tdi_mask << (value ? 0 : 16);
 #else
     (void)value;
 #endif
@@ -94,18 +152,18 @@ static inline void DAP_CONFIG_nRESET_write(int value) {
 
 //-----------------------------------------------------------------------------
 static inline int DAP_CONFIG_SWCLK_TCK_read(void) {
-    return furi_hal_gpio_read(&flipper_dap_swclk_pin);
+    return (flipper_dap_gpio.swclk_port->IDR & flipper_dap_gpio.swclk_mask) ? 1 : 0;
 }
 
 //-----------------------------------------------------------------------------
 static inline int DAP_CONFIG_SWDIO_TMS_read(void) {
-    return furi_hal_gpio_read(&flipper_dap_swdio_pin);
+    return (flipper_dap_gpio.swdio_port->IDR & flipper_dap_gpio.swdio_mask) ? 1 : 0;
 }
 
 //-----------------------------------------------------------------------------
 static inline int DAP_CONFIG_TDO_read(void) {
 #ifdef DAP_CONFIG_ENABLE_JTAG
-    return furi_hal_gpio_read(&flipper_dap_tdo_pin);
+    return (flipper_dap_gpio.tdo_port->IDR & flipper_dap_gpio.tdo_mask) ? 1 : 0;
 #else
     return 0;
 #endif
@@ -114,7 +172,7 @@ static inline int DAP_CONFIG_TDO_read(void) {
 //-----------------------------------------------------------------------------
 static inline int DAP_CONFIG_TDI_read(void) {
 #ifdef DAP_CONFIG_ENABLE_JTAG
-    return furi_hal_gpio_read(&flipper_dap_tdi_pin);
+    return (flipper_dap_gpio.tdi_port->IDR & flipper_dap_gpio.tdi_mask) ? 1 : 0;
 #else
     return 0;
 #endif
@@ -132,22 +190,24 @@ static inline int DAP_CONFIG_nRESET_read(void) {
 
 //-----------------------------------------------------------------------------
 static inline void DAP_CONFIG_SWCLK_TCK_set(void) {
-    LL_GPIO_SetOutputPin(flipper_dap_swclk_pin.port, flipper_dap_swclk_pin.pin);
+    flipper_dap_gpio.swclk_port->BSRR = flipper_dap_gpio.swclk_mask;
 }
 
 //-----------------------------------------------------------------------------
 static inline void DAP_CONFIG_SWCLK_TCK_clr(void) {
-    LL_GPIO_ResetOutputPin(flipper_dap_swclk_pin.port, flipper_dap_swclk_pin.pin);
+    flipper_dap_gpio.swclk_port->BRR = flipper_dap_gpio.swclk_mask;
 }
 
 //-----------------------------------------------------------------------------
 static inline void DAP_CONFIG_SWDIO_TMS_in(void) {
-    LL_GPIO_SetPinMode(flipper_dap_swdio_pin.port, flipper_dap_swdio_pin.pin, LL_GPIO_MODE_INPUT);
+    flipper_dap_gpio.swdio_port->MODER &= ~flipper_dap_gpio.swdio_moder_mask;
 }
 
 //-----------------------------------------------------------------------------
 static inline void DAP_CONFIG_SWDIO_TMS_out(void) {
-    LL_GPIO_SetPinMode(flipper_dap_swdio_pin.port, flipper_dap_swdio_pin.pin, LL_GPIO_MODE_OUTPUT);
+    flipper_dap_gpio.swdio_port->MODER =
+        (flipper_dap_gpio.swdio_port->MODER & ~flipper_dap_gpio.swdio_moder_mask) |
+        flipper_dap_gpio.swdio_moder_output;
 }
 
 //-----------------------------------------------------------------------------
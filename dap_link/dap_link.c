@@ -6,8 +6,10 @@
 #include <furi_hal_serial.h>
 #include <furi_hal_resources.h>
 #include <furi_hal_power.h>
+#include <furi_hal_interrupt.h>
 #include <stm32wbxx_ll_usart.h>
 #include <stm32wbxx_ll_lpuart.h>
+#include <stm32wbxx_ll_dma.h>
 
 #include <expansion/expansion.h>
 
@@ -15,6 +17,7 @@
 #include "dap_config.h"
 #include "gui/dap_gui.h"
 #include "usb/dap_v2_usb.h"
+#include "swo/dap_swo.h"
 #include <dialogs/dialogs.h>
 #include "dap_link_icons.h"
 
@@ -50,6 +53,7 @@ GpioPin flipper_dap_swdio_pin;
 GpioPin flipper_dap_reset_pin;
 GpioPin flipper_dap_tdo_pin;
 GpioPin flipper_dap_tdi_pin;
+DapGpio flipper_dap_gpio;
 
 /***************************************************************************/
 /****************************** DAP PROCESS ********************************/
@@ -58,8 +62,178 @@ GpioPin flipper_dap_tdi_pin;
 typedef struct {
     uint8_t data[DAP_CONFIG_PACKET_SIZE];
     uint8_t size;
+    uint32_t timestamp; // DAP_CONFIG_PROFILE_COUNTER() when the request was received
 } DapPacket;
 
+// Single producer, single consumer ring, head and tail only ever grow
+typedef struct {
+    DapPacket packets[DAP_CONFIG_PACKET_COUNT];
+    volatile uint32_t head;
+    volatile uint32_t tail;
+} DapPacketRing;
+
+// Requests are read from the OUT endpoint in the USB interrupt, so the host can send up to
+// DAP_CONFIG_PACKET_COUNT of them without waiting for a response. Responses wait in their
+// own ring until the IN endpoint is free. DAP_TransferAbort is handled in the interrupt and
+// never queued; the request being processed still holds its slot, so one more packet is
+// read into spare when the ring is full, otherwise an abort behind a full ring would wait
+// in the endpoint until the transfer it should abort is done.
+typedef struct {
+    DapPacketRing requests;
+    DapPacketRing responses;
+    DapPacket spare;
+    volatile bool spare_valid; // spare holds a request that goes to the ring next
+    volatile bool rx_pending; // request left in the endpoint because the ring was full
+    size_t (*rx)(uint8_t* buffer, size_t size);
+    int32_t (*tx)(uint8_t* buffer, uint8_t size);
+    bool (*tx_ready)();
+    bool fixed_size; // HID reports are always DAP_CONFIG_PACKET_SIZE long
+} DapQueue;
+
+static DapQueue dap_queue_v1 = {
+    .rx = dap_v1_usb_rx,
+    .tx = dap_v1_usb_tx,
+    .tx_ready = dap_v1_usb_tx_ready,
+    .fixed_size = true,
+};
+
+static DapQueue dap_queue_v2 = {
+    .rx = dap_v2_usb_rx,
+    .tx = dap_v2_usb_tx,
+    .tx_ready = dap_v2_usb_tx_ready,
+    .fixed_size = false,
+};
+
+// From a request arriving in the USB interrupt to its response being written to the IN endpoint
+static dap_profile_t dap_usb_latency;
+// The part of it the request spent in the ring before it was processed
+static dap_profile_t dap_usb_queued;
+
+static void dap_usb_profile_add(dap_profile_t* profile, uint32_t time) {
+    profile->count++;
+    profile->total += time;
+    if(time > profile->max) profile->max = time;
+}
+
+static void dap_usb_profile_reset() {
+    dap_profile_reset();
+    memset(&dap_usb_latency, 0, sizeof(dap_usb_latency));
+    memset(&dap_usb_queued, 0, sizeof(dap_usb_queued));
+}
+
+static inline uint32_t dap_packet_ring_count(DapPacketRing* ring) {
+    return ring->head - ring->tail;
+}
+
+static inline DapPacket* dap_packet_ring_head(DapPacketRing* ring) {
+    return &ring->packets[ring->head % DAP_CONFIG_PACKET_COUNT];
+}
+
+static inline DapPacket* dap_packet_ring_tail(DapPacketRing* ring) {
+    return &ring->packets[ring->tail % DAP_CONFIG_PACKET_COUNT];
+}
+
+static void dap_queue_reset(DapQueue* queue) {
+    FURI_CRITICAL_ENTER();
+    queue->requests.head = queue->requests.tail = 0;
+    queue->responses.head = queue->responses.tail = 0;
+    queue->spare_valid = false;
+    queue->rx_pending = false;
+    FURI_CRITICAL_EXIT();
+}
+
+// Called from the USB interrupt
+static void dap_queue_receive(DapQueue* queue) {
+    DapPacket* packet;
+    if(dap_packet_ring_count(&queue->requests) < DAP_CONFIG_PACKET_COUNT) {
+        packet = dap_packet_ring_head(&queue->requests);
+    } else if(!queue->spare_valid) {
+        packet = &queue->spare;
+    } else {
+        // Leave it in the endpoint, it NAKs the host until the thread frees a slot
+        queue->rx_pending = true;
+        return;
+    }
+    packet->timestamp = DAP_CONFIG_PROFILE_COUNTER();
+    packet->size = queue->rx(packet->data, DAP_CONFIG_PACKET_SIZE);
+    // Sets the abort flag of the transfer in progress, the packet itself is dropped
+    if(packet->size > 0 && !dap_filter_request(packet->data)) {
+        return;
+    }
+    if(packet == &queue->spare) {
+        queue->spare_valid = true;
+    } else {
+        queue->requests.head++;
+    }
+}
+
+static void dap_queue_release_request(DapQueue* queue) {
+    FURI_CRITICAL_ENTER();
+    queue->requests.tail++;
+    if(queue->spare_valid) {
+        *dap_packet_ring_head(&queue->requests) = queue->spare;
+        queue->requests.head++;
+        queue->spare_valid = false;
+    }
+    if(queue->rx_pending) {
+        queue->rx_pending = false;
+        dap_queue_receive(queue);
+    }
+    FURI_CRITICAL_EXIT();
+}
+
+// DAP_QueueCommands packets wait for the packet that ends the batch, unless the ring is full
+static bool dap_queue_request_ready(DapQueue* queue) {
+    uint32_t count = dap_packet_ring_count(&queue->requests);
+    if(count == DAP_CONFIG_PACKET_COUNT) return true;
+
+    for(uint32_t i = 0; i < count; i++) {
+        DapPacket* packet =
+            &queue->requests.packets[(queue->requests.tail + i) % DAP_CONFIG_PACKET_COUNT];
+        if(!dap_is_queue_request(packet->data)) return true;
+    }
+    return false;
+}
+
+// Runs queued requests and sends their responses, returns the number of requests processed
+static uint32_t dap_queue_process(DapQueue* queue) {
+    uint32_t processed = 0;
+    bool progress;
+    do {
+        progress = false;
+
+        // Send first, so the host gets the oldest response as early as possible
+        if(dap_packet_ring_count(&queue->responses) > 0 && queue->tx_ready()) {
+            DapPacket* response = dap_packet_ring_tail(&queue->responses);
+            queue->tx(response->data, response->size);
+            dap_usb_profile_add(
+                &dap_usb_latency, DAP_CONFIG_PROFILE_COUNTER() - response->timestamp);
+            queue->responses.tail++;
+            progress = true;
+        }
+
+        if(dap_packet_ring_count(&queue->requests) > 0 &&
+           dap_packet_ring_count(&queue->responses) < DAP_CONFIG_PACKET_COUNT &&
+           dap_queue_request_ready(queue)) {
+            DapPacket* request = dap_packet_ring_tail(&queue->requests);
+            DapPacket* response = dap_packet_ring_head(&queue->responses);
+            dap_usb_profile_add(
+                &dap_usb_queued, DAP_CONFIG_PROFILE_COUNTER() - request->timestamp);
+            response->timestamp = request->timestamp;
+            memset(response->data, 0, DAP_CONFIG_PACKET_SIZE);
+            size_t len = dap_process_request(
+                request->data, request->size, response->data, DAP_CONFIG_PACKET_SIZE);
+            response->size = queue->fixed_size ? DAP_CONFIG_PACKET_SIZE : len;
+            queue->responses.head++;
+            dap_queue_release_request(queue);
+            processed++;
+            progress = true;
+        }
+    } while(progress);
+
+    return processed;
+}
+
 typedef enum {
     DapThreadEventStop = DapEventStop,
     DapThreadEventRxV1 = (1 << 1),
@@ -67,9 +241,14 @@ typedef enum {
     DapThreadEventUsbConnect = (1 << 3),
     DapThreadEventUsbDisconnect = (1 << 4),
     DapThreadEventApplyConfig = (1 << 5),
+    DapThreadEventTxV1 = (1 << 6),
+    DapThreadEventTxV2 = (1 << 7),
+    DapThreadEventSwo = (1 << 8),
+    DapThreadEventProfileReset = (1 << 9),
     DapThreadEventAll = DapThreadEventStop | DapThreadEventRxV1 | DapThreadEventRxV2 |
                         DapThreadEventUsbConnect | DapThreadEventUsbDisconnect |
-                        DapThreadEventApplyConfig,
+                        DapThreadEventApplyConfig | DapThreadEventTxV1 | DapThreadEventTxV2 |
+                        DapThreadEventSwo | DapThreadEventProfileReset,
 } DapThreadEvent;
 
 #define USB_SERIAL_NUMBER_LEN 16
@@ -83,15 +262,36 @@ const char* dap_app_get_serial(DapApp* app) {
 static void dap_app_rx1_callback(void* context) {
     furi_assert(context);
     FuriThreadId thread_id = (FuriThreadId)context;
+    dap_queue_receive(&dap_queue_v1);
     furi_thread_flags_set(thread_id, DapThreadEventRxV1);
 }
 
 static void dap_app_rx2_callback(void* context) {
     furi_assert(context);
     FuriThreadId thread_id = (FuriThreadId)context;
+    dap_queue_receive(&dap_queue_v2);
     furi_thread_flags_set(thread_id, DapThreadEventRxV2);
 }
 
+static void dap_app_tx1_callback(void* context) {
+    furi_assert(context);
+    FuriThreadId thread_id = (FuriThreadId)context;
+    furi_thread_flags_set(thread_id, DapThreadEventTxV1);
+}
+
+static void dap_app_tx2_callback(void* context) {
+    furi_assert(context);
+    FuriThreadId thread_id = (FuriThreadId)context;
+    furi_thread_flags_set(thread_id, DapThreadEventTxV2);
+}
+
+// SWO data arrived or the SWO endpoint is free again
+static void dap_app_swo_callback(void* context) {
+    furi_assert(context);
+    FuriThreadId thread_id = (FuriThreadId)context;
+    furi_thread_flags_set(thread_id, DapThreadEventSwo);
+}
+
 static void dap_app_usb_state_callback(bool state, void* context) {
     furi_assert(context);
     FuriThreadId thread_id = (FuriThreadId)context;
@@ -102,23 +302,61 @@ static void dap_app_usb_state_callback(bool state, void* context) {
     }
 }
 
-static void dap_app_process_v1() {
-    DapPacket tx_packet;
-    DapPacket rx_packet;
-    memset(&tx_packet, 0, sizeof(DapPacket));
-    rx_packet.size = dap_v1_usb_rx(rx_packet.data, DAP_CONFIG_PACKET_SIZE);
-    dap_process_request(rx_packet.data, rx_packet.size, tx_packet.data, DAP_CONFIG_PACKET_SIZE);
-    dap_v1_usb_tx(tx_packet.data, DAP_CONFIG_PACKET_SIZE);
+static void dap_app_swo_stream() {
+    uint8_t data[DAP_CONFIG_PACKET_SIZE];
+
+    while(dap_swo_is_streaming() && dap_swo_usb_tx_ready()) {
+        uint32_t len = dap_swo_read(data, DAP_CONFIG_PACKET_SIZE);
+        if(len == 0) break;
+        dap_swo_usb_tx(data, len);
+    }
 }
 
-static void dap_app_process_v2() {
-    DapPacket tx_packet;
-    DapPacket rx_packet;
-    memset(&tx_packet, 0, sizeof(DapPacket));
-    rx_packet.size = dap_v2_usb_rx(rx_packet.data, DAP_CONFIG_PACKET_SIZE);
-    size_t len = dap_process_request(
-        rx_packet.data, rx_packet.size, tx_packet.data, DAP_CONFIG_PACKET_SIZE);
-    dap_v2_usb_tx(tx_packet.data, len);
+#define DAP_VENDOR_OK 0x00
+#define DAP_VENDOR_ERROR 0xff
+
+#define DAP_VENDOR_PROFILE_LATENCY 0x80
+#define DAP_VENDOR_PROFILE_QUEUED 0x81
+#define DAP_VENDOR_PROFILE_RESET 0xff
+
+// Request: 0x82, index. Index 0x00-0x1f is a command, 0x80 the USB latency, 0x81 the time
+// in the queue, 0xff resets everything.
+// Response: 0x82, status, count, total (64 bit), max, wait, fault, counter ticks per second,
+// all little endian words.
+static void dap_app_vendor_profile() {
+    uint8_t index = dap_req_get_byte();
+    const dap_profile_t* profile = NULL;
+
+    if(dap_is_buf_error()) {
+        dap_resp_add_byte(DAP_VENDOR_ERROR);
+        return;
+    }
+
+    if(index < DAP_PROFILE_SIZE) {
+        profile = dap_profile_get(index);
+    } else if(index == DAP_VENDOR_PROFILE_LATENCY) {
+        profile = &dap_usb_latency;
+    } else if(index == DAP_VENDOR_PROFILE_QUEUED) {
+        profile = &dap_usb_queued;
+    } else if(index == DAP_VENDOR_PROFILE_RESET) {
+        dap_usb_profile_reset();
+        dap_resp_add_byte(DAP_VENDOR_OK);
+        return;
+    }
+
+    if(!profile) {
+        dap_resp_add_byte(DAP_VENDOR_ERROR);
+        return;
+    }
+
+    dap_resp_add_byte(DAP_VENDOR_OK);
+    dap_resp_add_word(profile->count);
+    dap_resp_add_word(profile->total);
+    dap_resp_add_word(profile->total >> 32);
+    dap_resp_add_word(profile->max);
+    dap_resp_add_word(profile->wait);
+    dap_resp_add_word(profile->fault);
+    dap_resp_add_word(DAP_CONFIG_CPU_FREQ);
 }
 
 void dap_app_vendor_cmd(uint8_t cmd) {
@@ -126,6 +364,11 @@ void dap_app_vendor_cmd(uint8_t cmd) {
     if(cmd == 0x01) {
         furi_hal_power_reset();
     }
+
+    // openocd -c "cmsis-dap cmd 82 05"
+    if(cmd == 0x02) {
+        dap_app_vendor_profile();
+    }
 }
 
 void dap_app_target_reset() {
@@ -147,6 +390,20 @@ static void dap_init_gpio(DapSwdPins swd_pins) {
     flipper_dap_reset_pin = gpio_ext_pa4;
     flipper_dap_tdo_pin = gpio_ext_pb3;
     flipper_dap_tdi_pin = gpio_ext_pb2;
+
+    uint32_t swdio_position = __builtin_ctz(flipper_dap_swdio_pin.pin) * 2;
+    flipper_dap_gpio = (DapGpio){
+        .swclk_port = flipper_dap_swclk_pin.port,
+        .swclk_mask = flipper_dap_swclk_pin.pin,
+        .swdio_port = flipper_dap_swdio_pin.port,
+        .swdio_mask = flipper_dap_swdio_pin.pin,
+        .swdio_moder_mask = GPIO_MODER_MODE0 << swdio_position,
+        .swdio_moder_output = LL_GPIO_MODE_OUTPUT << swdio_position,
+        .tdi_port = flipper_dap_tdi_pin.port,
+        .tdi_mask = flipper_dap_tdi_pin.pin,
+        .tdo_port = flipper_dap_tdo_pin.port,
+        .tdo_mask = flipper_dap_tdo_pin.pin,
+    };
 }
 
 static void dap_deinit_gpio(DapSwdPins swd_pins) {
@@ -203,6 +460,10 @@ static int32_t dap_process(void* p) {
     dap_common_usb_set_context(furi_thread_get_id(furi_thread_get_current()));
     dap_v1_usb_set_rx_callback(dap_app_rx1_callback);
     dap_v2_usb_set_rx_callback(dap_app_rx2_callback);
+    dap_v1_usb_set_tx_complete_callback(dap_app_tx1_callback);
+    dap_v2_usb_set_tx_complete_callback(dap_app_tx2_callback);
+    dap_swo_usb_set_tx_complete_callback(dap_app_swo_callback);
+    dap_swo_set_callback(dap_app_swo_callback, furi_thread_get_id(furi_thread_get_current()));
     dap_common_usb_set_state_callback(dap_app_usb_state_callback);
     furi_hal_usb_set_config(&dap_v2_usb_hid, NULL);
 
@@ -212,23 +473,39 @@ static int32_t dap_process(void* p) {
         events = furi_thread_flags_wait(DapThreadEventAll, FuriFlagWaitAny, FuriWaitForever);
 
         if(!(events & FuriFlagError)) {
-            if(events & DapThreadEventRxV1) {
-                dap_app_process_v1();
-                dap_state->dap_counter++;
-                dap_state->dap_version = DapVersionV1;
+            if(events & (DapThreadEventRxV1 | DapThreadEventTxV1)) {
+                uint32_t processed = dap_queue_process(&dap_queue_v1);
+                if(processed) {
+                    dap_state->dap_counter += processed;
+                    dap_state->dap_version = DapVersionV1;
+                }
             }
 
-            if(events & DapThreadEventRxV2) {
-                dap_app_process_v2();
-                dap_state->dap_counter++;
-                dap_state->dap_version = DapVersionV2;
+            if(events & (DapThreadEventRxV2 | DapThreadEventTxV2)) {
+                uint32_t processed = dap_queue_process(&dap_queue_v2);
+                if(processed) {
+                    dap_state->dap_counter += processed;
+                    dap_state->dap_version = DapVersionV2;
+                }
+            }
+
+            if(events & DapThreadEventSwo) {
+                dap_app_swo_stream();
+            }
+
+            if(events & DapThreadEventProfileReset) {
+                dap_usb_profile_reset();
             }
 
             if(events & DapThreadEventUsbConnect) {
+                dap_queue_reset(&dap_queue_v1);
+                dap_queue_reset(&dap_queue_v2);
                 dap_state->usb_connected = true;
             }
 
             if(events & DapThreadEventUsbDisconnect) {
+                dap_queue_reset(&dap_queue_v1);
+                dap_queue_reset(&dap_queue_v2);
                 dap_state->usb_connected = false;
                 dap_state->dap_version = DapVersionUnknown;
             }
@@ -247,6 +524,9 @@ static int32_t dap_process(void* p) {
         }
     }
 
+    dap_swo_stop();
+    dap_swo_set_callback(NULL, NULL);
+
     // deinit usb
     furi_hal_usb_set_config(usb_config_prev, NULL);
     dap_common_usb_free_name();
@@ -258,6 +538,14 @@ static int32_t dap_process(void* p) {
 /****************************** CDC PROCESS ********************************/
 /***************************************************************************/
 
+// UART bytes wait here for the USB IN endpoint, 8 KiB is ~90 ms at 921600 baud
+#define CDC_UART_RX_BUFFER_SIZE (8 * 1024)
+#define CDC_USB_PACKET_SIZE 64
+
+// USB OUT packets go to the UART through DMA2 channel 1, RX is on the furi_hal_serial DMA
+#define CDC_UART_TX_DMA DMA2
+#define CDC_UART_TX_DMA_CHANNEL LL_DMA_CHANNEL_1
+
 typedef enum {
     CdcThreadEventStop = DapEventStop,
     CdcThreadEventUartRx = (1 << 1),
@@ -267,11 +555,14 @@ typedef enum {
     CdcThreadEventCdcDtrHigh = (1 << 5),
     CdcThreadEventCdcDtrLow = (1 << 6),
     CdcThreadEventCdcTxComplete = (1 << 7),
+    CdcThreadEventUartRxIdle = (1 << 8),
+    CdcThreadEventUartTxComplete = (1 << 9),
 
     CdcThreadEventAll = CdcThreadEventStop | CdcThreadEventUartRx | CdcThreadEventCdcRx |
                         CdcThreadEventCdcConfig | CdcThreadEventApplyConfig |
                         CdcThreadEventCdcDtrHigh | CdcThreadEventCdcDtrLow |
-                        CdcThreadEventCdcTxComplete,
+                        CdcThreadEventCdcTxComplete | CdcThreadEventUartRxIdle |
+                        CdcThreadEventUartTxComplete,
 } CdcThreadEvent;
 
 typedef struct {
@@ -279,18 +570,105 @@ typedef struct {
     FuriThreadId thread_id;
     FuriHalSerialHandle* serial_handle;
     struct usb_cdc_line_coding line_coding;
+    volatile uint32_t rx_dropped; // bytes that did not fit in rx_stream
+    volatile uint32_t rx_overrun; // UART overrun errors
+    bool usb_flush; // the UART line went idle, send what is left in rx_stream
+    bool usb_zlp; // the last IN packet was full and has to be followed by a short one
 } CDCProcess;
 
-static void cdc_uart_irq_cb(FuriHalSerialHandle* handle, FuriHalSerialRxEvent event, void* ctx) {
+static void cdc_uart_irq_cb(
+    FuriHalSerialHandle* handle,
+    FuriHalSerialRxEvent event,
+    size_t size,
+    void* ctx) {
+    CDCProcess* app = ctx;
+
+    if(event & (FuriHalSerialRxEventData | FuriHalSerialRxEventIdle)) {
+        uint8_t data[FURI_HAL_SERIAL_DMA_BUFFER_SIZE];
+        while(size) {
+            size_t len = furi_hal_serial_dma_rx(
+                handle,
+                data,
+                (size > FURI_HAL_SERIAL_DMA_BUFFER_SIZE) ? FURI_HAL_SERIAL_DMA_BUFFER_SIZE : size);
+            app->rx_dropped += len - furi_stream_buffer_send(app->rx_stream, data, len, 0);
+            size -= len;
+        }
+
+        // The line went quiet, the thread can send a short packet instead of waiting for 64 bytes
+        furi_thread_flags_set(
+            app->thread_id,
+            (event & FuriHalSerialRxEventIdle) ? CdcThreadEventUartRxIdle : CdcThreadEventUartRx);
+    }
+
+    if(event & FuriHalSerialRxEventOverrunError) {
+        app->rx_overrun++;
+    }
+}
+
+static void cdc_uart_tx_dma_isr(void* ctx) {
     CDCProcess* app = ctx;
 
-    if(event == FuriHalSerialRxEventData) {
-        uint8_t data = furi_hal_serial_async_rx(handle);
-        furi_stream_buffer_send(app->rx_stream, &data, 1, 0);
-        furi_thread_flags_set(app->thread_id, CdcThreadEventUartRx);
+    if(LL_DMA_IsActiveFlag_TC1(CDC_UART_TX_DMA) || LL_DMA_IsActiveFlag_TE1(CDC_UART_TX_DMA)) {
+        LL_DMA_ClearFlag_GI1(CDC_UART_TX_DMA);
+        LL_DMA_DisableChannel(CDC_UART_TX_DMA, CDC_UART_TX_DMA_CHANNEL);
+        furi_thread_flags_set(app->thread_id, CdcThreadEventUartTxComplete);
+    }
+}
+
+static void cdc_uart_tx_dma_init(CDCProcess* app, DapUartType type) {
+    uint32_t tdr;
+    uint32_t request;
+
+    if(type == DapUartTypeUSART1) {
+        tdr = (uint32_t) & (USART1->TDR);
+        request = LL_DMAMUX_REQ_USART1_TX;
+    } else {
+        tdr = (uint32_t) & (LPUART1->TDR);
+        request = LL_DMAMUX_REQ_LPUART1_TX;
+    }
+
+    LL_DMA_SetPeriphAddress(CDC_UART_TX_DMA, CDC_UART_TX_DMA_CHANNEL, tdr);
+    LL_DMA_ConfigTransfer(
+        CDC_UART_TX_DMA,
+        CDC_UART_TX_DMA_CHANNEL,
+        LL_DMA_DIRECTION_MEMORY_TO_PERIPH | LL_DMA_MODE_NORMAL | LL_DMA_PERIPH_NOINCREMENT |
+            LL_DMA_MEMORY_INCREMENT | LL_DMA_PDATAALIGN_BYTE | LL_DMA_MDATAALIGN_BYTE |
+            LL_DMA_PRIORITY_HIGH);
+    LL_DMA_SetPeriphRequest(CDC_UART_TX_DMA, CDC_UART_TX_DMA_CHANNEL, request);
+    LL_DMA_ClearFlag_GI1(CDC_UART_TX_DMA);
+
+    furi_hal_interrupt_set_isr(FuriHalInterruptIdDma2Ch1, cdc_uart_tx_dma_isr, app);
+    LL_DMA_EnableIT_TC(CDC_UART_TX_DMA, CDC_UART_TX_DMA_CHANNEL);
+    LL_DMA_EnableIT_TE(CDC_UART_TX_DMA, CDC_UART_TX_DMA_CHANNEL);
+
+    if(type == DapUartTypeUSART1) {
+        LL_USART_EnableDMAReq_TX(USART1);
+    } else {
+        LL_LPUART_EnableDMAReq_TX(LPUART1);
     }
 }
 
+static void cdc_uart_tx_dma_deinit(DapUartType type) {
+    // A transfer still running is cut short, the UART is about to go away anyway
+    LL_DMA_DisableChannel(CDC_UART_TX_DMA, CDC_UART_TX_DMA_CHANNEL);
+    LL_DMA_DisableIT_TC(CDC_UART_TX_DMA, CDC_UART_TX_DMA_CHANNEL);
+    LL_DMA_DisableIT_TE(CDC_UART_TX_DMA, CDC_UART_TX_DMA_CHANNEL);
+    LL_DMA_ClearFlag_GI1(CDC_UART_TX_DMA);
+    furi_hal_interrupt_set_isr(FuriHalInterruptIdDma2Ch1, NULL, NULL);
+
+    if(type == DapUartTypeUSART1) {
+        LL_USART_DisableDMAReq_TX(USART1);
+    } else {
+        LL_LPUART_DisableDMAReq_TX(LPUART1);
+    }
+}
+
+static void cdc_uart_tx_dma(uint8_t* data, size_t size) {
+    LL_DMA_SetMemoryAddress(CDC_UART_TX_DMA, CDC_UART_TX_DMA_CHANNEL, (uint32_t)data);
+    LL_DMA_SetDataLength(CDC_UART_TX_DMA, CDC_UART_TX_DMA_CHANNEL, size);
+    LL_DMA_EnableChannel(CDC_UART_TX_DMA, CDC_UART_TX_DMA_CHANNEL);
+}
+
 static void cdc_usb_rx_callback(void* context) {
     CDCProcess* app = context;
     furi_thread_flags_set(app->thread_id, CdcThreadEventCdcRx);
@@ -324,7 +702,7 @@ static void cdc_init_uart(
     DapUartType type,
     DapUartTXRX swap,
     uint32_t baudrate,
-    void (*cb)(FuriHalSerialHandle* handle, FuriHalSerialRxEvent event, void* ctx),
+    void (*cb)(FuriHalSerialHandle* handle, FuriHalSerialRxEvent event, size_t size, void* ctx),
     void* ctx) {
     if(baudrate == 0) baudrate = 115200;
 
@@ -338,7 +716,7 @@ static void cdc_init_uart(
             LL_USART_SetTXRXSwap(USART1, LL_USART_TXRX_STANDARD);
         }
         furi_hal_serial_init(app->serial_handle, baudrate);
-        furi_hal_serial_async_rx_start(app->serial_handle, cb, ctx, false);
+        furi_hal_serial_dma_rx_start(app->serial_handle, cb, ctx, true);
         break;
     case DapUartTypeLPUART1:
         app->serial_handle = furi_hal_serial_control_acquire(FuriHalSerialIdLpuart);
@@ -349,12 +727,16 @@ static void cdc_init_uart(
             LL_LPUART_SetTXRXSwap(LPUART1, LL_LPUART_TXRX_STANDARD);
         }
         furi_hal_serial_init(app->serial_handle, baudrate);
-        furi_hal_serial_async_rx_start(app->serial_handle, cb, ctx, false);
+        furi_hal_serial_dma_rx_start(app->serial_handle, cb, ctx, true);
         break;
     }
+
+    cdc_uart_tx_dma_init(app, type);
 }
 
 static void cdc_deinit_uart(CDCProcess* app, DapUartType type) {
+    cdc_uart_tx_dma_deinit(type);
+
     switch(type) {
     case DapUartTypeUSART1:
         furi_hal_serial_deinit(app->serial_handle);
@@ -369,6 +751,26 @@ static void cdc_deinit_uart(CDCProcess* app, DapUartType type) {
     }
 }
 
+// Sends the next packet from rx_stream if the IN endpoint is free. Packets are kept
+// full while the UART is receiving, the rest goes out once the line is idle.
+static void cdc_usb_tx_next(CDCProcess* app, DapState* dap_state, uint8_t* buffer) {
+    if(!dap_cdc_usb_tx_ready()) return;
+
+    size_t available = furi_stream_buffer_bytes_available(app->rx_stream);
+    if(available >= CDC_USB_PACKET_SIZE || (app->usb_flush && available > 0)) {
+        size_t len = furi_stream_buffer_receive(app->rx_stream, buffer, CDC_USB_PACKET_SIZE, 0);
+        dap_cdc_usb_tx(buffer, len);
+        dap_state->cdc_rx_counter += len;
+        app->usb_zlp = (len == CDC_USB_PACKET_SIZE);
+    } else if(app->usb_flush) {
+        if(app->usb_zlp) {
+            dap_cdc_usb_tx(buffer, 0);
+            app->usb_zlp = false;
+        }
+        app->usb_flush = false;
+    }
+}
+
 static int32_t dap_cdc_process(void* p) {
     DapApp* dap_app = p;
     DapState* dap_state = &(dap_app->state);
@@ -381,10 +783,15 @@ static int32_t dap_cdc_process(void* p) {
 
     CDCProcess* app = malloc(sizeof(CDCProcess));
     app->thread_id = furi_thread_get_id(furi_thread_get_current());
-    app->rx_stream = furi_stream_buffer_alloc(512, 1);
+    app->rx_stream = furi_stream_buffer_alloc(CDC_UART_RX_BUFFER_SIZE, 1);
+    app->rx_dropped = 0;
+    app->rx_overrun = 0;
+    app->usb_flush = false;
+    app->usb_zlp = false;
 
-    const uint8_t rx_buffer_size = 64;
-    uint8_t* rx_buffer = malloc(rx_buffer_size);
+    uint8_t* rx_buffer = malloc(CDC_USB_PACKET_SIZE);
+    // Read by the TX DMA until CdcThreadEventUartTxComplete
+    uint8_t* tx_buffer = malloc(CDC_USB_PACKET_SIZE);
 
     cdc_init_uart(
         app, uart_pins_prev, uart_swap_prev, dap_state->cdc_baudrate, cdc_uart_irq_cb, app);
@@ -396,6 +803,11 @@ static int32_t dap_cdc_process(void* p) {
     dap_cdc_usb_set_config_callback(cdc_usb_config_callback);
 
     bool cdc_connect = false;
+    // A USB OUT packet waits in the endpoint while the previous one is being sent, the host
+    // is NAKed meanwhile
+    bool usb_rx_pending = false;
+    bool uart_tx_busy = false;
+    bool baudrate_pending = false;
 
     uint32_t events;
     while(1) {
@@ -405,35 +817,19 @@ static int32_t dap_cdc_process(void* p) {
             if(events & CdcThreadEventCdcConfig) {
                 if(dap_state->cdc_baudrate != app->line_coding.dwDTERate) {
                     dap_state->cdc_baudrate = app->line_coding.dwDTERate;
-                    if(dap_state->cdc_baudrate > 0) {
-                        furi_hal_serial_set_br(app->serial_handle, dap_state->cdc_baudrate);
-                    }
+                    baudrate_pending = dap_state->cdc_baudrate > 0;
                 }
             }
 
-            if(events & (CdcThreadEventUartRx | CdcThreadEventCdcTxComplete)) {
-                size_t len =
-                    furi_stream_buffer_receive(app->rx_stream, rx_buffer, rx_buffer_size, 0);
-                if(cdc_connect) {
-                    if(len > 0) {
-                        dap_cdc_usb_tx(rx_buffer, len);
-                    }
-                    dap_state->cdc_rx_counter += len;
-                }
-            }
-
-            if(events & CdcThreadEventCdcRx) {
-                size_t len = dap_cdc_usb_rx(rx_buffer, rx_buffer_size);
-                if(len > 0) {
-                    furi_hal_serial_tx(app->serial_handle, rx_buffer, len);
-                }
-                dap_state->cdc_tx_counter += len;
+            if(events & CdcThreadEventUartTxComplete) {
+                uart_tx_busy = false;
             }
 
             if(events & CdcThreadEventApplyConfig) {
                 if(uart_pins_prev != dap_app->config.uart_pins ||
                    uart_swap_prev != dap_app->config.uart_swap) {
                     cdc_deinit_uart(app, uart_pins_prev);
+                    uart_tx_busy = false;
                     uart_pins_prev = dap_app->config.uart_pins;
                     uart_swap_prev = dap_app->config.uart_swap;
                     cdc_init_uart(
@@ -443,9 +839,53 @@ static int32_t dap_cdc_process(void* p) {
                         dap_state->cdc_baudrate,
                         cdc_uart_irq_cb,
                         app);
+                    baudrate_pending = false;
+                }
+            }
+
+            // Changing the baudrate in the middle of a transfer would garble it
+            if(baudrate_pending && !uart_tx_busy) {
+                furi_hal_serial_set_br(app->serial_handle, dap_state->cdc_baudrate);
+                baudrate_pending = false;
+            }
+
+            if(events & CdcThreadEventUartRxIdle) {
+                app->usb_flush = true;
+            }
+
+            if(events & (CdcThreadEventUartRx | CdcThreadEventUartRxIdle |
+                         CdcThreadEventCdcTxComplete)) {
+                if(cdc_connect) {
+                    cdc_usb_tx_next(app, dap_state, rx_buffer);
+                } else {
+                    // Nobody has the port open, drop what came in
+                    size_t len;
+                    do {
+                        len = furi_stream_buffer_receive(
+                            app->rx_stream, rx_buffer, CDC_USB_PACKET_SIZE, 0);
+                    } while(len > 0);
+                    app->usb_flush = false;
+                    app->usb_zlp = false;
                 }
             }
 
+            if(events & CdcThreadEventCdcRx) {
+                usb_rx_pending = true;
+            }
+
+            if(usb_rx_pending && !uart_tx_busy && !baudrate_pending) {
+                size_t len = dap_cdc_usb_rx(tx_buffer, CDC_USB_PACKET_SIZE);
+                if(len > 0 && len <= CDC_USB_PACKET_SIZE) {
+                    cdc_uart_tx_dma(tx_buffer, len);
+                    uart_tx_busy = true;
+                    dap_state->cdc_tx_counter += len;
+                }
+                usb_rx_pending = false;
+            }
+
+            dap_state->cdc_rx_dropped = app->rx_dropped;
+            dap_state->cdc_rx_overrun = app->rx_overrun;
+
             if(events & CdcThreadEventStop) {
                 break;
             }
@@ -459,6 +899,7 @@ static int32_t dap_cdc_process(void* p) {
     }
 
     cdc_deinit_uart(app, uart_pins_prev);
+    free(tx_buffer);
     free(rx_buffer);
     furi_stream_buffer_free(app->rx_stream);
     free(app);
@@ -510,6 +951,26 @@ DapConfig* dap_app_get_config(DapApp* app) {
     return &app->config;
 }
 
+void dap_app_get_profile(DapApp* app, DapProfile* profile) {
+    UNUSED(app);
+    for(int i = 0; i < DAP_PROFILE_SIZE; i++) {
+        // NULL without DAP_CONFIG_ENABLE_PROFILE, the view skips empty rows
+        const dap_profile_t* command = dap_profile_get(i);
+        if(command) {
+            profile->commands[i] = *command;
+        } else {
+            memset(&profile->commands[i], 0, sizeof(dap_profile_t));
+        }
+    }
+    profile->latency = dap_usb_latency;
+    profile->queued = dap_usb_queued;
+    profile->cycles_per_us = furi_hal_cortex_instructions_per_microsecond();
+}
+
+void dap_app_reset_profile(DapApp* app) {
+    furi_thread_flags_set(furi_thread_get_id(app->dap_thread), DapThreadEventProfileReset);
+}
+
 int32_t dap_link_app(void* p) {
     UNUSED(p);
     // Disable expansion protocol to avoid interference with UART Handle
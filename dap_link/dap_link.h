@@ -1,5 +1,6 @@
 #pragma once
 #include <stdint.h>
+#include <dap.h>
 
 typedef enum {
     DapModeDisconnected,
@@ -21,6 +22,8 @@ typedef struct {
     uint32_t cdc_baudrate;
     uint32_t cdc_tx_counter;
     uint32_t cdc_rx_counter;
+    uint32_t cdc_rx_dropped; // UART bytes lost because the USB side didn't keep up
+    uint32_t cdc_rx_overrun; // UART overrun errors
 } DapState;
 
 typedef enum {
@@ -44,6 +47,13 @@ typedef struct {
     DapUartTXRX uart_swap;
 } DapConfig;
 
+typedef struct {
+    dap_profile_t commands[DAP_PROFILE_SIZE];
+    dap_profile_t latency; // request received to response written to the IN endpoint
+    dap_profile_t queued; // request received to its processing started, part of latency
+    uint32_t cycles_per_us;
+} DapProfile;
+
 typedef struct DapApp DapApp;
 
 void dap_app_get_state(DapApp* app, DapState* state);
@@ -52,4 +62,8 @@ const char* dap_app_get_serial(DapApp* app);
 
 void dap_app_set_config(DapApp* app, DapConfig* config);
 
-DapConfig* dap_app_get_config(DapApp* app);
\ No newline at end of file
+DapConfig* dap_app_get_config(DapApp* app);
+
+void dap_app_get_profile(DapApp* app, DapProfile* profile);
+
+void dap_app_reset_profile(DapApp* app);
\ No newline at end of file
@@ -48,6 +48,12 @@ DapGuiApp* dap_gui_alloc() {
     view_dispatcher_add_view(
         app->view_dispatcher, DapGuiAppViewMainView, dap_main_view_get_view(app->main_view));
 
+    app->profile_view = dap_profile_view_alloc();
+    view_dispatcher_add_view(
+        app->view_dispatcher,
+        DapGuiAppViewProfileView,
+        dap_profile_view_get_view(app->profile_view));
+
     app->widget = widget_alloc();
     view_dispatcher_add_view(
         app->view_dispatcher, DapGuiAppViewWidget, widget_get_view(app->widget));
@@ -64,6 +70,9 @@ void dap_gui_free(DapGuiApp* app) {
     view_dispatcher_remove_view(app->view_dispatcher, DapGuiAppViewMainView);
     dap_main_view_free(app->main_view);
 
+    view_dispatcher_remove_view(app->view_dispatcher, DapGuiAppViewProfileView);
+    dap_profile_view_free(app->profile_view);
+
     view_dispatcher_remove_view(app->view_dispatcher, DapGuiAppViewWidget);
     widget_free(app->widget);
 
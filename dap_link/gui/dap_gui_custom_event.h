@@ -4,4 +4,6 @@ typedef enum {
     DapAppCustomEventConfig,
     DapAppCustomEventHelp,
     DapAppCustomEventAbout,
+    DapAppCustomEventProfile,
+    DapAppCustomEventProfileReset,
 } DapAppCustomEvent;
@@ -1,4 +1,5 @@
 ADD_SCENE(dap, main, Main)
 ADD_SCENE(dap, config, Config)
+ADD_SCENE(dap, profile, Profile)
 ADD_SCENE(dap, help, Help)
 ADD_SCENE(dap, about, About)
\ No newline at end of file
@@ -107,6 +107,13 @@ static bool process_dap_state(DapGuiApp* app) {
         }
     }
 
+    if(prev_state->cdc_rx_dropped != next_state.cdc_rx_dropped ||
+       prev_state->cdc_rx_overrun != next_state.cdc_rx_overrun) {
+        dap_main_view_set_uart_lost(
+            app->main_view, next_state.cdc_rx_dropped || next_state.cdc_rx_overrun);
+        need_to_update = true;
+    }
+
     if(need_to_update) {
         dap_main_view_update(app->main_view);
     }
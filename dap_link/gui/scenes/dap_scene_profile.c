@@ -0,0 +1,47 @@
+#include "../dap_gui_i.h"
+
+static void dap_scene_profile_on_ok(void* context) {
+    DapGuiApp* app = context;
+    view_dispatcher_send_custom_event(app->view_dispatcher, DapAppCustomEventProfileReset);
+}
+
+void dap_scene_profile_on_enter(void* context) {
+    DapGuiApp* app = context;
+    // Too large for the GUI thread stack
+    DapProfile* profile = malloc(sizeof(DapProfile));
+
+    dap_app_get_profile(app->dap_app, profile);
+    dap_profile_view_set_profile(app->profile_view, profile);
+    dap_profile_view_set_ok_callback(app->profile_view, dap_scene_profile_on_ok, app);
+
+    scene_manager_set_scene_state(app->scene_manager, DapSceneProfile, (uint32_t)profile);
+    view_dispatcher_switch_to_view(app->view_dispatcher, DapGuiAppViewProfileView);
+}
+
+bool dap_scene_profile_on_event(void* context, SceneManagerEvent event) {
+    DapGuiApp* app = context;
+    DapProfile* profile =
+        (DapProfile*)scene_manager_get_scene_state(app->scene_manager, DapSceneProfile);
+
+    if(event.type == SceneManagerEventTypeCustom) {
+        if(event.event == DapAppCustomEventProfileReset) {
+            dap_app_reset_profile(app->dap_app);
+            return true;
+        }
+    } else if(event.type == SceneManagerEventTypeTick) {
+        dap_app_get_profile(app->dap_app, profile);
+        dap_profile_view_set_profile(app->profile_view, profile);
+        return true;
+    }
+
+    return false;
+}
+
+void dap_scene_profile_on_exit(void* context) {
+    DapGuiApp* app = context;
+    DapProfile* profile =
+        (DapProfile*)scene_manager_get_scene_state(app->scene_manager, DapSceneProfile);
+    scene_manager_set_scene_state(app->scene_manager, DapSceneProfile, (uint32_t)NULL);
+    dap_profile_view_set_ok_callback(app->profile_view, NULL, NULL);
+    free(profile);
+}
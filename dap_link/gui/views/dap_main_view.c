@@ -21,6 +21,7 @@ typedef struct {
     bool dap_active;
     bool tx_active;
     bool rx_active;
+    bool uart_lost;
 } DapMainViewModel;
 
 static void dap_main_view_draw_callback(Canvas* canvas, void* _model) {
@@ -81,7 +82,13 @@ static void dap_main_view_draw_callback(Canvas* canvas, void* _model) {
         canvas_draw_icon_ex(canvas, 101, 16, &I_ArrowUpEmpty_12x18, IconRotation180);
     }
 
+    // Inverted once received UART data had to be dropped
+    if(model->uart_lost) {
+        canvas_draw_rbox(canvas, 84, 37, 32, 11, 2);
+        canvas_set_color(canvas, ColorWhite);
+    }
     canvas_draw_str_aligned(canvas, 100, 38, AlignCenter, AlignTop, "UART");
+    canvas_set_color(canvas, ColorBlack);
 
     canvas_draw_line(canvas, 44, 52, 123, 52);
     if(model->baudrate == 0) {
@@ -165,6 +172,11 @@ void dap_main_view_set_rx(DapMainView* dap_main_view, bool active) {
         dap_main_view->view, DapMainViewModel * model, { model->rx_active = active; }, false);
 }
 
+void dap_main_view_set_uart_lost(DapMainView* dap_main_view, bool lost) {
+    with_view_model(
+        dap_main_view->view, DapMainViewModel * model, { model->uart_lost = lost; }, false);
+}
+
 void dap_main_view_set_baudrate(DapMainView* dap_main_view, uint32_t baudrate) {
     with_view_model(
         dap_main_view->view, DapMainViewModel * model, { model->baudrate = baudrate; }, false);
@@ -38,6 +38,8 @@ void dap_main_view_set_tx(DapMainView* dap_main_view, bool active);
 
 void dap_main_view_set_rx(DapMainView* dap_main_view, bool active);
 
+void dap_main_view_set_uart_lost(DapMainView* dap_main_view, bool lost);
+
 void dap_main_view_set_usb_connected(DapMainView* dap_main_view, bool connected);
 
 void dap_main_view_set_baudrate(DapMainView* dap_main_view, uint32_t baudrate);
@@ -0,0 +1,220 @@
+#include "dap_profile_view.h"
+#include <gui/elements.h>
+
+#define DAP_PROFILE_VIEW_ROWS (DAP_PROFILE_SIZE + 2)
+#define DAP_PROFILE_VIEW_VISIBLE 3
+
+struct DapProfileView {
+    View* view;
+    DapProfileViewButtonCallback cb_ok;
+    void* cb_context;
+};
+
+typedef struct {
+    const char* name;
+    uint32_t count;
+    uint32_t avg_us;
+    uint32_t max_us;
+    uint32_t wait;
+    uint32_t fault;
+    bool retries; // wait and fault apply to this row
+} DapProfileViewRow;
+
+typedef struct {
+    DapProfileViewRow rows[DAP_PROFILE_VIEW_ROWS];
+    uint8_t row_count;
+    uint8_t offset;
+} DapProfileViewModel;
+
+static const char* const dap_profile_command_names[DAP_PROFILE_SIZE] = {
+    [0x00] = "Info",
+    [0x01] = "Host Status",
+    [0x02] = "Connect",
+    [0x03] = "Disconnect",
+    [0x04] = "Transfer Cfg",
+    [0x05] = "Transfer",
+    [0x06] = "Transfer Block",
+    [0x07] = "Transfer Abort",
+    [0x08] = "Write Abort",
+    [0x09] = "Delay",
+    [0x0a] = "Reset Target",
+    [0x10] = "SWJ Pins",
+    [0x11] = "SWJ Clock",
+    [0x12] = "SWJ Sequence",
+    [0x13] = "SWD Configure",
+    [0x14] = "JTAG Sequence",
+    [0x15] = "JTAG Configure",
+    [0x16] = "JTAG IDCODE",
+    [0x17] = "SWO Transport",
+    [0x18] = "SWO Mode",
+    [0x19] = "SWO Baudrate",
+    [0x1a] = "SWO Control",
+    [0x1b] = "SWO Status",
+    [0x1c] = "SWO Data",
+    [0x1d] = "SWD Sequence",
+    [0x1e] = "SWO Ext Status",
+};
+
+static void dap_profile_view_draw_callback(Canvas* canvas, void* _model) {
+    DapProfileViewModel* model = _model;
+    char str[24];
+
+    canvas_clear(canvas);
+
+    canvas_set_color(canvas, ColorBlack);
+    canvas_draw_box(canvas, 0, 0, 127, 11);
+    canvas_set_color(canvas, ColorWhite);
+    canvas_draw_str_aligned(canvas, 64, 9, AlignCenter, AlignBottom, "Statistics");
+    canvas_set_color(canvas, ColorBlack);
+
+    canvas_set_font(canvas, FontSecondary);
+
+    if(model->row_count == 0) {
+        canvas_draw_str_aligned(canvas, 64, 30, AlignCenter, AlignCenter, "No requests yet");
+        canvas_draw_str_aligned(canvas, 64, 42, AlignCenter, AlignCenter, "OK resets the counters");
+        return;
+    }
+
+    for(uint8_t i = 0; i < DAP_PROFILE_VIEW_VISIBLE; i++) {
+        uint8_t index = model->offset + i;
+        if(index >= model->row_count) break;
+
+        DapProfileViewRow* row = &model->rows[index];
+        int32_t y = 20 + i * 16;
+
+        canvas_draw_str(canvas, 0, y, row->name);
+        snprintf(str, sizeof(str), "%lux", row->count);
+        canvas_draw_str_aligned(canvas, 122, y, AlignRight, AlignBottom, str);
+
+        snprintf(str, sizeof(str), "%lu/%lu us", row->avg_us, row->max_us);
+        canvas_draw_str(canvas, 4, y + 8, str);
+        if(row->retries) {
+            snprintf(str, sizeof(str), "W%lu F%lu", row->wait, row->fault);
+            canvas_draw_str_aligned(canvas, 122, y + 8, AlignRight, AlignBottom, str);
+        }
+    }
+
+    if(model->row_count > DAP_PROFILE_VIEW_VISIBLE) {
+        elements_scrollbar_pos(
+            canvas,
+            128,
+            12,
+            52,
+            model->offset,
+            model->row_count - DAP_PROFILE_VIEW_VISIBLE + 1);
+    }
+}
+
+static bool dap_profile_view_input_callback(InputEvent* event, void* context) {
+    furi_assert(context);
+    DapProfileView* dap_profile_view = context;
+    bool consumed = false;
+
+    if(event->type == InputTypeShort || event->type == InputTypeRepeat) {
+        if(event->key == InputKeyUp || event->key == InputKeyDown) {
+            with_view_model(
+                dap_profile_view->view,
+                DapProfileViewModel * model,
+                {
+                    if(event->key == InputKeyUp && model->offset > 0) {
+                        model->offset--;
+                    } else if(
+                        event->key == InputKeyDown &&
+                        model->offset + DAP_PROFILE_VIEW_VISIBLE < model->row_count) {
+                        model->offset++;
+                    }
+                },
+                true);
+            consumed = true;
+        } else if(event->key == InputKeyOk && event->type == InputTypeShort) {
+            if(dap_profile_view->cb_ok) {
+                dap_profile_view->cb_ok(dap_profile_view->cb_context);
+            }
+            consumed = true;
+        }
+    }
+
+    return consumed;
+}
+
+DapProfileView* dap_profile_view_alloc() {
+    DapProfileView* dap_profile_view = malloc(sizeof(DapProfileView));
+
+    dap_profile_view->view = view_alloc();
+    view_allocate_model(dap_profile_view->view, ViewModelTypeLocking, sizeof(DapProfileViewModel));
+    view_set_context(dap_profile_view->view, dap_profile_view);
+    view_set_draw_callback(dap_profile_view->view, dap_profile_view_draw_callback);
+    view_set_input_callback(dap_profile_view->view, dap_profile_view_input_callback);
+    return dap_profile_view;
+}
+
+void dap_profile_view_free(DapProfileView* dap_profile_view) {
+    view_free(dap_profile_view->view);
+    free(dap_profile_view);
+}
+
+View* dap_profile_view_get_view(DapProfileView* dap_profile_view) {
+    return dap_profile_view->view;
+}
+
+void dap_profile_view_set_ok_callback(
+    DapProfileView* dap_profile_view,
+    DapProfileViewButtonCallback callback,
+    void* context) {
+    with_view_model(
+        dap_profile_view->view,
+        DapProfileViewModel * model,
+        {
+            UNUSED(model);
+            dap_profile_view->cb_ok = callback;
+            dap_profile_view->cb_context = context;
+        },
+        true);
+}
+
+static void dap_profile_view_add_row(
+    DapProfileViewModel* model,
+    const char* name,
+    const dap_profile_t* profile,
+    uint32_t cycles_per_us,
+    bool retries) {
+    if(profile->count == 0) return;
+
+    DapProfileViewRow* row = &model->rows[model->row_count++];
+    row->name = name;
+    row->count = profile->count;
+    row->avg_us = profile->total / profile->count / cycles_per_us;
+    row->max_us = profile->max / cycles_per_us;
+    row->wait = profile->wait;
+    row->fault = profile->fault;
+    row->retries = retries;
+}
+
+void dap_profile_view_set_profile(DapProfileView* dap_profile_view, const DapProfile* profile) {
+    uint32_t cycles_per_us = profile->cycles_per_us ? profile->cycles_per_us : 1;
+
+    with_view_model(
+        dap_profile_view->view,
+        DapProfileViewModel * model,
+        {
+            model->row_count = 0;
+
+            // Where the time goes outside of the commands first
+            dap_profile_view_add_row(
+                model, "USB Latency", &profile->latency, cycles_per_us, false);
+            dap_profile_view_add_row(model, "Queued", &profile->queued, cycles_per_us, false);
+
+            for(uint8_t i = 0; i < DAP_PROFILE_SIZE; i++) {
+                const char* name = dap_profile_command_names[i];
+                dap_profile_view_add_row(
+                    model, name ? name : "Unknown", &profile->commands[i], cycles_per_us, true);
+            }
+
+            if(model->offset + DAP_PROFILE_VIEW_VISIBLE > model->row_count) {
+                model->offset = model->row_count > DAP_PROFILE_VIEW_VISIBLE ?
+                                    model->row_count - DAP_PROFILE_VIEW_VISIBLE :
+                                    0;
+            }
+        },
+        true);
+}
@@ -0,0 +1,20 @@
+#pragma once
+#include <gui/view.h>
+#include "../../dap_link.h"
+
+typedef struct DapProfileView DapProfileView;
+
+typedef void (*DapProfileViewButtonCallback)(void* context);
+
+DapProfileView* dap_profile_view_alloc();
+
+void dap_profile_view_free(DapProfileView* dap_profile_view);
+
+View* dap_profile_view_get_view(DapProfileView* dap_profile_view);
+
+void dap_profile_view_set_ok_callback(
+    DapProfileView* dap_profile_view,
+    DapProfileViewButtonCallback callback,
+    void* context);
+
+void dap_profile_view_set_profile(DapProfileView* dap_profile_view, const DapProfile* profile);
@@ -0,0 +1,457 @@
+// Host benchmark for free-dap
+//
+// Replays recorded CMSIS-DAP request streams through dap_process_request()
+// against the simulated target in dap_target.c and reports the request rate,
+// the SWCLK/TCK cycles spent on the wire, the payload of DAP_TransferBlock and
+// whether the responses and the target memory still match the recording.
+// With -p it also prints the profile dap.c keeps for every command.
+
+#include <errno.h>
+#include <inttypes.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+#include "dap_config.h"
+#include "dap.h"
+
+#define BENCH_LINE_SIZE 1024
+#define BENCH_DATA_SIZE 256
+
+#define BENCH_CMD_TRANSFER 0x05
+#define BENCH_CMD_TRANSFER_BLOCK 0x06
+#define BENCH_CMD_SWJ_CLOCK 0x11
+
+static const char* const bench_command_names[DAP_PROFILE_SIZE] = {
+    [0x00] = "DAP_Info",
+    [0x01] = "DAP_HostStatus",
+    [0x02] = "DAP_Connect",
+    [0x03] = "DAP_Disconnect",
+    [0x04] = "DAP_TransferConfigure",
+    [0x05] = "DAP_Transfer",
+    [0x06] = "DAP_TransferBlock",
+    [0x07] = "DAP_TransferAbort",
+    [0x08] = "DAP_WriteABORT",
+    [0x09] = "DAP_Delay",
+    [0x0a] = "DAP_ResetTarget",
+    [0x10] = "DAP_SWJ_Pins",
+    [0x11] = "DAP_SWJ_Clock",
+    [0x12] = "DAP_SWJ_Sequence",
+    [0x13] = "DAP_SWD_Configure",
+    [0x14] = "DAP_JTAG_Sequence",
+    [0x15] = "DAP_JTAG_Configure",
+    [0x16] = "DAP_JTAG_IDCODE",
+    [0x17] = "DAP_SWO_Transport",
+    [0x18] = "DAP_SWO_Mode",
+    [0x19] = "DAP_SWO_Baudrate",
+    [0x1a] = "DAP_SWO_Control",
+    [0x1b] = "DAP_SWO_Status",
+    [0x1c] = "DAP_SWO_Data",
+    [0x1d] = "DAP_SWD_Sequence",
+    [0x1e] = "DAP_SWO_ExtendedStatus",
+};
+
+typedef enum {
+    StreamLineText, // comments and blank lines, kept as they are by -u
+    StreamLineRequest, // > request bytes
+    StreamLineResponse, // < expected response bytes
+    StreamLineMemory, // @ address, expected memory bytes
+} StreamLineType;
+
+typedef struct {
+    StreamLineType type;
+    char* text;
+    uint32_t address;
+    uint8_t data[BENCH_DATA_SIZE];
+    int size;
+    // Response of a request in the last run
+    uint8_t response[DAP_CONFIG_PACKET_SIZE];
+    int response_size;
+} StreamLine;
+
+typedef struct {
+    const char* path;
+    StreamLine* lines;
+    int count;
+} Stream;
+
+typedef struct {
+    uint32_t requests;
+    uint32_t transfer_blocks;
+    uint64_t transfer_bytes; // data words moved by DAP_Transfer and DAP_TransferBlock
+    uint64_t block_bytes; // the part of it moved by DAP_TransferBlock
+    uint32_t clock;
+    uint32_t mismatches;
+    double time_ms;
+    DapTargetStats target;
+} StreamResult;
+
+static double bench_now_ms(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec * 1000.0 + ts.tv_nsec / 1000000.0;
+}
+
+static int bench_parse_bytes(const char* text, uint8_t* data, int max_size) {
+    int size = 0;
+    char* end;
+
+    while(1) {
+        unsigned long value = strtoul(text, &end, 16);
+        if(end == text) break;
+        if(size == max_size || value > 0xff) return -1;
+        data[size++] = value;
+        text = end;
+    }
+
+    while(*text == ' ' || *text == '\t' || *text == '\r' || *text == '\n') text++;
+
+    return *text ? -1 : size;
+}
+
+static bool stream_load(Stream* stream, const char* path) {
+    char line[BENCH_LINE_SIZE];
+    int capacity = 0;
+    int number = 0;
+
+    FILE* file = fopen(path, "r");
+    if(!file) {
+        fprintf(stderr, "%s: %s\n", path, strerror(errno));
+        return false;
+    }
+
+    memset(stream, 0, sizeof(*stream));
+    stream->path = path;
+
+    while(fgets(line, sizeof(line), file)) {
+        number++;
+
+        if(stream->count == capacity) {
+            capacity = capacity ? capacity * 2 : 256;
+            stream->lines = realloc(stream->lines, capacity * sizeof(StreamLine));
+        }
+
+        StreamLine* l = &stream->lines[stream->count++];
+        memset(l, 0, sizeof(*l));
+        l->text = strdup(line);
+
+        const char* data = line + 1;
+        int max_size = DAP_CONFIG_PACKET_SIZE;
+
+        switch(line[0]) {
+        case '>':
+            l->type = StreamLineRequest;
+            break;
+        case '<':
+            l->type = StreamLineResponse;
+            break;
+        case '@':
+            l->type = StreamLineMemory;
+            l->address = strtoul(data, (char**)&data, 16);
+            max_size = BENCH_DATA_SIZE;
+            break;
+        default:
+            l->type = StreamLineText;
+            continue;
+        }
+
+        l->size = bench_parse_bytes(data, l->data, max_size);
+        if(l->size <= 0) {
+            fprintf(stderr, "%s:%d: bad line\n", path, number);
+            fclose(file);
+            return false;
+        }
+    }
+
+    fclose(file);
+    return true;
+}
+
+static void stream_free(Stream* stream) {
+    for(int i = 0; i < stream->count; i++) {
+        free(stream->lines[i].text);
+    }
+    free(stream->lines);
+}
+
+static void bench_print_bytes(FILE* file, const uint8_t* data, int size) {
+    for(int i = 0; i < size; i++) {
+        fprintf(file, " %02x", data[i]);
+    }
+    fprintf(file, "\n");
+}
+
+static void bench_mismatch(
+    const Stream* stream,
+    int index,
+    const char* what,
+    const uint8_t* expected,
+    int expected_size,
+    const uint8_t* actual,
+    int actual_size) {
+    fprintf(stderr, "%s: line %d: %s mismatch\n  expected:", stream->path, index + 1, what);
+    bench_print_bytes(stderr, expected, expected_size);
+    fprintf(stderr, "  actual:  ");
+    bench_print_bytes(stderr, actual, actual_size);
+}
+
+// Runs the stream once from a freshly initialized adapter and target
+static void stream_run(Stream* stream, uint32_t wait_interval, bool report, StreamResult* result) {
+    StreamLine* request = NULL;
+
+    dap_target_init(wait_interval);
+    dap_init();
+    dap_profile_reset();
+
+    result->clock = DAP_CONFIG_DEFAULT_CLOCK;
+
+    for(int i = 0; i < stream->count; i++) {
+        StreamLine* l = &stream->lines[i];
+
+        if(l->type == StreamLineRequest) {
+            request = l;
+            l->response_size = dap_process_request(
+                l->data, l->size, l->response, sizeof(l->response));
+            result->requests++;
+
+            if(l->data[0] == BENCH_CMD_SWJ_CLOCK && l->size >= 5) {
+                result->clock = l->data[1] | (l->data[2] << 8) | (l->data[3] << 16) |
+                                ((uint32_t)l->data[4] << 24);
+            } else if(l->data[0] == BENCH_CMD_TRANSFER && l->response_size >= 3) {
+                // Every executed transfer moves one word, reads and writes alike
+                result->transfer_bytes += l->response[1] * 4;
+            } else if(l->data[0] == BENCH_CMD_TRANSFER_BLOCK && l->response_size >= 4) {
+                uint32_t bytes = (l->response[1] | (l->response[2] << 8)) * 4;
+                result->transfer_blocks++;
+                result->transfer_bytes += bytes;
+                result->block_bytes += bytes;
+            }
+        } else if(l->type == StreamLineResponse && request) {
+            if(l->size != request->response_size ||
+               memcmp(l->data, request->response, l->size) != 0) {
+                result->mismatches++;
+                if(report) {
+                    bench_mismatch(
+                        stream,
+                        i,
+                        "response",
+                        l->data,
+                        l->size,
+                        request->response,
+                        request->response_size);
+                }
+            }
+        } else if(l->type == StreamLineMemory) {
+            uint8_t* memory = dap_target_memory(l->address, l->size);
+            if(!memory || memcmp(memory, l->data, l->size) != 0) {
+                result->mismatches++;
+                if(report) {
+                    bench_mismatch(
+                        stream, i, "memory", l->data, l->size, memory, memory ? l->size : 0);
+                }
+            }
+        }
+    }
+
+    result->target = *dap_target_stats();
+}
+
+// -p: the profile of the last run, in SWCLK/TCK cycles
+static void bench_print_profile(void) {
+    printf(
+        "  %-24s %8s %12s %12s %8s %8s\n",
+        "command",
+        "count",
+        "avg cycles",
+        "max cycles",
+        "wait",
+        "fault");
+
+    for(int cmd = 0; cmd < DAP_PROFILE_SIZE; cmd++) {
+        const dap_profile_t* profile = dap_profile_get(cmd);
+        if(!profile->count) continue;
+
+        const char* name = bench_command_names[cmd];
+        printf(
+            "  %02x %-21s %8" PRIu32 " %12.1f %12" PRIu32 " %8" PRIu32 " %8" PRIu32 "\n",
+            cmd,
+            name ? name : "unknown",
+            profile->count,
+            (double)profile->total / profile->count,
+            profile->max,
+            profile->wait,
+            profile->fault);
+    }
+}
+
+// -u: writes the stream back with the responses and memory of the last run
+static bool stream_update(Stream* stream) {
+    FILE* file = fopen(stream->path, "w");
+    if(!file) {
+        fprintf(stderr, "%s: %s\n", stream->path, strerror(errno));
+        return false;
+    }
+
+    for(int i = 0; i < stream->count; i++) {
+        StreamLine* l = &stream->lines[i];
+
+        switch(l->type) {
+        case StreamLineText:
+            fputs(l->text, file);
+            break;
+        case StreamLineRequest:
+            fprintf(file, ">");
+            bench_print_bytes(file, l->data, l->size);
+            fprintf(file, "<");
+            bench_print_bytes(file, l->response, l->response_size);
+            break;
+        case StreamLineResponse:
+            break;
+        case StreamLineMemory: {
+            uint8_t* memory = dap_target_memory(l->address, l->size);
+            fprintf(file, "@ %08" PRIx32, l->address);
+            bench_print_bytes(file, memory ? memory : l->data, l->size);
+            break;
+        }
+        }
+    }
+
+    fclose(file);
+    return true;
+}
+
+static void bench_usage(const char* name) {
+    fprintf(
+        stderr,
+        "Usage: %s [-n runs] [-w wait_interval] [-p] [-u] stream...\n"
+        "  -n  replay every stream this many times for the timing (default: 1)\n"
+        "  -w  answer every n-th AP access with WAIT first (default: 0, never)\n"
+        "  -p  print the count, cycles and retries of every command\n"
+        "  -u  rewrite the expected responses and memory in the streams\n",
+        name);
+}
+
+int main(int argc, char** argv) {
+    int runs = 1;
+    uint32_t wait_interval = 0;
+    bool update = false;
+    bool profile = false;
+    bool failed = false;
+    int opt;
+
+    while((opt = getopt(argc, argv, "n:w:puh")) != -1) {
+        switch(opt) {
+        case 'n':
+            runs = atoi(optarg);
+            if(runs < 1) runs = 1;
+            break;
+        case 'w':
+            wait_interval = strtoul(optarg, NULL, 0);
+            break;
+        case 'p':
+            profile = true;
+            break;
+        case 'u':
+            update = true;
+            break;
+        default:
+            bench_usage(argv[0]);
+            return 1;
+        }
+    }
+
+    if(optind == argc) {
+        bench_usage(argv[0]);
+        return 1;
+    }
+
+    printf(
+        "%-28s %8s %10s %10s %7s %11s %11s %10s\n",
+        "stream",
+        "requests",
+        "req/s",
+        "cycles/req",
+        "blocks",
+        "bytes/block",
+        "wire KiB/s",
+        "mismatches");
+
+    for(int i = optind; i < argc; i++) {
+        Stream stream;
+        StreamResult result;
+
+        if(!stream_load(&stream, argv[i])) {
+            failed = true;
+            continue;
+        }
+
+        double start = bench_now_ms();
+        for(int run = 0; run < runs; run++) {
+            memset(&result, 0, sizeof(result));
+            stream_run(&stream, wait_interval, run == 0 && !update, &result);
+        }
+        result.time_ms = bench_now_ms() - start;
+
+        const DapTargetStats* target = &result.target;
+        double cycles_per_request = result.requests ? (double)target->cycles / result.requests : 0;
+        double requests_per_s = result.time_ms > 0 ?
+                                    result.requests * (double)runs * 1000.0 / result.time_ms :
+                                    0;
+        // Payload rate the SWD/JTAG side alone would allow at the requested clock
+        double wire_kib_s = target->cycles ? result.transfer_bytes * (double)result.clock /
+                                                 target->cycles / 1024.0 :
+                                             0;
+
+        printf(
+            "%-28s %8" PRIu32 " %10.0f %10.1f %7" PRIu32 " %11.1f %11.1f %10" PRIu32 "\n",
+            stream.path,
+            result.requests,
+            requests_per_s,
+            cycles_per_request,
+            result.transfer_blocks,
+            result.transfer_blocks ? (double)result.block_bytes / result.transfer_blocks : 0,
+            wire_kib_s,
+            update ? 0 : result.mismatches);
+        printf(
+            "  target: %" PRIu64 " cycles at %" PRIu32 " Hz, %" PRIu32 " line resets, SWD ok %" PRIu32
+            " wait %" PRIu32 " fault %" PRIu32 " no ack %" PRIu32 ", JTAG scans %" PRIu32
+            " wait %" PRIu32 ", bus errors %" PRIu32 ", %" PRIu64 " bytes read, %" PRIu64
+            " written\n",
+            target->cycles,
+            result.clock,
+            target->line_resets,
+            target->swd_ok,
+            target->swd_wait,
+            target->swd_fault,
+            target->swd_no_ack,
+            target->jtag_scans,
+            target->jtag_wait,
+            target->bus_errors,
+            target->bytes_read,
+            target->bytes_written);
+
+        if(profile) {
+            bench_print_profile();
+        }
+
+        // Errors on the wire are bugs in dap.c, whatever the recording says
+        if(target->protocol_errors || target->contention) {
+            printf(
+                "  protocol errors %" PRIu32 ", SWDIO contention in %" PRIu32 " cycles\n",
+                target->protocol_errors,
+                target->contention);
+            failed = true;
+        }
+
+        if(update) {
+            failed |= !stream_update(&stream);
+        } else if(result.mismatches) {
+            failed = true;
+        }
+
+        stream_free(&stream);
+    }
+
+    return failed ? 1 : 0;
+}
@@ -0,0 +1,841 @@
+// Simulated debug target for the free-dap host benchmark
+//
+// SWD and JTAG share SWDIO/TMS and SWCLK/TCK like on a real SWJ-DP. The port
+// powers up in JTAG and switches on the ADIv5 select sequences. Behind it sit
+// the DP registers and one AHB-AP with flash, SRAM, the SCS and a ROM table.
+
+#include <string.h>
+#include "dap_target.h"
+
+#define LINE_RESET_BITS 50
+#define SELECT_JTAG_TO_SWD 0xe79e
+#define SELECT_SWD_TO_JTAG 0xe73c
+#define SELECT_BITS 16
+#define WAIT_RESPONSES 2
+
+// SWD ACK as it goes out on the wire, LSB first
+#define SWD_ACK_OK 0x1
+#define SWD_ACK_WAIT 0x2
+#define SWD_ACK_FAULT 0x4
+
+#define JTAG_ACK_OK_FAULT 0x2
+#define JTAG_ACK_WAIT 0x1
+
+#define JTAG_IR_LENGTH 4
+#define JTAG_IR_ABORT 0x8
+#define JTAG_IR_DPACC 0xa
+#define JTAG_IR_APACC 0xb
+#define JTAG_IR_IDCODE 0xe
+#define JTAG_IR_BYPASS 0xf
+#define JTAG_DPACC_LENGTH 35
+
+#define DP_DPIDR 0x0
+#define DP_ABORT 0x0
+#define DP_CTRL_STAT 0x4
+#define DP_SELECT 0x8
+#define DP_RESEND 0x8
+#define DP_RDBUFF 0xc
+
+#define ABORT_DAPABORT (1u << 0)
+#define ABORT_STKCMPCLR (1u << 1)
+#define ABORT_STKERRCLR (1u << 2)
+#define ABORT_WDERRCLR (1u << 3)
+#define ABORT_ORUNERRCLR (1u << 4)
+
+#define CTRL_STAT_STICKYORUN (1u << 1)
+#define CTRL_STAT_STICKYCMP (1u << 4)
+#define CTRL_STAT_STICKYERR (1u << 5)
+#define CTRL_STAT_WDATAERR (1u << 7)
+#define CTRL_STAT_CDBGPWRUPREQ (1u << 28)
+#define CTRL_STAT_CSYSPWRUPREQ (1u << 30)
+#define CTRL_STAT_STICKY \
+    (CTRL_STAT_STICKYORUN | CTRL_STAT_STICKYCMP | CTRL_STAT_STICKYERR | CTRL_STAT_WDATAERR)
+// Power-up and reset requests, TRNCNT, MASKLANE, TRNMODE and ORUNDETECT
+#define CTRL_STAT_WRITABLE 0x54ffff0d
+
+#define DLCR_TURNROUND_SHIFT 8
+
+#define AP_CSW 0x00
+#define AP_TAR 0x04
+#define AP_DRW 0x0c
+#define AP_BD0 0x10
+#define AP_BD3 0x1c
+#define AP_CFG 0xf4
+#define AP_BASE 0xf8
+#define AP_IDR 0xfc
+
+#define CSW_SIZE_MASK 0x7
+#define CSW_ADDRINC_MASK (3u << 4)
+#define CSW_ADDRINC_OFF (0u << 4)
+#define CSW_DEVICEEN (1u << 6)
+#define CSW_TRINPROG (1u << 7)
+// The AHB-AP only guarantees the TAR auto-increment within a 1 KiB block
+#define TAR_INCREMENT_MASK 0x3ff
+
+#define SCS_BASE 0xe000e000
+#define SCS_SIZE 0x1000
+#define SCS_CPUID 0xd00
+#define CPUID_CORTEX_M4 0x410fc241
+#define ROM_TABLE_BASE 0xe00ff000
+#define ROM_TABLE_SIZE 0x1000
+
+typedef enum {
+    TargetModeJtag,
+    TargetModeSwd,
+} TargetMode;
+
+typedef enum {
+    SwdPhaseLineReset, // SWDIO high for at least LINE_RESET_BITS cycles, wait for idle
+    SwdPhaseLockout, // no response until the next line reset
+    SwdPhaseIdle,
+    SwdPhaseHeader,
+    SwdPhaseTrnAck,
+    SwdPhaseAck,
+    SwdPhaseReadData,
+    SwdPhaseTrnWrite,
+    SwdPhaseWriteData,
+    SwdPhaseTrnIdle,
+} SwdPhase;
+
+typedef enum {
+    JtagTestLogicReset,
+    JtagRunTestIdle,
+    JtagSelectDrScan,
+    JtagCaptureDr,
+    JtagShiftDr,
+    JtagExit1Dr,
+    JtagPauseDr,
+    JtagExit2Dr,
+    JtagUpdateDr,
+    JtagSelectIrScan,
+    JtagCaptureIr,
+    JtagShiftIr,
+    JtagExit1Ir,
+    JtagPauseIr,
+    JtagExit2Ir,
+    JtagUpdateIr,
+} JtagState;
+
+// Next TAP state for TMS = 0 and TMS = 1
+static const uint8_t jtag_next_state[][2] = {
+    [JtagTestLogicReset] = {JtagRunTestIdle, JtagTestLogicReset},
+    [JtagRunTestIdle] = {JtagRunTestIdle, JtagSelectDrScan},
+    [JtagSelectDrScan] = {JtagCaptureDr, JtagSelectIrScan},
+    [JtagCaptureDr] = {JtagShiftDr, JtagExit1Dr},
+    [JtagShiftDr] = {JtagShiftDr, JtagExit1Dr},
+    [JtagExit1Dr] = {JtagPauseDr, JtagUpdateDr},
+    [JtagPauseDr] = {JtagPauseDr, JtagExit2Dr},
+    [JtagExit2Dr] = {JtagShiftDr, JtagUpdateDr},
+    [JtagUpdateDr] = {JtagRunTestIdle, JtagSelectDrScan},
+    [JtagSelectIrScan] = {JtagCaptureIr, JtagTestLogicReset},
+    [JtagCaptureIr] = {JtagShiftIr, JtagExit1Ir},
+    [JtagShiftIr] = {JtagShiftIr, JtagExit1Ir},
+    [JtagExit1Ir] = {JtagPauseIr, JtagUpdateIr},
+    [JtagPauseIr] = {JtagPauseIr, JtagExit2Ir},
+    [JtagExit2Ir] = {JtagShiftIr, JtagUpdateIr},
+    [JtagUpdateIr] = {JtagRunTestIdle, JtagSelectDrScan},
+};
+
+typedef struct {
+    uint32_t base;
+    uint32_t size;
+    bool writable;
+    uint8_t* data;
+} TargetRegion;
+
+typedef struct {
+    // Pins
+    int swclk;
+    int swdio;
+    bool swdio_output;
+    int tdi;
+    int tdo;
+    int nreset;
+    bool drive; // the target drives SWDIO in the next cycle
+    int drive_bit;
+
+    // Port selection
+    TargetMode mode;
+    uint32_t ones;
+    bool select_active;
+    uint32_t select_bits;
+    int select_count;
+
+    // SWD
+    SwdPhase phase;
+    int bit;
+    uint32_t header;
+    uint32_t ack;
+    uint32_t data;
+    uint32_t parity;
+    bool reset_state; // only a DPIDR read is answered after a line reset
+    int turnaround;
+
+    // JTAG
+    JtagState jtag_state;
+    uint32_t ir;
+    uint32_t ir_shift;
+    uint64_t dr_shift;
+    int dr_length;
+    uint32_t jtag_result;
+    bool jtag_discard;
+
+    // DP
+    uint32_t ctrl_stat;
+    uint32_t select;
+    uint32_t rdbuff;
+    uint32_t resend;
+
+    // MEM-AP
+    uint32_t csw;
+    uint32_t tar;
+
+    // WAIT injection
+    uint32_t wait_interval;
+    uint32_t ap_accesses;
+    int wait_left;
+    bool wait_served;
+
+    DapTargetStats stats;
+} DapTarget;
+
+static DapTarget target;
+
+static uint8_t target_flash[DAP_TARGET_FLASH_SIZE];
+static uint8_t target_ram[DAP_TARGET_RAM_SIZE];
+static uint8_t target_scs[SCS_SIZE];
+static uint8_t target_rom_table[ROM_TABLE_SIZE];
+
+static const TargetRegion target_regions[] = {
+    {DAP_TARGET_FLASH_BASE, DAP_TARGET_FLASH_SIZE, false, target_flash},
+    {DAP_TARGET_RAM_BASE, DAP_TARGET_RAM_SIZE, true, target_ram},
+    {SCS_BASE, SCS_SIZE, true, target_scs},
+    {ROM_TABLE_BASE, ROM_TABLE_SIZE, false, target_rom_table},
+};
+
+static uint32_t target_parity(uint32_t value) {
+    return __builtin_parity(value);
+}
+
+static void target_put_word(uint8_t* data, uint32_t value) {
+    for(int i = 0; i < 4; i++) {
+        data[i] = value >> (i * 8);
+    }
+}
+
+static const TargetRegion* target_region(uint32_t address, uint32_t size) {
+    for(size_t i = 0; i < sizeof(target_regions) / sizeof(target_regions[0]); i++) {
+        const TargetRegion* region = &target_regions[i];
+        if(address >= region->base && size <= region->size &&
+           address - region->base <= region->size - size) {
+            return region;
+        }
+    }
+    return NULL;
+}
+
+uint8_t* dap_target_memory(uint32_t address, uint32_t size) {
+    const TargetRegion* region = target_region(address, size);
+    return region ? region->data + (address - region->base) : NULL;
+}
+
+static void target_memory_init(void) {
+    // Flash holds a pattern that no stream writes, so reads of it are checked too
+    for(uint32_t i = 0; i < DAP_TARGET_FLASH_SIZE; i++) {
+        target_flash[i] = (i * 7) ^ (i >> 8);
+    }
+    memset(target_ram, 0, sizeof(target_ram));
+    memset(target_scs, 0, sizeof(target_scs));
+    target_put_word(&target_scs[SCS_CPUID], CPUID_CORTEX_M4);
+
+    // One entry pointing at the SCS, then the component ID of a ROM table
+    memset(target_rom_table, 0, sizeof(target_rom_table));
+    target_put_word(&target_rom_table[0x000], (SCS_BASE - ROM_TABLE_BASE) | 0x3);
+    target_put_word(&target_rom_table[0xff0], 0x0d);
+    target_put_word(&target_rom_table[0xff4], 0x10);
+    target_put_word(&target_rom_table[0xff8], 0x05);
+    target_put_word(&target_rom_table[0xffc], 0xb1);
+}
+
+static uint32_t target_bus_access(uint32_t address, bool write, uint32_t value) {
+    uint32_t size = 1u << (target.csw & CSW_SIZE_MASK);
+    uint32_t lane = (address & 3) * 8;
+    const TargetRegion* region = NULL;
+
+    if(size <= 4 && (address & (size - 1)) == 0) {
+        region = target_region(address, size);
+    }
+
+    if(!region || (write && !region->writable)) {
+        target.ctrl_stat |= CTRL_STAT_STICKYERR;
+        target.stats.bus_errors++;
+        value = 0;
+    } else if(write) {
+        uint8_t* data = &region->data[address - region->base];
+        for(uint32_t i = 0; i < size; i++) {
+            data[i] = value >> (lane + i * 8);
+        }
+        target.stats.bytes_written += size;
+    } else {
+        uint8_t* data = &region->data[address - region->base];
+        value = 0;
+        for(uint32_t i = 0; i < size; i++) {
+            value |= (uint32_t)data[i] << (lane + i * 8);
+        }
+        target.stats.bytes_read += size;
+    }
+
+    return value;
+}
+
+static uint32_t target_drw_access(bool write, uint32_t value) {
+    value = target_bus_access(target.tar, write, value);
+
+    if((target.csw & CSW_ADDRINC_MASK) != CSW_ADDRINC_OFF) {
+        // Packed increment is treated like single, the data is never packed
+        uint32_t size = 1u << (target.csw & CSW_SIZE_MASK);
+        target.tar = (target.tar & ~TAR_INCREMENT_MASK) |
+                     ((target.tar + size) & TAR_INCREMENT_MASK);
+    }
+
+    return value;
+}
+
+static uint32_t target_ap_read(uint32_t address) {
+    uint32_t reg = (target.select & 0xf0) | address;
+
+    // Only AP 0 exists, the others read as zero
+    if(target.select >> 24) return 0;
+
+    switch(reg) {
+    case AP_CSW:
+        return target.csw;
+    case AP_TAR:
+        return target.tar;
+    case AP_DRW:
+        return target_drw_access(false, 0);
+    case AP_BD0 ... AP_BD3: {
+        uint32_t tar = target.tar;
+        uint32_t csw = target.csw;
+        target.csw = (csw & ~CSW_SIZE_MASK) | 2;
+        uint32_t value = target_bus_access((tar & ~0xf) | (reg & 0xc), false, 0);
+        target.csw = csw;
+        return value;
+    }
+    case AP_BASE:
+        return ROM_TABLE_BASE | 0x3;
+    case AP_IDR:
+        return DAP_TARGET_AP_IDR;
+    default:
+        return 0;
+    }
+}
+
+static void target_ap_write(uint32_t address, uint32_t value) {
+    uint32_t reg = (target.select & 0xf0) | address;
+
+    if(target.select >> 24) return;
+
+    switch(reg) {
+    case AP_CSW:
+        target.csw = (value & ~CSW_TRINPROG) | CSW_DEVICEEN;
+        break;
+    case AP_TAR:
+        target.tar = value;
+        break;
+    case AP_DRW:
+        target_drw_access(true, value);
+        break;
+    case AP_BD0 ... AP_BD3: {
+        uint32_t csw = target.csw;
+        target.csw = (csw & ~CSW_SIZE_MASK) | 2;
+        target_bus_access((target.tar & ~0xf) | (reg & 0xc), true, value);
+        target.csw = csw;
+        break;
+    }
+    default:
+        break;
+    }
+}
+
+static uint32_t target_dp_read(uint32_t address) {
+    switch(address) {
+    case DP_DPIDR:
+        return DAP_TARGET_DPIDR;
+    case DP_CTRL_STAT:
+        if(target.select & 0xf) {
+            return (target.turnaround - 1) << DLCR_TURNROUND_SHIFT;
+        }
+        return target.ctrl_stat;
+    case DP_RESEND:
+        return target.resend;
+    default:
+        return target.rdbuff;
+    }
+}
+
+static void target_abort(uint32_t value) {
+    if(value & ABORT_DAPABORT) target.wait_left = 0;
+    if(value & ABORT_STKCMPCLR) target.ctrl_stat &= ~CTRL_STAT_STICKYCMP;
+    if(value & ABORT_STKERRCLR) target.ctrl_stat &= ~CTRL_STAT_STICKYERR;
+    if(value & ABORT_WDERRCLR) target.ctrl_stat &= ~CTRL_STAT_WDATAERR;
+    if(value & ABORT_ORUNERRCLR) target.ctrl_stat &= ~CTRL_STAT_STICKYORUN;
+}
+
+static void target_dp_write(uint32_t address, uint32_t value) {
+    switch(address) {
+    case DP_ABORT:
+        target_abort(value);
+        break;
+    case DP_CTRL_STAT:
+        if(target.select & 0xf) {
+            target.turnaround = ((value >> DLCR_TURNROUND_SHIFT) & 3) + 1;
+            break;
+        }
+        // The JTAG-DP clears sticky flags written as one, SW-DP only through ABORT
+        if(target.mode == TargetModeJtag) {
+            target.ctrl_stat &= ~(value & CTRL_STAT_STICKY);
+        }
+        target.ctrl_stat = (target.ctrl_stat & ~CTRL_STAT_WRITABLE) | (value & CTRL_STAT_WRITABLE);
+        // Power-up requests are acknowledged right away
+        target.ctrl_stat &= ~((CTRL_STAT_CDBGPWRUPREQ | CTRL_STAT_CSYSPWRUPREQ) << 1);
+        target.ctrl_stat |= (target.ctrl_stat & (CTRL_STAT_CDBGPWRUPREQ | CTRL_STAT_CSYSPWRUPREQ))
+                            << 1;
+        break;
+    case DP_SELECT:
+        target.select = value;
+        break;
+    default:
+        break;
+    }
+}
+
+static bool target_ap_wait(void) {
+    if(target.wait_interval && !target.wait_left && !target.wait_served &&
+       target.ap_accesses % target.wait_interval == target.wait_interval - 1) {
+        target.wait_left = WAIT_RESPONSES;
+        target.wait_served = true;
+    }
+
+    if(target.wait_left) {
+        target.wait_left--;
+        return true;
+    }
+
+    return false;
+}
+
+static void target_ap_accessed(void) {
+    target.ap_accesses++;
+    target.wait_served = false;
+}
+
+//-----------------------------------------------------------------------------
+// SWD
+
+static void swd_request(void) {
+    uint32_t header = target.header;
+    bool ap = (header >> 1) & 1;
+    bool read = (header >> 2) & 1;
+    uint32_t address = ((header >> 3) & 3) << 2;
+    bool valid = ((header >> 6) & 1) == 0 && ((header >> 7) & 1) == 1 &&
+                 target_parity((header >> 1) & 0xf) == ((header >> 5) & 1);
+
+    target.bit = 0;
+
+    if(!valid) {
+        target.stats.protocol_errors++;
+        target.stats.swd_no_ack++;
+        target.phase = SwdPhaseLockout;
+        return;
+    }
+
+    if(target.reset_state && (ap || !read || address != DP_DPIDR)) {
+        target.stats.swd_no_ack++;
+        target.phase = SwdPhaseLockout;
+        return;
+    }
+
+    target.phase = SwdPhaseTrnAck;
+
+    if((target.ctrl_stat & CTRL_STAT_STICKY) &&
+       (ap || (address != DP_DPIDR && address != DP_CTRL_STAT))) {
+        target.ack = SWD_ACK_FAULT;
+        target.stats.swd_fault++;
+        return;
+    }
+
+    if(ap && target_ap_wait()) {
+        target.ack = SWD_ACK_WAIT;
+        target.stats.swd_wait++;
+        return;
+    }
+
+    target.ack = SWD_ACK_OK;
+    target.stats.swd_ok++;
+
+    if(!read) return;
+
+    if(ap) {
+        // AP reads are posted, the result comes with the next AP read or RDBUFF
+        target.data = target.rdbuff;
+        target.rdbuff = target_ap_read(address);
+        target_ap_accessed();
+    } else {
+        target.data = target_dp_read(address);
+        if(address == DP_DPIDR) target.reset_state = false;
+    }
+
+    target.resend = target.data;
+}
+
+static void swd_write(void) {
+    bool ap = (target.header >> 1) & 1;
+    uint32_t address = ((target.header >> 3) & 3) << 2;
+
+    if(target_parity(target.data) != target.parity) {
+        target.ctrl_stat |= CTRL_STAT_WDATAERR;
+        target.stats.protocol_errors++;
+    } else if(ap) {
+        target_ap_write(address, target.data);
+        target_ap_accessed();
+    } else {
+        target_dp_write(address, target.data);
+    }
+}
+
+static void swd_cycle(int line, bool host) {
+    switch(target.phase) {
+    case SwdPhaseLineReset:
+    case SwdPhaseLockout:
+        break;
+
+    case SwdPhaseIdle:
+        if(host && line) {
+            target.header = 1;
+            target.bit = 1;
+            target.phase = SwdPhaseHeader;
+        }
+        break;
+
+    case SwdPhaseHeader:
+        target.header |= line << target.bit;
+        if(++target.bit == 8) swd_request();
+        break;
+
+    case SwdPhaseTrnAck:
+        if(++target.bit == target.turnaround) {
+            target.bit = 0;
+            target.phase = SwdPhaseAck;
+        }
+        break;
+
+    case SwdPhaseAck:
+        if(++target.bit == 3) {
+            target.bit = 0;
+            if(target.ack != SWD_ACK_OK) {
+                target.phase = SwdPhaseTrnIdle;
+            } else if((target.header >> 2) & 1) {
+                target.phase = SwdPhaseReadData;
+            } else {
+                target.phase = SwdPhaseTrnWrite;
+            }
+        }
+        break;
+
+    case SwdPhaseReadData:
+        if(++target.bit == 33) {
+            target.bit = 0;
+            target.phase = SwdPhaseTrnIdle;
+        }
+        break;
+
+    case SwdPhaseTrnWrite:
+        if(++target.bit == target.turnaround) {
+            target.bit = 0;
+            target.data = 0;
+            target.phase = SwdPhaseWriteData;
+        }
+        break;
+
+    case SwdPhaseWriteData:
+        if(!host) target.stats.protocol_errors++;
+        if(target.bit < 32) {
+            target.data |= (uint32_t)line << target.bit;
+        } else {
+            target.parity = line;
+            swd_write();
+        }
+        if(++target.bit == 33) {
+            target.bit = 0;
+            target.phase = SwdPhaseIdle;
+        }
+        break;
+
+    case SwdPhaseTrnIdle:
+        if(++target.bit == target.turnaround) {
+            target.bit = 0;
+            target.phase = SwdPhaseIdle;
+        }
+        break;
+    }
+}
+
+static void swd_drive(void) {
+    target.drive = true;
+
+    if(target.phase == SwdPhaseAck) {
+        target.drive_bit = (target.ack >> target.bit) & 1;
+    } else if(target.phase == SwdPhaseReadData) {
+        target.drive_bit = (target.bit < 32) ? (target.data >> target.bit) & 1 :
+                                               target_parity(target.data);
+    } else {
+        target.drive = false;
+    }
+}
+
+//-----------------------------------------------------------------------------
+// JTAG
+
+static void jtag_capture_dr(void) {
+    switch(target.ir) {
+    case JTAG_IR_IDCODE:
+        target.dr_length = 32;
+        target.dr_shift = DAP_TARGET_JTAG_IDCODE;
+        break;
+    case JTAG_IR_DPACC:
+    case JTAG_IR_APACC:
+    case JTAG_IR_ABORT:
+        target.dr_length = JTAG_DPACC_LENGTH;
+        target.jtag_discard = (target.ir == JTAG_IR_APACC) && target_ap_wait();
+        target.dr_shift = ((uint64_t)target.jtag_result << 3) |
+                          (target.jtag_discard ? JTAG_ACK_WAIT : JTAG_ACK_OK_FAULT);
+        if(target.jtag_discard) target.stats.jtag_wait++;
+        break;
+    default:
+        target.dr_length = 1;
+        target.dr_shift = 0;
+        break;
+    }
+}
+
+static void jtag_update_dr(void) {
+    bool read = target.dr_shift & 1;
+    uint32_t address = ((target.dr_shift >> 1) & 3) << 2;
+    uint32_t value = target.dr_shift >> 3;
+
+    if(target.dr_length != JTAG_DPACC_LENGTH || target.jtag_discard) return;
+
+    target.stats.jtag_scans++;
+
+    if(target.ir == JTAG_IR_ABORT) {
+        target_abort(value & ABORT_DAPABORT);
+    } else if(target.ir == JTAG_IR_DPACC) {
+        if(read) {
+            target.jtag_result = (address == DP_RDBUFF) ? 0 : target_dp_read(address);
+        } else {
+            target_dp_write(address, value);
+        }
+    } else if(target.ctrl_stat & CTRL_STAT_STICKY) {
+        // Sticky errors block AP accesses, there is no FAULT response in JTAG
+        target.jtag_result = 0;
+    } else {
+        if(read) {
+            target.jtag_result = target_ap_read(address);
+        } else {
+            target_ap_write(address, value);
+        }
+        target_ap_accessed();
+    }
+}
+
+static void jtag_cycle(int tms) {
+    switch(target.jtag_state) {
+    case JtagCaptureDr:
+        jtag_capture_dr();
+        break;
+    case JtagShiftDr:
+        target.dr_shift = (target.dr_shift >> 1) |
+                          ((uint64_t)target.tdi << (target.dr_length - 1));
+        break;
+    case JtagCaptureIr:
+        target.ir_shift = 0x1;
+        break;
+    case JtagShiftIr:
+        target.ir_shift = (target.ir_shift >> 1) | (target.tdi << (JTAG_IR_LENGTH - 1));
+        break;
+    default:
+        break;
+    }
+
+    target.jtag_state = jtag_next_state[target.jtag_state][tms];
+
+    switch(target.jtag_state) {
+    case JtagTestLogicReset:
+        target.ir = JTAG_IR_IDCODE;
+        break;
+    case JtagShiftDr:
+        target.tdo = target.dr_shift & 1;
+        break;
+    case JtagShiftIr:
+        target.tdo = target.ir_shift & 1;
+        break;
+    case JtagUpdateDr:
+        jtag_update_dr();
+        break;
+    case JtagUpdateIr:
+        target.ir = target.ir_shift;
+        break;
+    default:
+        break;
+    }
+}
+
+//-----------------------------------------------------------------------------
+// Port selection
+
+static void target_line_reset(void) {
+    target.stats.line_resets++;
+    target.phase = SwdPhaseLineReset;
+    target.reset_state = true;
+    target.bit = 0;
+}
+
+// Collects the bits following a line reset while they can still be a select
+// sequence. Returns true when the bit is not part of one and goes to the port.
+static bool target_select_bit(int line) {
+    target.select_bits |= (uint32_t)line << target.select_count;
+    target.select_count++;
+
+    uint32_t mask = (1u << target.select_count) - 1;
+    bool to_swd = ((target.select_bits ^ SELECT_JTAG_TO_SWD) & mask) == 0;
+    bool to_jtag = ((target.select_bits ^ SELECT_SWD_TO_JTAG) & mask) == 0;
+
+    if(target.select_count == SELECT_BITS && (to_swd || to_jtag)) {
+        target.select_active = false;
+        target.mode = to_swd ? TargetModeSwd : TargetModeJtag;
+        target.jtag_state = JtagTestLogicReset;
+        target.ir = JTAG_IR_IDCODE;
+        // SWD starts out locked until the line reset that follows the sequence
+        target.phase = SwdPhaseLockout;
+        return false;
+    }
+
+    if(to_swd || to_jtag) return false;
+
+    // Not a select sequence, hand the held back bits to the SWD port
+    target.select_active = false;
+    if(target.mode == TargetModeSwd) {
+        for(int i = 0; i < target.select_count - 1; i++) {
+            swd_cycle((target.select_bits >> i) & 1, true);
+        }
+    }
+
+    return true;
+}
+
+static void target_clock(void) {
+    bool host = target.swdio_output;
+    int line = host ? target.swdio : (target.drive ? target.drive_bit : 1);
+    bool port = true;
+
+    target.stats.cycles++;
+
+    if(host && target.drive) target.stats.contention++;
+
+    if(host) {
+        if(line) {
+            if(++target.ones == LINE_RESET_BITS) target_line_reset();
+        } else {
+            if(target.ones >= LINE_RESET_BITS) {
+                target.select_active = true;
+                target.select_bits = 0;
+                target.select_count = 0;
+                if(target.phase == SwdPhaseLineReset) target.phase = SwdPhaseIdle;
+            }
+            target.ones = 0;
+        }
+
+        if(target.select_active) port = target_select_bit(line);
+    }
+
+    if(target.mode == TargetModeJtag) {
+        jtag_cycle(line);
+    } else if(port) {
+        swd_cycle(line, host);
+    }
+
+    swd_drive();
+}
+
+//-----------------------------------------------------------------------------
+
+void dap_target_init(uint32_t wait_interval) {
+    memset(&target, 0, sizeof(target));
+
+    target.swclk = 1;
+    target.swdio = 1;
+    target.tdi = 1;
+    target.tdo = 1;
+    target.nreset = 1;
+    target.mode = TargetModeJtag;
+    target.phase = SwdPhaseLockout;
+    target.reset_state = true;
+    target.turnaround = 1;
+    target.jtag_state = JtagTestLogicReset;
+    target.ir = JTAG_IR_IDCODE;
+    target.csw = CSW_DEVICEEN | 2;
+    target.wait_interval = wait_interval;
+
+    target_memory_init();
+}
+
+const DapTargetStats* dap_target_stats(void) {
+    return &target.stats;
+}
+
+void dap_target_swclk_write(int value) {
+    value = value ? 1 : 0;
+    if(value && !target.swclk) {
+        target.swclk = 1;
+        target_clock();
+    }
+    target.swclk = value;
+}
+
+int dap_target_swclk_read(void) {
+    return target.swclk;
+}
+
+void dap_target_swdio_write(int value) {
+    target.swdio = value ? 1 : 0;
+}
+
+int dap_target_swdio_read(void) {
+    if(target.swdio_output) return target.swdio;
+    return target.drive ? target.drive_bit : 1;
+}
+
+void dap_target_swdio_output(bool output) {
+    target.swdio_output = output;
+}
+
+void dap_target_tdi_write(int value) {
+    target.tdi = value ? 1 : 0;
+}
+
+int dap_target_tdi_read(void) {
+    return target.tdi;
+}
+
+int dap_target_tdo_read(void) {
+    return (target.mode == TargetModeJtag) ? target.tdo : 1;
+}
+
+void dap_target_nreset_write(int value) {
+    target.nreset = value ? 1 : 0;
+}
+
+int dap_target_nreset_read(void) {
+    return target.nreset;
+}
@@ -0,0 +1,55 @@
+#pragma once
+
+#include <stdbool.h>
+#include <stdint.h>
+
+// Simulated SWJ-DP with a MEM-AP and a small memory map, driven through the
+// same pin accessors free-dap uses on the device (see include/dap_config.h).
+// The target follows the wire protocol cycle by cycle on every rising SWCLK/TCK
+// edge, so the bit loops, turnarounds and retries of dap.c run unmodified.
+
+#define DAP_TARGET_DPIDR       0x2ba01477 // SW-DP of a Cortex-M4
+#define DAP_TARGET_JTAG_IDCODE 0x4ba00477 // JTAG-DP of a Cortex-M4
+#define DAP_TARGET_AP_IDR      0x24770011 // AHB-AP
+#define DAP_TARGET_RAM_BASE    0x20000000
+#define DAP_TARGET_RAM_SIZE    (64 * 1024)
+#define DAP_TARGET_FLASH_BASE  0x08000000
+#define DAP_TARGET_FLASH_SIZE  (64 * 1024)
+
+typedef struct {
+    uint64_t cycles; // SWCLK/TCK rising edges
+    uint32_t line_resets;
+    uint32_t swd_ok;
+    uint32_t swd_wait;
+    uint32_t swd_fault;
+    uint32_t swd_no_ack; // requests the target did not answer
+    uint32_t jtag_scans; // DPACC/APACC/ABORT scans that reached Update-DR
+    uint32_t jtag_wait;
+    uint32_t protocol_errors; // bad header or write parity, undriven write data
+    uint32_t contention; // cycles in which both sides drove SWDIO
+    uint32_t bus_errors; // MEM-AP accesses outside the memory map or writes to flash
+    uint64_t bytes_read;
+    uint64_t bytes_written;
+} DapTargetStats;
+
+// Resets the target to its power-on state: JTAG selected, debug domain off and
+// memory filled with its initial pattern. Every wait_interval-th AP access is
+// answered with WAIT a couple of times before it goes through, 0 disables that.
+void dap_target_init(uint32_t wait_interval);
+
+const DapTargetStats* dap_target_stats(void);
+
+// Target memory at address, NULL if the size bytes from there are not all mapped
+uint8_t* dap_target_memory(uint32_t address, uint32_t size);
+
+// Pins, as seen from the debugger
+void dap_target_swclk_write(int value);
+int dap_target_swclk_read(void);
+void dap_target_swdio_write(int value);
+int dap_target_swdio_read(void);
+void dap_target_swdio_output(bool output);
+void dap_target_tdi_write(int value);
+int dap_target_tdi_read(void);
+int dap_target_tdo_read(void);
+void dap_target_nreset_write(int value);
+int dap_target_nreset_read(void);
@@ -0,0 +1,201 @@
+#ifndef _DAP_CONFIG_H_
+#define _DAP_CONFIG_H_
+
+// Host build of free-dap for dap_bench: the pins are wired to the simulated
+// target in dap_target.c instead of the GPIO registers of the Flipper
+
+/*- Includes ----------------------------------------------------------------*/
+#include <stdbool.h>
+#include <stdint.h>
+#include "dap_target.h"
+
+/*- Definitions -------------------------------------------------------------*/
+#define DAP_CONFIG_ENABLE_JTAG
+
+#define DAP_CONFIG_DEFAULT_PORT DAP_PORT_SWD
+#define DAP_CONFIG_DEFAULT_CLOCK 4200000 // Hz
+
+#define DAP_CONFIG_PACKET_SIZE 64
+#define DAP_CONFIG_PACKET_COUNT 4
+
+#define DAP_CONFIG_JTAG_DEV_COUNT 8
+
+#define DAP_CONFIG_VENDOR_STR "Flipper Zero"
+#define DAP_CONFIG_PRODUCT_STR "Generic CMSIS-DAP Adapter"
+#define DAP_CONFIG_SER_NUM_STR "host"
+#define DAP_CONFIG_CMSIS_DAP_VER_STR "2.0.0"
+
+#define DAP_CONFIG_PERFORMANCE_ATTR
+
+// Same constants as the device, the delays themselves are not simulated
+#define DAP_CONFIG_DELAY_CONSTANT 6290
+#define DAP_CONFIG_FAST_CLOCK 2400000 // Hz
+
+// Commands are profiled in SWCLK/TCK cycles of the simulated target, see dap_bench -p
+#define DAP_CONFIG_ENABLE_PROFILE
+#define DAP_CONFIG_PROFILE_COUNTER() ((uint32_t)dap_target_stats()->cycles)
+
+// make DEFINES=-DDAP_HOST_SWD_ENGINE runs DAP_TransferBlock through the engine
+// path of dap.c, with the engine clocking the simulated pins bit by bit
+#ifdef DAP_HOST_SWD_ENGINE
+#define DAP_CONFIG_SWD_ENGINE
+#define DAP_CONFIG_SWD_ENGINE_START dap_host_engine_start
+#define DAP_CONFIG_SWD_ENGINE_STOP dap_host_engine_stop
+#define DAP_CONFIG_SWD_ENGINE_WRITE dap_host_engine_write
+#define DAP_CONFIG_SWD_ENGINE_READ dap_host_engine_read
+#endif
+
+/*- Implementations ---------------------------------------------------------*/
+
+//-----------------------------------------------------------------------------
+static inline void DAP_CONFIG_SWCLK_TCK_write(int value) {
+    dap_target_swclk_write(value);
+}
+
+//-----------------------------------------------------------------------------
+static inline void DAP_CONFIG_SWDIO_TMS_write(int value) {
+    dap_target_swdio_write(value);
+}
+
+//-----------------------------------------------------------------------------
+static inline void DAP_CONFIG_TDI_write(int value) {
+    dap_target_tdi_write(value);
+}
+
+//-----------------------------------------------------------------------------
+static inline void DAP_CONFIG_TDO_write(int value) {
+    (void)value;
+}
+
+//-----------------------------------------------------------------------------
+static inline void DAP_CONFIG_nTRST_write(int value) {
+    (void)value;
+}
+
+//-----------------------------------------------------------------------------
+static inline void DAP_CONFIG_nRESET_write(int value) {
+    dap_target_nreset_write(value);
+}
+
+//-----------------------------------------------------------------------------
+static inline int DAP_CONFIG_SWCLK_TCK_read(void) {
+    return dap_target_swclk_read();
+}
+
+//-----------------------------------------------------------------------------
+static inline int DAP_CONFIG_SWDIO_TMS_read(void) {
+    return dap_target_swdio_read();
+}
+
+//-----------------------------------------------------------------------------
+static inline int DAP_CONFIG_TDO_read(void) {
+    return dap_target_tdo_read();
+}
+
+//-----------------------------------------------------------------------------
+static inline int DAP_CONFIG_TDI_read(void) {
+    return dap_target_tdi_read();
+}
+
+//-----------------------------------------------------------------------------
+static inline int DAP_CONFIG_nTRST_read(void) {
+    return 0;
+}
+
+//-----------------------------------------------------------------------------
+static inline int DAP_CONFIG_nRESET_read(void) {
+    return dap_target_nreset_read();
+}
+
+//-----------------------------------------------------------------------------
+static inline void DAP_CONFIG_SWCLK_TCK_set(void) {
+    dap_target_swclk_write(1);
+}
+
+//-----------------------------------------------------------------------------
+static inline void DAP_CONFIG_SWCLK_TCK_clr(void) {
+    dap_target_swclk_write(0);
+}
+
+//-----------------------------------------------------------------------------
+static inline void DAP_CONFIG_SWDIO_TMS_in(void) {
+    dap_target_swdio_output(false);
+}
+
+//-----------------------------------------------------------------------------
+static inline void DAP_CONFIG_SWDIO_TMS_out(void) {
+    dap_target_swdio_output(true);
+}
+
+//-----------------------------------------------------------------------------
+static inline void DAP_CONFIG_SETUP(void) {
+    dap_target_swdio_output(false);
+}
+
+//-----------------------------------------------------------------------------
+static inline void DAP_CONFIG_DISCONNECT(void) {
+    dap_target_swdio_output(false);
+}
+
+//-----------------------------------------------------------------------------
+static inline void DAP_CONFIG_CONNECT_SWD(void) {
+    dap_target_swdio_output(true);
+    dap_target_swdio_write(1);
+    dap_target_swclk_write(1);
+    dap_target_nreset_write(1);
+}
+
+//-----------------------------------------------------------------------------
+static inline void DAP_CONFIG_CONNECT_JTAG(void) {
+    dap_target_swdio_output(true);
+    dap_target_swdio_write(1);
+    dap_target_swclk_write(1);
+    dap_target_nreset_write(1);
+    dap_target_tdi_write(1);
+}
+
+//-----------------------------------------------------------------------------
+static inline void DAP_CONFIG_LED(int index, int state) {
+    (void)index;
+    (void)state;
+}
+
+//-----------------------------------------------------------------------------
+static inline void DAP_CONFIG_DELAY(uint32_t cycles) {
+    (void)cycles;
+}
+
+#ifdef DAP_HOST_SWD_ENGINE
+//-----------------------------------------------------------------------------
+static inline bool dap_host_engine_start(uint32_t clock) {
+    (void)clock;
+    return true;
+}
+
+//-----------------------------------------------------------------------------
+static inline void dap_host_engine_stop(void) {
+}
+
+//-----------------------------------------------------------------------------
+static inline void dap_host_engine_write(uint64_t value, int size) {
+    for(int i = 0; i < size; i++) {
+        dap_target_swdio_write(value & 1);
+        dap_target_swclk_write(0);
+        dap_target_swclk_write(1);
+        value >>= 1;
+    }
+}
+
+//-----------------------------------------------------------------------------
+static inline uint64_t dap_host_engine_read(int size) {
+    uint64_t value = 0;
+    for(int i = 0; i < size; i++) {
+        dap_target_swclk_write(0);
+        value |= (uint64_t)dap_target_swdio_read() << i;
+        dap_target_swclk_write(1);
+    }
+    return value;
+}
+#endif
+
+#endif // _DAP_CONFIG_H_
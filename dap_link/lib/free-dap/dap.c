@@ -36,6 +36,10 @@
 /*- Definitions -------------------------------------------------------------*/
 #define ARRAY_SIZE(x)  ((int)(sizeof(x) / sizeof(0[x])))
 
+#define DAP_CLOCK_TABLE_SIZE      16
+#define DAP_CLOCK_TEST_BITS       32
+#define DAP_CLOCK_TEST_RUNS       3
+
 enum
 {
   ID_DAP_INFO               = 0x00,
@@ -120,6 +124,7 @@ enum
   DAP_TRANSFER_A3           = 1 << 3,
   DAP_TRANSFER_MATCH_VALUE  = 1 << 4,
   DAP_TRANSFER_MATCH_MASK   = 1 << 5,
+  DAP_TRANSFER_TIMESTAMP    = 1 << 7,
   DAP_TRANSFER_JTAG_ABORT   = 1 << 16,
 };
 
@@ -157,6 +162,40 @@ enum
   DAP_ERROR                 = 0xff,
 };
 
+enum
+{
+  DAP_SWO_TRANSPORT_NONE    = 0,
+  DAP_SWO_TRANSPORT_DATA    = 1,
+  DAP_SWO_TRANSPORT_EP      = 2,
+};
+
+enum
+{
+  DAP_SWO_MODE_OFF          = 0,
+  DAP_SWO_MODE_UART         = 1,
+  DAP_SWO_MODE_MANCHESTER   = 2,
+};
+
+enum
+{
+  DAP_SWO_CONTROL_STOP      = 0,
+  DAP_SWO_CONTROL_START     = 1,
+};
+
+enum
+{
+  DAP_SWO_STATUS_ACTIVE     = 1 << 0,
+  DAP_SWO_STATUS_ERROR      = 1 << 6,
+  DAP_SWO_STATUS_OVERRUN    = 1 << 7,
+};
+
+enum
+{
+  DAP_SWO_EXT_STATUS        = 1 << 0,
+  DAP_SWO_EXT_COUNT         = 1 << 1,
+  DAP_SWO_EXT_INDEX         = 1 << 2,
+};
+
 enum
 {
   SWD_DP_R_IDCODE           = 0x00,
@@ -233,6 +272,14 @@ static int dap_idle_cycles;
 static int dap_retry_count;
 static int dap_match_retry_count;
 static int dap_clock_delay;
+static bool dap_clock_fast;
+static int dap_clock_freq;
+
+#ifdef DAP_CONFIG_CYCLE_COUNTER
+// CPU cycles taken by dap_swd_write() to send DAP_CLOCK_TEST_BITS bits with
+// dap_clock_delay = index, index 0 is the fast version without delays
+static uint32_t dap_clock_cycles[DAP_CLOCK_TABLE_SIZE];
+#endif
 
 static void (*dap_swj_run)(int);
 static void (*dap_swd_write)(uint32_t, int);
@@ -257,6 +304,23 @@ static bool dap_buf_error;
 static int dap_swd_turnaround;
 static bool dap_swd_data_phase;
 
+#ifdef DAP_CONFIG_SWD_ENGINE
+static bool dap_swd_engine_active;
+#endif
+
+#ifdef DAP_CONFIG_ENABLE_SWO
+static int dap_swo_transport;
+static int dap_swo_mode;
+static uint32_t dap_swo_baudrate;
+static bool dap_swo_active;
+static int dap_swo_errors;
+#endif
+
+#ifdef DAP_CONFIG_ENABLE_PROFILE
+static dap_profile_t dap_profile[DAP_PROFILE_SIZE];
+static dap_profile_t *dap_profile_cmd; // Command being executed, NULL if not profiled
+#endif
+
 #ifdef DAP_CONFIG_ENABLE_JTAG
 static int dap_jtag_dev_count;
 static int dap_jtag_dev_index;
@@ -342,62 +406,165 @@ static inline uint32_t dap_parity(uint32_t value)
   return (0x6996 >> value) & 1;
 }
 
+//-----------------------------------------------------------------------------
+// The bit loops are called directly, so that the compiler can inline and
+// unroll them into the request, ACK and data phases
+#define DAP_SWD_OPERATION_FN(ver) \
+  DAP_CONFIG_PERFORMANCE_ATTR						\
+  static inline int dap_swd_operation_##ver(int req, uint32_t *data)	\
+  {									\
+    uint32_t value;							\
+    int ack = 0;							\
+									\
+    req &= (DAP_TRANSFER_APnDP | DAP_TRANSFER_RnW |			\
+        DAP_TRANSFER_A2 | DAP_TRANSFER_A3);				\
+									\
+    dap_swd_write_##ver(0x81 | (dap_parity(req) << 5) | (req << 1), 8);	\
+									\
+    DAP_CONFIG_SWDIO_TMS_in();						\
+									\
+    dap_swj_run_##ver(dap_swd_turnaround);				\
+									\
+    ack = dap_swd_read_##ver(3);					\
+									\
+    if (DAP_TRANSFER_OK == ack)						\
+    {									\
+      if (req & DAP_TRANSFER_RnW)					\
+      {									\
+        value = dap_swd_read_##ver(32);					\
+									\
+        if (dap_parity(value) != dap_swd_read_##ver(1))			\
+          ack = DAP_TRANSFER_ERROR;					\
+									\
+        if (data)							\
+          *data = value;						\
+									\
+        dap_swj_run_##ver(dap_swd_turnaround);				\
+									\
+        DAP_CONFIG_SWDIO_TMS_out();					\
+      }									\
+      else								\
+      {									\
+        dap_swj_run_##ver(dap_swd_turnaround);				\
+									\
+        DAP_CONFIG_SWDIO_TMS_out();					\
+									\
+        dap_swd_write_##ver(*data, 32);					\
+        dap_swd_write_##ver(dap_parity(*data), 1);			\
+      }									\
+									\
+      DAP_CONFIG_SWDIO_TMS_write(0);					\
+      dap_swj_run_##ver(dap_idle_cycles);				\
+    }									\
+									\
+    else if (DAP_TRANSFER_WAIT == ack || DAP_TRANSFER_FAULT == ack)	\
+    {									\
+      if (dap_swd_data_phase && (req & DAP_TRANSFER_RnW))		\
+        dap_swj_run_##ver(32 + 1);					\
+									\
+      dap_swj_run_##ver(dap_swd_turnaround);				\
+									\
+      DAP_CONFIG_SWDIO_TMS_out();					\
+									\
+      if (dap_swd_data_phase && (0 == (req & DAP_TRANSFER_RnW)))	\
+      {									\
+        DAP_CONFIG_SWDIO_TMS_write(0);					\
+        dap_swj_run_##ver(32 + 1);					\
+      }									\
+    }									\
+									\
+    else								\
+    {									\
+      dap_swj_run_##ver(dap_swd_turnaround + 32 + 1);			\
+    }									\
+									\
+    DAP_CONFIG_SWDIO_TMS_write(1);					\
+									\
+    return ack;								\
+  }
+
+DAP_SWD_OPERATION_FN(slow)
+DAP_SWD_OPERATION_FN(fast)
+
+#ifdef DAP_CONFIG_SWD_ENGINE
+//-----------------------------------------------------------------------------
+static int dap_swd_engine_operation(int req, uint32_t *data);
+#endif
+
 //-----------------------------------------------------------------------------
 static int dap_swd_operation(int req, uint32_t *data)
 {
-  uint32_t value;
-  int ack = 0;
+#ifdef DAP_CONFIG_SWD_ENGINE
+  if (dap_swd_engine_active)
+    return dap_swd_engine_operation(req, data);
+#endif
+
+  if (dap_clock_fast)
+    return dap_swd_operation_fast(req, data);
+
+  return dap_swd_operation_slow(req, data);
+}
+
+#ifdef DAP_CONFIG_SWD_ENGINE
+//-----------------------------------------------------------------------------
+// Same sequence as dap_swd_operation(), but each part between two direction
+// changes or decisions is clocked by the engine in one go. WAIT and FAULT
+// responses are finished with the CPU functions.
+static int dap_swd_engine_operation(int req, uint32_t *data)
+{
+  uint64_t value;
+  int ack;
+  bool read;
 
   req &= (DAP_TRANSFER_APnDP | DAP_TRANSFER_RnW | DAP_TRANSFER_A2 | DAP_TRANSFER_A3);
+  read = (req & DAP_TRANSFER_RnW) != 0;
 
-  dap_swd_write(0x81 | (dap_parity(req) << 5) | (req << 1), 8);
+  DAP_CONFIG_SWD_ENGINE_WRITE(0x81 | (dap_parity(req) << 5) | (req << 1), 8);
 
   DAP_CONFIG_SWDIO_TMS_in();
 
-  dap_swj_run(dap_swd_turnaround);
-
-  ack = dap_swd_read(3);
+  // A write turns the line around right after the ACK, whatever it is
+  value = DAP_CONFIG_SWD_ENGINE_READ(dap_swd_turnaround + 3 + (read ? 0 : dap_swd_turnaround));
+  ack = (value >> dap_swd_turnaround) & 7;
 
   if (DAP_TRANSFER_OK == ack)
   {
-    if (req & DAP_TRANSFER_RnW)
+    if (read)
     {
-      value = dap_swd_read(32);
+      value = DAP_CONFIG_SWD_ENGINE_READ(32 + 1 + dap_swd_turnaround);
 
-      if (dap_parity(value) != dap_swd_read(1))
+      if (dap_parity((uint32_t)value) != ((value >> 32) & 1))
         ack = DAP_TRANSFER_ERROR;
 
       if (data)
-        *data = value;
-
-      dap_swj_run(dap_swd_turnaround);
+        *data = (uint32_t)value;
 
       DAP_CONFIG_SWDIO_TMS_out();
+
+      DAP_CONFIG_SWD_ENGINE_WRITE(0, dap_idle_cycles);
     }
     else
     {
-      dap_swj_run(dap_swd_turnaround);
-
       DAP_CONFIG_SWDIO_TMS_out();
 
-      dap_swd_write(*data, 32);
-      dap_swd_write(dap_parity(*data), 1);
+      DAP_CONFIG_SWD_ENGINE_WRITE(*data | ((uint64_t)dap_parity(*data) << 32),
+          32 + 1 + dap_idle_cycles);
     }
-
-    DAP_CONFIG_SWDIO_TMS_write(0);
-    dap_swj_run(dap_idle_cycles);
   }
 
   else if (DAP_TRANSFER_WAIT == ack || DAP_TRANSFER_FAULT == ack)
   {
-    if (dap_swd_data_phase && (req & DAP_TRANSFER_RnW))
-      dap_swj_run(32 + 1);
+    if (read)
+    {
+      if (dap_swd_data_phase)
+        dap_swj_run(32 + 1);
 
-    dap_swj_run(dap_swd_turnaround);
+      dap_swj_run(dap_swd_turnaround);
+    }
 
     DAP_CONFIG_SWDIO_TMS_out();
 
-    if (dap_swd_data_phase && (0 == (req & DAP_TRANSFER_RnW)))
+    if (dap_swd_data_phase && !read)
     {
       DAP_CONFIG_SWDIO_TMS_write(0);
       dap_swj_run(32 + 1);
@@ -406,13 +573,14 @@ static int dap_swd_operation(int req, uint32_t *data)
 
   else
   {
-    dap_swj_run(dap_swd_turnaround + 32 + 1);
+    dap_swj_run((read ? dap_swd_turnaround : 0) + 32 + 1);
   }
 
   DAP_CONFIG_SWDIO_TMS_write(1);
 
   return ack;
 }
+#endif // DAP_CONFIG_SWD_ENGINE
 
 #ifdef DAP_CONFIG_ENABLE_JTAG
 //-----------------------------------------------------------------------------
@@ -598,12 +766,81 @@ static int dap_jtag_operation(int req, uint32_t *data)
 }
 #endif // DAP_CONFIG_ENABLE_JTAG
 
+#ifdef DAP_CONFIG_CYCLE_COUNTER
+//-----------------------------------------------------------------------------
+static uint32_t dap_clock_measure(void (*swd_write)(uint32_t, int), int delay)
+{
+  uint32_t best = UINT32_MAX;
+
+  dap_clock_delay = delay;
+
+  // The shortest run is the one without interrupts
+  for (int i = 0; i < DAP_CLOCK_TEST_RUNS; i++)
+  {
+    uint32_t start = DAP_CONFIG_CYCLE_COUNTER();
+    swd_write(0, DAP_CLOCK_TEST_BITS);
+    uint32_t cycles = DAP_CONFIG_CYCLE_COUNTER() - start;
+
+    if (cycles < best)
+      best = cycles;
+  }
+
+  return best;
+}
+
+//-----------------------------------------------------------------------------
+static void dap_clock_calibrate(void)
+{
+  dap_clock_cycles[0] = dap_clock_measure(dap_swd_write_fast, 0);
+
+  for (int i = 1; i < DAP_CLOCK_TABLE_SIZE; i++)
+    dap_clock_cycles[i] = dap_clock_measure(dap_swd_write_slow, i);
+}
+
+//-----------------------------------------------------------------------------
+static int dap_clock_lookup(int freq)
+{
+  uint64_t target;
+  uint32_t first, step;
+
+  if (freq < 1)
+    freq = 1;
+
+  // Fastest delay that does not exceed the requested frequency
+  target = ((uint64_t)DAP_CONFIG_CPU_FREQ * DAP_CLOCK_TEST_BITS + freq - 1) / freq;
+
+  for (int i = 0; i < DAP_CLOCK_TABLE_SIZE; i++)
+  {
+    if (dap_clock_cycles[i] >= target)
+      return i;
+  }
+
+  // Slower than the table, the period grows linearly with the delay
+  first = dap_clock_cycles[1];
+  step  = (dap_clock_cycles[DAP_CLOCK_TABLE_SIZE-1] - first) / (DAP_CLOCK_TABLE_SIZE - 2);
+
+  if (0 == step)
+    step = 1;
+
+  return 1 + (target - first + step - 1) / step;
+}
+#endif // DAP_CONFIG_CYCLE_COUNTER
+
 //-----------------------------------------------------------------------------
 static void dap_setup_clock(int freq)
 {
+  dap_clock_freq = freq;
+
+#ifdef DAP_CONFIG_CYCLE_COUNTER
+  int delay = dap_clock_lookup(freq);
+
+  if (0 == delay)
+#else
   if (freq > DAP_CONFIG_FAST_CLOCK)
+#endif
   {
     dap_clock_delay = 0;
+    dap_clock_fast  = true;
     dap_swj_run     = dap_swj_run_fast;
     dap_swd_write   = dap_swd_write_fast;
     dap_swd_read    = dap_swd_read_fast;
@@ -615,7 +852,12 @@ static void dap_setup_clock(int freq)
   }
   else
   {
+#ifdef DAP_CONFIG_CYCLE_COUNTER
+    dap_clock_delay = delay;
+#else
     dap_clock_delay = (DAP_CONFIG_DELAY_CONSTANT * 1000) / freq;
+#endif
+    dap_clock_fast  = false;
     dap_swj_run     = dap_swj_run_slow;
     dap_swd_write   = dap_swd_write_slow;
     dap_swd_read    = dap_swd_read_slow;
@@ -649,6 +891,22 @@ static bool dap_select_device(int index)
   return false;
 }
 
+//-----------------------------------------------------------------------------
+static inline void dap_profile_ack(int ack)
+{
+#ifdef DAP_CONFIG_ENABLE_PROFILE
+  if (dap_profile_cmd)
+  {
+    if (DAP_TRANSFER_WAIT == ack)
+      dap_profile_cmd->wait++;
+    else if (DAP_TRANSFER_FAULT == ack)
+      dap_profile_cmd->fault++;
+  }
+#else
+  (void)ack;
+#endif
+}
+
 //-----------------------------------------------------------------------------
 static int dap_transfer_word(int req, uint32_t *data)
 {
@@ -664,6 +922,29 @@ static int dap_transfer_word(int req, uint32_t *data)
       ack = dap_jtag_operation(req, data);
 #endif
 
+    dap_profile_ack(ack);
+
+    if (DAP_TRANSFER_WAIT != ack || dap_abort)
+      break;
+  }
+
+  return ack;
+}
+
+//-----------------------------------------------------------------------------
+// dap_transfer_word() for SWD at the fast clock, without the port, engine and
+// clock checks
+DAP_CONFIG_PERFORMANCE_ATTR
+static inline int dap_swd_transfer_word_fast(int req, uint32_t *data)
+{
+  int ack = DAP_TRANSFER_INVALID;
+
+  for (int i = 0; i < dap_retry_count; i++)
+  {
+    ack = dap_swd_operation_fast(req, data);
+
+    dap_profile_ack(ack);
+
     if (DAP_TRANSFER_WAIT != ack || dap_abort)
       break;
   }
@@ -798,9 +1079,12 @@ static void dap_info(void)
 
   if (DAP_INFO_CAPABILITIES == index)
   {
-    int cap = DAP_CAP_SWD;
+    int cap = DAP_CAP_SWD | DAP_CAP_ATOMIC_CMD;
 #ifdef DAP_CONFIG_ENABLE_JTAG
     cap |= DAP_CAP_JTAG;
+#endif
+#ifdef DAP_CONFIG_ENABLE_SWO
+    cap |= DAP_CAP_SWO_UART | DAP_CAP_SWO_STREAMING;
 #endif
     dap_resp_add_byte(1);
     dap_resp_add_byte(cap);
@@ -810,6 +1094,13 @@ static void dap_info(void)
     dap_resp_add_byte(1);
     dap_resp_add_byte(DAP_CONFIG_PACKET_COUNT);
   }
+#ifdef DAP_CONFIG_ENABLE_SWO
+  else if (DAP_INFO_SWO_BUF_SIZE == index)
+  {
+    dap_resp_add_byte(4);
+    dap_resp_add_word(DAP_CONFIG_SWO_BUFFER_SIZE);
+  }
+#endif
   else if (DAP_INFO_PACKET_SIZE == index)
   {
     dap_resp_add_byte(2);
@@ -896,6 +1187,128 @@ static void dap_transfer_configure(void)
   dap_resp_add_byte(DAP_OK);
 }
 
+//-----------------------------------------------------------------------------
+// Memory accesses over SWD at the fast clock, no value matching and no
+// timestamps, take dap_transfer_fast(). Truncated requests are left to the
+// generic loop, so the fast path never runs out of request data.
+static bool dap_transfer_is_fast(int req_count)
+{
+  int ptr = dap_req_ptr;
+
+  if (DAP_PORT_SWD != dap_port || !dap_clock_fast)
+    return false;
+
+  for (int i = 0; i < req_count; i++)
+  {
+    int request;
+
+    if (ptr >= dap_req_size)
+      return false;
+
+    request = dap_req_buf[ptr++];
+
+    if (request & (DAP_TRANSFER_MATCH_VALUE | DAP_TRANSFER_MATCH_MASK | DAP_TRANSFER_TIMESTAMP))
+      return false;
+
+    if (0 == (request & DAP_TRANSFER_RnW))
+      ptr += sizeof(uint32_t);
+  }
+
+  return ptr <= dap_req_size;
+}
+
+//-----------------------------------------------------------------------------
+// Same as the generic loop in dap_transfer() without the match handling. On
+// SWD only AP reads are posted.
+DAP_CONFIG_PERFORMANCE_ATTR
+static void dap_transfer_fast(int req_count)
+{
+  int resp_count, request, ack;
+  bool posted_read, verify_write;
+  uint32_t data;
+
+  resp_count = 0;
+  posted_read = false;
+  verify_write = false;
+  ack = DAP_TRANSFER_INVALID;
+
+  for (; req_count && !dap_abort && !dap_buf_error; req_count--, resp_count++)
+  {
+    request = dap_req_get_byte();
+    verify_write = false;
+
+    if (posted_read)
+    {
+      if ((request & DAP_TRANSFER_RnW) && (request & DAP_TRANSFER_APnDP))
+      {
+        ack = dap_swd_transfer_word_fast(request, &data);
+      }
+      else
+      {
+        ack = dap_swd_transfer_word_fast(SWD_DP_R_RDBUFF | DAP_TRANSFER_RnW, &data);
+        posted_read = false;
+      }
+
+      if (ack != DAP_TRANSFER_OK)
+        break;
+
+      dap_resp_add_word(data);
+
+      if (posted_read)
+        continue;
+    }
+
+    if (request & DAP_TRANSFER_RnW)
+    {
+      if (request & DAP_TRANSFER_APnDP)
+      {
+        ack = dap_swd_transfer_word_fast(request, NULL);
+
+        if (ack != DAP_TRANSFER_OK)
+          break;
+
+        posted_read = true;
+      }
+      else
+      {
+        ack = dap_swd_transfer_word_fast(request, &data);
+
+        if (DAP_TRANSFER_OK != ack)
+          break;
+
+        dap_resp_add_word(data);
+      }
+    }
+    else // Write
+    {
+      data = dap_req_get_word();
+
+      ack = dap_swd_transfer_word_fast(request, &data);
+
+      if (ack != DAP_TRANSFER_OK)
+        break;
+
+      verify_write = true;
+    }
+  }
+
+  if (DAP_TRANSFER_OK == ack)
+  {
+    if (posted_read)
+    {
+      ack = dap_swd_transfer_word_fast(SWD_DP_R_RDBUFF | DAP_TRANSFER_RnW, &data);
+      dap_resp_add_word(data);
+    }
+    else if (verify_write)
+    {
+      ack = dap_swd_transfer_word_fast(SWD_DP_R_RDBUFF | DAP_TRANSFER_RnW, NULL);
+    }
+  }
+
+  dap_resp_set_byte(1, resp_count);
+  dap_resp_set_byte(2, ack);
+}
+
 //-----------------------------------------------------------------------------
 static void dap_transfer(void)
 {
@@ -912,6 +1325,12 @@ static void dap_transfer(void)
   req_count  = dap_req_get_byte();
   resp_count = 0;
 
+  if (dap_transfer_is_fast(req_count))
+  {
+    dap_transfer_fast(req_count);
+    return;
+  }
+
   posted_read = false;
   verify_write = false;
   ack = DAP_TRANSFER_INVALID;
@@ -1022,6 +1441,80 @@ static void dap_transfer(void)
   dap_resp_set_byte(2, ack);
 }
 
+//-----------------------------------------------------------------------------
+static bool dap_transfer_block_is_fast(int request)
+{
+#ifdef DAP_CONFIG_SWD_ENGINE
+  if (dap_swd_engine_active)
+    return false;
+#endif
+
+  return DAP_PORT_SWD == dap_port && dap_clock_fast &&
+      0 == (request & (DAP_TRANSFER_MATCH_VALUE | DAP_TRANSFER_MATCH_MASK | DAP_TRANSFER_TIMESTAMP));
+}
+
+//-----------------------------------------------------------------------------
+// The loops of dap_transfer_block() for SWD at the fast clock, returns the ACK
+// of the last transfer
+DAP_CONFIG_PERFORMANCE_ATTR
+static int dap_transfer_block_fast(int request, int req_count, int *resp_count)
+{
+  int ack = DAP_TRANSFER_INVALID;
+  uint32_t data;
+
+  if ((request & DAP_TRANSFER_RnW) && (request & DAP_TRANSFER_APnDP))
+  {
+    // Every AP read returns the previous value, RDBUFF the last one
+    ack = dap_swd_transfer_word_fast(request, NULL);
+
+    for (int i = 1; i <= req_count && DAP_TRANSFER_OK == ack; i++)
+    {
+      if (i == req_count)
+        request = SWD_DP_R_RDBUFF | DAP_TRANSFER_RnW;
+
+      ack = dap_swd_transfer_word_fast(request, &data);
+
+      if (DAP_TRANSFER_OK != ack)
+        break;
+
+      dap_resp_add_word(data);
+      (*resp_count)++;
+    }
+  }
+  else if (request & DAP_TRANSFER_RnW)
+  {
+    for (int i = 0; i < req_count; i++)
+    {
+      ack = dap_swd_transfer_word_fast(request, &data);
+
+      if (DAP_TRANSFER_OK != ack)
+        break;
+
+      dap_resp_add_word(data);
+      (*resp_count)++;
+    }
+  }
+  else // Write
+  {
+    for (int i = 0; i < req_count; i++)
+    {
+      data = dap_req_get_word();
+
+      ack = dap_swd_transfer_word_fast(request, &data);
+
+      if (DAP_TRANSFER_OK != ack)
+        break;
+
+      (*resp_count)++;
+    }
+
+    if (DAP_TRANSFER_OK == ack)
+      ack = dap_swd_transfer_word_fast(SWD_DP_R_RDBUFF | DAP_TRANSFER_RnW, NULL);
+  }
+
+  return ack;
+}
+
 //-----------------------------------------------------------------------------
 static void dap_transfer_block(void)
 {
@@ -1044,7 +1537,16 @@ static void dap_transfer_block(void)
   request = dap_req_get_byte();
   ack = DAP_TRANSFER_INVALID;
 
-  if (request & DAP_TRANSFER_RnW)
+#ifdef DAP_CONFIG_SWD_ENGINE
+  dap_swd_engine_active = (DAP_PORT_SWD == dap_port) &&
+      DAP_CONFIG_SWD_ENGINE_START(dap_clock_freq);
+#endif
+
+  if (dap_transfer_block_is_fast(request))
+  {
+    ack = dap_transfer_block_fast(request, req_count, &resp_count);
+  }
+  else if (request & DAP_TRANSFER_RnW)
   {
     bool needs_posted = dap_needs_posted_read(request);
     int transfers = needs_posted ? (req_count + 1) : req_count;
@@ -1084,6 +1586,14 @@ static void dap_transfer_block(void)
       ack = dap_transfer_word(SWD_DP_R_RDBUFF | DAP_TRANSFER_RnW, NULL);
   }
 
+#ifdef DAP_CONFIG_SWD_ENGINE
+  if (dap_swd_engine_active)
+  {
+    DAP_CONFIG_SWD_ENGINE_STOP();
+    dap_swd_engine_active = false;
+  }
+#endif
+
   dap_resp_set_byte(1, resp_count);
   dap_resp_set_byte(2, resp_count >> 8);
   dap_resp_set_byte(3, ack);
@@ -1389,6 +1899,145 @@ static void dap_jtag_idcode(void)
 #endif
 }
 
+#ifdef DAP_CONFIG_ENABLE_SWO
+//-----------------------------------------------------------------------------
+static int dap_swo_status_byte(void)
+{
+  dap_swo_errors |= DAP_CONFIG_SWO_ERRORS();
+
+  return (dap_swo_active ? DAP_SWO_STATUS_ACTIVE : 0) |
+      (dap_swo_errors & (DAP_SWO_STATUS_ERROR | DAP_SWO_STATUS_OVERRUN));
+}
+
+//-----------------------------------------------------------------------------
+static void dap_swo_transport_cmd(void)
+{
+  int transport = dap_req_get_byte();
+
+  if (dap_swo_active || transport > DAP_SWO_TRANSPORT_EP)
+  {
+    dap_resp_add_byte(DAP_ERROR);
+    return;
+  }
+
+  dap_swo_transport = transport;
+  dap_resp_add_byte(DAP_OK);
+}
+
+//-----------------------------------------------------------------------------
+static void dap_swo_mode_cmd(void)
+{
+  int mode = dap_req_get_byte();
+
+  if (dap_swo_active || (DAP_SWO_MODE_OFF != mode && DAP_SWO_MODE_UART != mode))
+  {
+    dap_resp_add_byte(DAP_ERROR);
+    return;
+  }
+
+  dap_swo_mode = mode;
+  dap_resp_add_byte(DAP_OK);
+}
+
+//-----------------------------------------------------------------------------
+static void dap_swo_baudrate_cmd(void)
+{
+  uint32_t baudrate = dap_req_get_word();
+
+  if (dap_swo_active)
+  {
+    dap_resp_add_word(0);
+    return;
+  }
+
+  dap_swo_baudrate = DAP_CONFIG_SWO_BAUDRATE(baudrate);
+  dap_resp_add_word(dap_swo_baudrate);
+}
+
+//-----------------------------------------------------------------------------
+static void dap_swo_control_cmd(void)
+{
+  int control = dap_req_get_byte();
+
+  if (DAP_SWO_CONTROL_START == control && !dap_swo_active)
+  {
+    if (DAP_SWO_MODE_UART != dap_swo_mode || DAP_SWO_TRANSPORT_NONE == dap_swo_transport ||
+        0 == dap_swo_baudrate ||
+        !DAP_CONFIG_SWO_START(dap_swo_baudrate, DAP_SWO_TRANSPORT_EP == dap_swo_transport))
+    {
+      dap_resp_add_byte(DAP_ERROR);
+      return;
+    }
+
+    DAP_CONFIG_SWO_ERRORS();
+    dap_swo_errors = 0;
+    dap_swo_active = true;
+  }
+  else if (DAP_SWO_CONTROL_STOP == control && dap_swo_active)
+  {
+    DAP_CONFIG_SWO_STOP();
+    dap_swo_active = false;
+  }
+
+  dap_resp_add_byte(DAP_OK);
+}
+
+//-----------------------------------------------------------------------------
+static void dap_swo_status_cmd(void)
+{
+  dap_resp_add_byte(dap_swo_status_byte());
+  dap_resp_add_word(DAP_CONFIG_SWO_COUNT());
+  dap_swo_errors = 0;
+}
+
+//-----------------------------------------------------------------------------
+static void dap_swo_ext_status_cmd(void)
+{
+  int control = dap_req_get_byte();
+
+  if (control & DAP_SWO_EXT_STATUS)
+  {
+    dap_resp_add_byte(dap_swo_status_byte());
+    dap_swo_errors = 0;
+  }
+
+  if (control & DAP_SWO_EXT_COUNT)
+    dap_resp_add_word(DAP_CONFIG_SWO_COUNT());
+
+  if (control & DAP_SWO_EXT_INDEX)
+  {
+    dap_resp_add_word(0); // No timestamps
+    dap_resp_add_word(0);
+  }
+}
+
+//-----------------------------------------------------------------------------
+static void dap_swo_data_cmd(void)
+{
+  int max_count = dap_req_get_half();
+  int count = 0;
+
+  dap_resp_add_byte(dap_swo_status_byte());
+  dap_resp_add_byte(0); // Count
+  dap_resp_add_byte(0); // Count
+  dap_swo_errors = 0;
+
+  if (dap_buf_error)
+    return;
+
+  if (max_count > dap_resp_size - dap_resp_ptr)
+    max_count = dap_resp_size - dap_resp_ptr;
+
+  if (DAP_SWO_TRANSPORT_DATA == dap_swo_transport && max_count > 0)
+    count = DAP_CONFIG_SWO_READ(&dap_resp_buf[dap_resp_ptr], max_count);
+
+  dap_resp_ptr += count;
+
+  dap_resp_set_byte(2, count);
+  dap_resp_set_byte(3, count >> 8);
+}
+#endif // DAP_CONFIG_ENABLE_SWO
+
 //-----------------------------------------------------------------------------
 void dap_init(void)
 {
@@ -1403,10 +2052,22 @@ void dap_init(void)
 #ifdef DAP_CONFIG_ENABLE_JTAG
   dap_jtag_dev_count = 0;
 #endif
-
-  dap_setup_clock(DAP_CONFIG_DEFAULT_CLOCK);
+#ifdef DAP_CONFIG_ENABLE_SWO
+  dap_swo_transport     = DAP_SWO_TRANSPORT_NONE;
+  dap_swo_mode          = DAP_SWO_MODE_OFF;
+  dap_swo_baudrate      = 0;
+  dap_swo_active        = false;
+  dap_swo_errors        = 0;
+#endif
 
   DAP_CONFIG_SETUP();
+
+#ifdef DAP_CONFIG_CYCLE_COUNTER
+  // Pins are inputs after setup, the test bits do not reach the target
+  dap_clock_calibrate();
+#endif
+
+  dap_setup_clock(DAP_CONFIG_DEFAULT_CLOCK);
 }
 
 //-----------------------------------------------------------------------------
@@ -1424,54 +2085,56 @@ bool dap_filter_request(uint8_t *req)
 }
 
 //-----------------------------------------------------------------------------
-int dap_process_request(uint8_t *req, int req_size, uint8_t *resp, int resp_size)
+bool dap_is_queue_request(uint8_t *req)
 {
-  static const struct
-  {
-    int    cmd;
-    void   (*handler)(void);
-  } handlers[] =
-  {
-    { ID_DAP_INFO,			dap_info },
-    { ID_DAP_HOST_STATUS,		dap_host_status },
-    { ID_DAP_CONNECT,			dap_connect },
-    { ID_DAP_DISCONNECT,		dap_disconnect },
-    { ID_DAP_TRANSFER_CONFIGURE,	dap_transfer_configure },
-    { ID_DAP_TRANSFER,			dap_transfer },
-    { ID_DAP_TRANSFER_BLOCK,		dap_transfer_block },
-    { ID_DAP_TRANSFER_ABORT,		dap_transfer_abort },
-    { ID_DAP_WRITE_ABORT,		dap_write_abort },
-    { ID_DAP_DELAY,			dap_delay },
-    { ID_DAP_RESET_TARGET,		dap_reset_target },
-    { ID_DAP_SWJ_PINS,			dap_swj_pins },
-    { ID_DAP_SWJ_CLOCK,			dap_swj_clock },
-    { ID_DAP_SWJ_SEQUENCE,		dap_swj_sequence },
-    { ID_DAP_SWD_CONFIGURE,		dap_swd_configure },
-    { ID_DAP_SWD_SEQUENCE,		dap_swd_sequence },
-    { ID_DAP_JTAG_SEQUENCE,		dap_jtag_sequence },
-    { ID_DAP_JTAG_CONFIGURE,		dap_jtag_configure },
-    { ID_DAP_JTAG_IDCODE,		dap_jtag_idcode },
-  };
-  int cmd;
-
-  dap_buf_init(req, req_size, resp, resp_size);
+  return ID_DAP_QUEUE_COMMANDS == req[0];
+}
 
-  dap_abort = false;
+//-----------------------------------------------------------------------------
+static void dap_execute_commands(void);
 
-#ifdef DAP_CONFIG_ENABLE_JTAG
-  dap_jtag_ir = JTAG_INVALID;
+//-----------------------------------------------------------------------------
+static bool dap_handle_command(int cmd)
+{
+  // Indexed by the command ID, unused IDs are NULL
+  static void (* const handlers[ID_DAP_EXECUTE_COMMANDS + 1])(void) =
+  {
+    [ID_DAP_INFO]			= dap_info,
+    [ID_DAP_HOST_STATUS]		= dap_host_status,
+    [ID_DAP_CONNECT]			= dap_connect,
+    [ID_DAP_DISCONNECT]			= dap_disconnect,
+    [ID_DAP_TRANSFER_CONFIGURE]		= dap_transfer_configure,
+    [ID_DAP_TRANSFER]			= dap_transfer,
+    [ID_DAP_TRANSFER_BLOCK]		= dap_transfer_block,
+    [ID_DAP_TRANSFER_ABORT]		= dap_transfer_abort,
+    [ID_DAP_WRITE_ABORT]		= dap_write_abort,
+    [ID_DAP_DELAY]			= dap_delay,
+    [ID_DAP_RESET_TARGET]		= dap_reset_target,
+    [ID_DAP_SWJ_PINS]			= dap_swj_pins,
+    [ID_DAP_SWJ_CLOCK]			= dap_swj_clock,
+    [ID_DAP_SWJ_SEQUENCE]		= dap_swj_sequence,
+    [ID_DAP_SWD_CONFIGURE]		= dap_swd_configure,
+    [ID_DAP_SWD_SEQUENCE]		= dap_swd_sequence,
+    [ID_DAP_JTAG_SEQUENCE]		= dap_jtag_sequence,
+    [ID_DAP_JTAG_CONFIGURE]		= dap_jtag_configure,
+    [ID_DAP_JTAG_IDCODE]		= dap_jtag_idcode,
+#ifdef DAP_CONFIG_ENABLE_SWO
+    [ID_DAP_SWO_TRANSPORT]		= dap_swo_transport_cmd,
+    [ID_DAP_SWO_MODE]			= dap_swo_mode_cmd,
+    [ID_DAP_SWO_BAUDRATE]		= dap_swo_baudrate_cmd,
+    [ID_DAP_SWO_CONTROL]		= dap_swo_control_cmd,
+    [ID_DAP_SWO_STATUS]			= dap_swo_status_cmd,
+    [ID_DAP_SWO_EXT_STATUS]		= dap_swo_ext_status_cmd,
+    [ID_DAP_SWO_DATA]			= dap_swo_data_cmd,
 #endif
+    [ID_DAP_QUEUE_COMMANDS]		= dap_execute_commands,
+    [ID_DAP_EXECUTE_COMMANDS]		= dap_execute_commands,
+  };
 
-  cmd = dap_req_get_byte();
-  dap_resp_add_byte(cmd);
-
-  for (int i = 0; i < ARRAY_SIZE(handlers); i++)
+  if (cmd < ARRAY_SIZE(handlers) && handlers[cmd])
   {
-    if (cmd == handlers[i].cmd)
-    {
-      handlers[i].handler();
-      return dap_resp_ptr;
-    }
+    handlers[cmd]();
+    return true;
   }
 
   if (ID_DAP_VENDOR_0 <= cmd && cmd <= ID_DAP_VENDOR_31)
@@ -1481,14 +2144,167 @@ int dap_process_request(uint8_t *req, int req_size, uint8_t *resp, int resp_size
 #else
     dap_resp_add_byte(DAP_ERROR);
 #endif
-    return dap_resp_ptr;
+    return true;
   }
 
   dap_resp_set_byte(0, ID_DAP_INVALID);
 
+  return false;
+}
+
+#ifdef DAP_CONFIG_ENABLE_PROFILE
+//-----------------------------------------------------------------------------
+// Commands inside DAP_ExecuteCommands are profiled on their own, the batch
+// itself is not
+static bool dap_profile_command(int cmd)
+{
+  dap_profile_t *parent = dap_profile_cmd;
+  dap_profile_t *profile = (cmd < DAP_PROFILE_SIZE) ? &dap_profile[cmd] : NULL;
+  uint32_t start, time;
+  bool valid;
+
+  dap_profile_cmd = profile;
+  start = DAP_CONFIG_PROFILE_COUNTER();
+
+  valid = dap_handle_command(cmd);
+
+  time = DAP_CONFIG_PROFILE_COUNTER() - start;
+  dap_profile_cmd = parent;
+
+  if (profile)
+  {
+    profile->count++;
+    profile->total += time;
+
+    if (time > profile->max)
+      profile->max = time;
+  }
+
+  return valid;
+}
+#endif
+
+//-----------------------------------------------------------------------------
+static bool dap_process_command(void)
+{
+  int cmd;
+
+  cmd = dap_req_get_byte();
+  dap_resp_add_byte(cmd);
+
+#ifdef DAP_CONFIG_ENABLE_PROFILE
+  return dap_profile_command(cmd);
+#else
+  return dap_handle_command(cmd);
+#endif
+}
+
+//-----------------------------------------------------------------------------
+static void dap_execute_commands(void)
+{
+  uint8_t *req_buf = dap_req_buf;
+  int req_size = dap_req_size;
+  uint8_t *resp_buf = dap_resp_buf;
+  int resp_size = dap_resp_size;
+  int executed = 0;
+  int count;
+
+  // Queued packets are answered like DAP_ExecuteCommands, as in the reference firmware
+  dap_resp_set_byte(0, ID_DAP_EXECUTE_COMMANDS);
+  dap_resp_add_byte(0); // Number of executed commands placeholder
+
+  // Added first, so that a packet without the count is answered with 0 executed
+  count = dap_req_get_byte();
+
+  if (dap_buf_error)
+    return;
+
+  for (int i = 0; i < count; i++)
+  {
+    int req_ptr = dap_req_ptr;
+    int resp_ptr = dap_resp_ptr;
+    bool valid;
+
+    // Handlers address their response by absolute index, so each command gets
+    // its own window into the buffers, starting right after the previous one
+    dap_buf_init(req_buf + req_ptr, req_size - req_ptr, resp_buf + resp_ptr, resp_size - resp_ptr);
+
+    // Like in the reference firmware, batches are only accepted at the top level.
+    // A nested one would recurse on the thread stack with no limit.
+    if (req_ptr < req_size && (ID_DAP_QUEUE_COMMANDS == req_buf[req_ptr] ||
+        ID_DAP_EXECUTE_COMMANDS == req_buf[req_ptr]))
+    {
+      dap_req_get_byte();
+      dap_resp_add_byte(ID_DAP_INVALID);
+      valid = false;
+    }
+    else
+      valid = dap_process_command();
+
+    if (dap_buf_error)
+    {
+      // The command was truncated or its response did not fit. Drop its partial
+      // response and stop, the host resends the rest based on the executed count.
+      dap_buf_init(req_buf, req_size, resp_buf, resp_size);
+      dap_req_ptr  = req_size;
+      dap_resp_ptr = resp_ptr;
+      break;
+    }
+
+    req_ptr  += dap_req_ptr;
+    resp_ptr += dap_resp_ptr;
+
+    dap_buf_init(req_buf, req_size, resp_buf, resp_size);
+    dap_req_ptr  = req_ptr;
+    dap_resp_ptr = resp_ptr;
+
+    executed++;
+
+    // The length of an unknown command is unknown, nothing after it can be parsed
+    if (!valid)
+      break;
+  }
+
+  dap_resp_set_byte(1, executed);
+}
+
+//-----------------------------------------------------------------------------
+int dap_process_request(uint8_t *req, int req_size, uint8_t *resp, int resp_size)
+{
+  dap_buf_init(req, req_size, resp, resp_size);
+
+  dap_abort = false;
+
+#ifdef DAP_CONFIG_ENABLE_JTAG
+  dap_jtag_ir = JTAG_INVALID;
+#endif
+
+  dap_process_command();
+
   return dap_resp_ptr;
 }
 
+//-----------------------------------------------------------------------------
+const dap_profile_t *dap_profile_get(int cmd)
+{
+#ifdef DAP_CONFIG_ENABLE_PROFILE
+  if (0 <= cmd && cmd < DAP_PROFILE_SIZE)
+    return &dap_profile[cmd];
+#else
+  (void)cmd;
+#endif
+
+  return NULL;
+}
+
+//-----------------------------------------------------------------------------
+void dap_profile_reset(void)
+{
+#ifdef DAP_CONFIG_ENABLE_PROFILE
+  memset(dap_profile, 0, sizeof(dap_profile));
+#endif
+}
+
 //-----------------------------------------------------------------------------
 void dap_clock_test(int delay)
 {
@@ -33,6 +33,19 @@
 #include <stdint.h>
 #include <stdbool.h>
 
+/*- Definitions -------------------------------------------------------------*/
+#define DAP_PROFILE_SIZE  32 // Commands 0x00 - 0x1f
+
+/*- Types -------------------------------------------------------------------*/
+typedef struct
+{
+  uint32_t  count;
+  uint32_t  max;    // Longest execution, in DAP_CONFIG_PROFILE_COUNTER() ticks
+  uint64_t  total;  // All executions together
+  uint32_t  wait;   // WAIT responses that were retried
+  uint32_t  fault;  // FAULT responses
+} dap_profile_t;
+
 /*- Prototypes --------------------------------------------------------------*/
 void dap_init(void);
 uint8_t dap_req_get_byte(void);
@@ -43,8 +56,11 @@ void dap_resp_add_word(uint32_t value);
 void dap_resp_set_byte(int index, uint8_t value);
 bool dap_is_buf_error(void);
 bool dap_filter_request(uint8_t *req);
+bool dap_is_queue_request(uint8_t *req);
 int dap_process_request(uint8_t *req, int req_size, uint8_t *resp, int resp_size);
 void dap_clock_test(int delay);
+const dap_profile_t *dap_profile_get(int cmd);
+void dap_profile_reset(void);
 
 #endif // _DAP_H_
 
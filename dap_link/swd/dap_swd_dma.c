@@ -0,0 +1,227 @@
+#include <furi.h>
+#include <furi_hal_bus.h>
+#include <furi_hal_cortex.h>
+#include <stm32wbxx_ll_dma.h>
+#include <stm32wbxx_ll_tim.h>
+
+#include "dap_swd_dma.h"
+#include "../dap_config.h"
+
+#define DAP_SWD_DMA_TIMER TIM2
+#define DAP_SWD_DMA_TIMER_BUS FuriHalBusTIM2
+#define DAP_SWD_DMA_TIMER_CLOCK 64000000UL
+
+#define DAP_SWD_DMA_INSTANCE DMA2
+#define DAP_SWD_DMA_CHANNEL_OUT LL_DMA_CHANNEL_6
+#define DAP_SWD_DMA_CHANNEL_IN LL_DMA_CHANNEL_7
+
+// Timer ticks per half SWCLK period. Below this DMA2 can not keep up with the
+// update events and bits get stretched, so faster requests are clamped to it.
+#define DAP_SWD_DMA_MIN_HALF_PERIOD 8
+
+// Longest sequence: data, parity and up to 255 idle cycles
+#define DAP_SWD_DMA_MAX_BITS (32 + 1 + 255)
+#define DAP_SWD_DMA_MAX_READ_BITS 64
+
+// A sequence that has not completed within twice its length plus this has failed
+#define DAP_SWD_DMA_TIMEOUT_MARGIN_US 100
+// Sequences longer than this yield while they wait instead of spinning
+#define DAP_SWD_DMA_YIELD_US 1000
+
+// Two BSRR words per bit: SWCLK low with SWDIO set up, then SWCLK high
+static uint32_t dap_swd_dma_out[DAP_SWD_DMA_MAX_BITS * 2];
+// One IDR sample taken right before every BSRR write
+static uint16_t dap_swd_dma_in[DAP_SWD_DMA_MAX_READ_BITS * 2];
+
+static GPIO_TypeDef* dap_swd_dma_port;
+static uint32_t dap_swd_dma_clk_low;
+static uint32_t dap_swd_dma_clk_high;
+static uint32_t dap_swd_dma_dio_high;
+static uint32_t dap_swd_dma_dio_low;
+static uint32_t dap_swd_dma_half_period;
+// Set when a DMA sequence timed out or hit a transfer error, the rest of the block is clocked
+// by the CPU
+static bool dap_swd_dma_failed;
+
+bool dap_swd_dma_start(uint32_t clock) {
+    if(flipper_dap_gpio.swclk_port != flipper_dap_gpio.swdio_port) return false;
+    if(furi_hal_bus_is_enabled(DAP_SWD_DMA_TIMER_BUS)) return false;
+    if(LL_DMA_IsEnabledChannel(DAP_SWD_DMA_INSTANCE, DAP_SWD_DMA_CHANNEL_OUT) ||
+       LL_DMA_IsEnabledChannel(DAP_SWD_DMA_INSTANCE, DAP_SWD_DMA_CHANNEL_IN))
+        return false;
+
+    dap_swd_dma_port = flipper_dap_gpio.swclk_port;
+    dap_swd_dma_clk_low = flipper_dap_gpio.swclk_mask << 16;
+    dap_swd_dma_clk_high = flipper_dap_gpio.swclk_mask;
+    dap_swd_dma_dio_high = flipper_dap_gpio.swdio_mask;
+    dap_swd_dma_dio_low = flipper_dap_gpio.swdio_mask << 16;
+
+    uint32_t half_period = DAP_SWD_DMA_TIMER_CLOCK / (clock ? clock * 2 : 1);
+    if(half_period < DAP_SWD_DMA_MIN_HALF_PERIOD) half_period = DAP_SWD_DMA_MIN_HALF_PERIOD;
+    if(half_period > 0x10000) half_period = 0x10000;
+    dap_swd_dma_half_period = half_period;
+    dap_swd_dma_failed = false;
+
+    furi_hal_bus_enable(DAP_SWD_DMA_TIMER_BUS);
+    LL_TIM_SetCounterMode(DAP_SWD_DMA_TIMER, LL_TIM_COUNTERMODE_UP);
+    LL_TIM_SetClockDivision(DAP_SWD_DMA_TIMER, LL_TIM_CLOCKDIVISION_DIV1);
+    LL_TIM_SetPrescaler(DAP_SWD_DMA_TIMER, 0);
+    LL_TIM_SetAutoReload(DAP_SWD_DMA_TIMER, half_period - 1);
+    LL_TIM_SetClockSource(DAP_SWD_DMA_TIMER, LL_TIM_CLOCKSOURCE_INTERNAL);
+    LL_TIM_DisableARRPreload(DAP_SWD_DMA_TIMER);
+    // Sample at the last tick of each half period, just before the next BSRR write
+    LL_TIM_OC_SetCompareCH1(DAP_SWD_DMA_TIMER, half_period - 1);
+    LL_TIM_GenerateEvent_UPDATE(DAP_SWD_DMA_TIMER);
+    LL_TIM_ClearFlag_UPDATE(DAP_SWD_DMA_TIMER);
+    LL_TIM_EnableDMAReq_UPDATE(DAP_SWD_DMA_TIMER);
+    LL_TIM_EnableDMAReq_CC1(DAP_SWD_DMA_TIMER);
+
+    LL_DMA_ConfigTransfer(
+        DAP_SWD_DMA_INSTANCE,
+        DAP_SWD_DMA_CHANNEL_OUT,
+        LL_DMA_DIRECTION_MEMORY_TO_PERIPH | LL_DMA_MODE_NORMAL | LL_DMA_PERIPH_NOINCREMENT |
+            LL_DMA_MEMORY_INCREMENT | LL_DMA_PDATAALIGN_WORD | LL_DMA_MDATAALIGN_WORD |
+            LL_DMA_PRIORITY_VERYHIGH);
+    LL_DMA_SetPeriphAddress(
+        DAP_SWD_DMA_INSTANCE, DAP_SWD_DMA_CHANNEL_OUT, (uint32_t) & (dap_swd_dma_port->BSRR));
+    LL_DMA_SetMemoryAddress(
+        DAP_SWD_DMA_INSTANCE, DAP_SWD_DMA_CHANNEL_OUT, (uint32_t)dap_swd_dma_out);
+    LL_DMA_SetPeriphRequest(
+        DAP_SWD_DMA_INSTANCE, DAP_SWD_DMA_CHANNEL_OUT, LL_DMAMUX_REQ_TIM2_UP);
+
+    LL_DMA_ConfigTransfer(
+        DAP_SWD_DMA_INSTANCE,
+        DAP_SWD_DMA_CHANNEL_IN,
+        LL_DMA_DIRECTION_PERIPH_TO_MEMORY | LL_DMA_MODE_NORMAL | LL_DMA_PERIPH_NOINCREMENT |
+            LL_DMA_MEMORY_INCREMENT | LL_DMA_PDATAALIGN_HALFWORD | LL_DMA_MDATAALIGN_HALFWORD |
+            LL_DMA_PRIORITY_VERYHIGH);
+    LL_DMA_SetPeriphAddress(
+        DAP_SWD_DMA_INSTANCE, DAP_SWD_DMA_CHANNEL_IN, (uint32_t) & (dap_swd_dma_port->IDR));
+    LL_DMA_SetMemoryAddress(
+        DAP_SWD_DMA_INSTANCE, DAP_SWD_DMA_CHANNEL_IN, (uint32_t)dap_swd_dma_in);
+    LL_DMA_SetPeriphRequest(
+        DAP_SWD_DMA_INSTANCE, DAP_SWD_DMA_CHANNEL_IN, LL_DMAMUX_REQ_TIM2_CH1);
+
+    return true;
+}
+
+void dap_swd_dma_stop(void) {
+    LL_TIM_DisableCounter(DAP_SWD_DMA_TIMER);
+    LL_DMA_DisableChannel(DAP_SWD_DMA_INSTANCE, DAP_SWD_DMA_CHANNEL_OUT);
+    LL_DMA_DisableChannel(DAP_SWD_DMA_INSTANCE, DAP_SWD_DMA_CHANNEL_IN);
+    furi_hal_bus_disable(DAP_SWD_DMA_TIMER_BUS);
+}
+
+// Clocks out words from..words - 1 of dap_swd_dma_out with the CPU, paced by the same timer
+// update events the DMA would have used, sampling IDR right before every write
+static void dap_swd_dma_cpu_run(uint32_t from, uint32_t words, bool sample) {
+    LL_TIM_DisableDMAReq_UPDATE(DAP_SWD_DMA_TIMER);
+    LL_TIM_DisableDMAReq_CC1(DAP_SWD_DMA_TIMER);
+    LL_TIM_ClearFlag_UPDATE(DAP_SWD_DMA_TIMER);
+    LL_TIM_EnableCounter(DAP_SWD_DMA_TIMER);
+
+    for(uint32_t i = from; i < words; i++) {
+        while(!LL_TIM_IsActiveFlag_UPDATE(DAP_SWD_DMA_TIMER))
+            ;
+        LL_TIM_ClearFlag_UPDATE(DAP_SWD_DMA_TIMER);
+        if(sample) dap_swd_dma_in[i] = dap_swd_dma_port->IDR;
+        dap_swd_dma_port->BSRR = dap_swd_dma_out[i];
+    }
+
+    LL_TIM_DisableCounter(DAP_SWD_DMA_TIMER);
+    LL_TIM_EnableDMAReq_UPDATE(DAP_SWD_DMA_TIMER);
+    LL_TIM_EnableDMAReq_CC1(DAP_SWD_DMA_TIMER);
+}
+
+// Runs `size` bits of dap_swd_dma_out, sampling IDR into dap_swd_dma_in if sample is set.
+// If the DMA times out or reports a transfer error, the CPU finishes the sequence from the
+// word the DMA stopped at, so the target still sees every bit.
+static void dap_swd_dma_run(int size, bool sample) {
+    uint32_t words = size * 2;
+
+    if(dap_swd_dma_failed) {
+        LL_TIM_SetCounter(DAP_SWD_DMA_TIMER, 0);
+        dap_swd_dma_cpu_run(0, words, sample);
+        return;
+    }
+
+    uint32_t duration_us =
+        (uint64_t)words * dap_swd_dma_half_period / (DAP_SWD_DMA_TIMER_CLOCK / 1000000UL);
+    FuriHalCortexTimer timeout =
+        furi_hal_cortex_timer_get(duration_us * 2 + DAP_SWD_DMA_TIMEOUT_MARGIN_US);
+    bool yield = duration_us > DAP_SWD_DMA_YIELD_US;
+
+    LL_DMA_ClearFlag_TC6(DAP_SWD_DMA_INSTANCE);
+    LL_DMA_ClearFlag_TC7(DAP_SWD_DMA_INSTANCE);
+    LL_DMA_ClearFlag_TE6(DAP_SWD_DMA_INSTANCE);
+    LL_DMA_ClearFlag_TE7(DAP_SWD_DMA_INSTANCE);
+    LL_DMA_SetDataLength(DAP_SWD_DMA_INSTANCE, DAP_SWD_DMA_CHANNEL_OUT, words);
+    LL_DMA_EnableChannel(DAP_SWD_DMA_INSTANCE, DAP_SWD_DMA_CHANNEL_OUT);
+    if(sample) {
+        LL_DMA_SetDataLength(DAP_SWD_DMA_INSTANCE, DAP_SWD_DMA_CHANNEL_IN, words);
+        LL_DMA_EnableChannel(DAP_SWD_DMA_INSTANCE, DAP_SWD_DMA_CHANNEL_IN);
+    }
+
+    LL_TIM_SetCounter(DAP_SWD_DMA_TIMER, 0);
+    LL_TIM_EnableCounter(DAP_SWD_DMA_TIMER);
+
+    // A sequence is a few microseconds at the usual clocks, shorter than a context switch,
+    // so spin. The pins keep their timing while USB interrupts run.
+    while(!LL_DMA_IsActiveFlag_TC6(DAP_SWD_DMA_INSTANCE)) {
+        if(LL_DMA_IsActiveFlag_TE6(DAP_SWD_DMA_INSTANCE) ||
+           LL_DMA_IsActiveFlag_TE7(DAP_SWD_DMA_INSTANCE) ||
+           furi_hal_cortex_timer_is_expired(timeout)) {
+            dap_swd_dma_failed = true;
+            break;
+        }
+        if(yield) furi_thread_yield();
+    }
+
+    LL_TIM_DisableCounter(DAP_SWD_DMA_TIMER);
+    LL_DMA_DisableChannel(DAP_SWD_DMA_INSTANCE, DAP_SWD_DMA_CHANNEL_OUT);
+    LL_DMA_DisableChannel(DAP_SWD_DMA_INSTANCE, DAP_SWD_DMA_CHANNEL_IN);
+
+    if(dap_swd_dma_failed) {
+        uint32_t done =
+            words - LL_DMA_GetDataLength(DAP_SWD_DMA_INSTANCE, DAP_SWD_DMA_CHANNEL_OUT);
+        FURI_LOG_W("DAP", "DMA failed after %lu of %lu words", done, words);
+        dap_swd_dma_cpu_run(done, words, sample);
+    }
+}
+
+void dap_swd_dma_write(uint64_t value, int size) {
+    uint32_t* out = dap_swd_dma_out;
+
+    if(size > DAP_SWD_DMA_MAX_BITS) size = DAP_SWD_DMA_MAX_BITS;
+    if(size <= 0) return;
+
+    for(int i = 0; i < size; i++) {
+        bool bit = (i < 64) && ((value >> i) & 1);
+        *out++ = dap_swd_dma_clk_low | (bit ? dap_swd_dma_dio_high : dap_swd_dma_dio_low);
+        *out++ = dap_swd_dma_clk_high;
+    }
+
+    dap_swd_dma_run(size, false);
+}
+
+uint64_t dap_swd_dma_read(int size) {
+    uint32_t* out = dap_swd_dma_out;
+    uint64_t value = 0;
+
+    if(size > DAP_SWD_DMA_MAX_READ_BITS) size = DAP_SWD_DMA_MAX_READ_BITS;
+    if(size <= 0) return 0;
+
+    for(int i = 0; i < size; i++) {
+        *out++ = dap_swd_dma_clk_low;
+        *out++ = dap_swd_dma_clk_high;
+    }
+
+    dap_swd_dma_run(size, true);
+
+    // Sample 2 * i + 1 is taken at the end of the SWCLK low half of bit i
+    for(int i = 0; i < size; i++) {
+        if(dap_swd_dma_in[2 * i + 1] & flipper_dap_gpio.swdio_mask) value |= (uint64_t)1 << i;
+    }
+
+    return value;
+}
@@ -0,0 +1,20 @@
+#pragma once
+#include <stdint.h>
+#include <stdbool.h>
+
+// SWD bit engine: TIM2 paces DMA2 channel 6, which writes precomputed SWCLK/SWDIO
+// words to the GPIO BSRR, and channel 7, which samples the port IDR on every edge.
+// SWCLK and SWDIO must be on the same port. If a DMA sequence times out or reports a
+// transfer error, the CPU finishes it and clocks the rest of the block, paced by TIM2.
+
+// Claims TIM2 and the DMA channels for a DAP_TransferBlock, false if they are busy
+bool dap_swd_dma_start(uint32_t clock);
+
+void dap_swd_dma_stop(void);
+
+// Clocks out the low `size` bits of value LSB first, bits past 64 are sent as 0.
+// SWDIO must be an output.
+void dap_swd_dma_write(uint64_t value, int size);
+
+// Clocks in `size` bits (64 at most) LSB first. SWDIO must be an input.
+uint64_t dap_swd_dma_read(int size);
@@ -0,0 +1,119 @@
+#include <furi.h>
+#include <furi_hal_serial_control.h>
+#include <furi_hal_serial.h>
+#include <stm32wbxx_ll_lpuart.h>
+
+#include "dap_swo.h"
+#include "../dap_config.h"
+
+// LPUART1 runs from the 64 MHz system clock and needs at least 3 clocks per bit
+#define DAP_SWO_BAUDRATE_MIN 1200
+#define DAP_SWO_BAUDRATE_MAX (64000000 / 3)
+
+typedef struct {
+    FuriHalSerialHandle* serial_handle;
+    FuriStreamBuffer* buffer;
+    volatile uint8_t errors;
+    bool streaming;
+    DapSwoCallback callback;
+    void* context;
+} DapSwo;
+
+static DapSwo dap_swo = {0};
+
+static void dap_swo_uart_cb(
+    FuriHalSerialHandle* handle,
+    FuriHalSerialRxEvent event,
+    size_t size,
+    void* context) {
+    UNUSED(context);
+
+    if(event & (FuriHalSerialRxEventData | FuriHalSerialRxEventIdle)) {
+        uint8_t data[FURI_HAL_SERIAL_DMA_BUFFER_SIZE];
+        while(size) {
+            size_t len = furi_hal_serial_dma_rx(
+                handle,
+                data,
+                (size > FURI_HAL_SERIAL_DMA_BUFFER_SIZE) ? FURI_HAL_SERIAL_DMA_BUFFER_SIZE : size);
+            if(furi_stream_buffer_send(dap_swo.buffer, data, len, 0) < len) {
+                dap_swo.errors |= DapSwoErrorOverrun;
+            }
+            size -= len;
+        }
+
+        if(dap_swo.callback) {
+            dap_swo.callback(dap_swo.context);
+        }
+    }
+
+    if(event & FuriHalSerialRxEventOverrunError) {
+        dap_swo.errors |= DapSwoErrorOverrun;
+    }
+
+    if(event & (FuriHalSerialRxEventFrameError | FuriHalSerialRxEventNoiseError)) {
+        dap_swo.errors |= DapSwoErrorFraming;
+    }
+}
+
+bool dap_swo_start(uint32_t baudrate, bool streaming) {
+    furi_assert(dap_swo.serial_handle == NULL);
+
+    dap_swo.serial_handle = furi_hal_serial_control_acquire(FuriHalSerialIdLpuart);
+    if(!dap_swo.serial_handle) return false;
+
+    dap_swo.buffer = furi_stream_buffer_alloc(DAP_CONFIG_SWO_BUFFER_SIZE, 1);
+    dap_swo.errors = 0;
+    dap_swo.streaming = streaming;
+
+    LL_LPUART_SetTXRXSwap(LPUART1, LL_LPUART_TXRX_STANDARD);
+    furi_hal_serial_init(dap_swo.serial_handle, baudrate);
+    // SWO only comes in, leave the TX pin to the target
+    furi_hal_serial_disable_direction(dap_swo.serial_handle, FuriHalSerialDirectionTx);
+    furi_hal_serial_dma_rx_start(dap_swo.serial_handle, dap_swo_uart_cb, NULL, true);
+
+    return true;
+}
+
+void dap_swo_stop(void) {
+    if(!dap_swo.serial_handle) return;
+
+    furi_hal_serial_deinit(dap_swo.serial_handle);
+    furi_hal_serial_control_release(dap_swo.serial_handle);
+    dap_swo.serial_handle = NULL;
+
+    furi_stream_buffer_free(dap_swo.buffer);
+    dap_swo.buffer = NULL;
+    dap_swo.streaming = false;
+}
+
+bool dap_swo_is_streaming(void) {
+    return dap_swo.serial_handle && dap_swo.streaming;
+}
+
+uint32_t dap_swo_baudrate(uint32_t baudrate) {
+    if(baudrate < DAP_SWO_BAUDRATE_MIN || baudrate > DAP_SWO_BAUDRATE_MAX) return 0;
+    return baudrate;
+}
+
+uint32_t dap_swo_count(void) {
+    if(!dap_swo.buffer) return 0;
+    return furi_stream_buffer_bytes_available(dap_swo.buffer);
+}
+
+uint32_t dap_swo_read(uint8_t* data, uint32_t size) {
+    if(!dap_swo.buffer) return 0;
+    return furi_stream_buffer_receive(dap_swo.buffer, data, size, 0);
+}
+
+uint8_t dap_swo_errors(void) {
+    FURI_CRITICAL_ENTER();
+    uint8_t errors = dap_swo.errors;
+    dap_swo.errors = 0;
+    FURI_CRITICAL_EXIT();
+    return errors;
+}
+
+void dap_swo_set_callback(DapSwoCallback callback, void* context) {
+    dap_swo.callback = callback;
+    dap_swo.context = context;
+}
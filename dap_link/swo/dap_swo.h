@@ -0,0 +1,34 @@
+#pragma once
+#include <stdint.h>
+#include <stdbool.h>
+
+// SWO capture in UART (NRZ) mode on the LPUART1 RX pin. The serial driver DMA
+// feeds a DAP_CONFIG_SWO_BUFFER_SIZE ring that DAP_SWO_Data or the SWO bulk
+// endpoint drain.
+
+typedef enum {
+    DapSwoErrorFraming = (1 << 6), // DAP_SWO_Status error bit
+    DapSwoErrorOverrun = (1 << 7), // DAP_SWO_Status overrun bit
+} DapSwoError;
+
+typedef void (*DapSwoCallback)(void* context);
+
+// false if LPUART1 is taken, by the VCP for example
+bool dap_swo_start(uint32_t baudrate, bool streaming);
+
+void dap_swo_stop(void);
+
+bool dap_swo_is_streaming(void);
+
+// Baudrate the capture runs at when asked for baudrate, 0 if out of range
+uint32_t dap_swo_baudrate(uint32_t baudrate);
+
+uint32_t dap_swo_count(void);
+
+uint32_t dap_swo_read(uint8_t* data, uint32_t size);
+
+// DapSwoError bits collected since the previous call
+uint8_t dap_swo_errors(void);
+
+// Called from the UART interrupt after new data is buffered
+void dap_swo_set_callback(DapSwoCallback callback, void* context);
@@ -24,6 +24,8 @@
 #define DAP_HID_EP_OUT (HID_EP_OUT | DAP_HID_EP_RECV)
 #define DAP_HID_EP_BULK_IN (HID_EP_IN | DAP_HID_EP_BULK_SEND)
 #define DAP_HID_EP_BULK_OUT (HID_EP_OUT | DAP_HID_EP_BULK_RECV)
+// All endpoint numbers are taken, SWO uses the IN half of the bulk OUT endpoint
+#define DAP_HID_EP_BULK_SWO (HID_EP_IN | DAP_HID_EP_BULK_RECV)
 
 #define DAP_HID_EP_SIZE 64
 #define DAP_CDC_COMM_EP_SIZE 8
@@ -99,6 +101,7 @@ struct HidConfigDescriptor {
     struct usb_interface_descriptor bulk_interface;
     struct usb_endpoint_descriptor bulk_ep_out;
     struct usb_endpoint_descriptor bulk_ep_in;
+    struct usb_endpoint_descriptor bulk_ep_swo;
 
     // CDC
     struct usb_iad_descriptor iad;
@@ -213,7 +216,7 @@ static const struct HidConfigDescriptor hid_cfg_desc = {
             .bDescriptorType = USB_DTYPE_INTERFACE,
             .bInterfaceNumber = USB_INTF_BULK,
             .bAlternateSetting = 0,
-            .bNumEndpoints = 2,
+            .bNumEndpoints = 3,
             .bInterfaceClass = USB_CLASS_VENDOR,
             .bInterfaceSubClass = 0,
             .bInterfaceProtocol = 0,
@@ -240,6 +243,16 @@ static const struct HidConfigDescriptor hid_cfg_desc = {
             .bInterval = DAP_BULK_INTERVAL,
         },
 
+    .bulk_ep_swo =
+        {
+            .bLength = sizeof(struct usb_endpoint_descriptor),
+            .bDescriptorType = USB_DTYPE_ENDPOINT,
+            .bEndpointAddress = DAP_HID_EP_BULK_SWO,
+            .bmAttributes = USB_EPTYPE_BULK,
+            .wMaxPacketSize = DAP_HID_EP_SIZE,
+            .bInterval = DAP_BULK_INTERVAL,
+        },
+
     // CDC
     .iad =
         {
@@ -442,6 +455,7 @@ const usb_msos_descriptor_set_t usb_msos_descriptor_set = {
 typedef struct {
     FuriSemaphore* semaphore_v1;
     FuriSemaphore* semaphore_v2;
+    FuriSemaphore* semaphore_swo;
     FuriSemaphore* semaphore_cdc;
     bool connected;
     usbd_device* usb_dev;
@@ -449,6 +463,9 @@ typedef struct {
     DapRxCallback rx_callback_v1;
     DapRxCallback rx_callback_v2;
     DapRxCallback rx_callback_cdc;
+    DapRxCallback tx_complete_v1;
+    DapRxCallback tx_complete_v2;
+    DapRxCallback tx_complete_swo;
     DapRxCallback tx_complete_cdc;
     DapCDCControlLineCallback control_line_callback_cdc;
     DapCDCConfigCallback config_callback_cdc;
@@ -459,6 +476,7 @@ typedef struct {
 static DAPState dap_state = {
     .semaphore_v1 = NULL,
     .semaphore_v2 = NULL,
+    .semaphore_swo = NULL,
     .semaphore_cdc = NULL,
     .connected = false,
     .usb_dev = NULL,
@@ -466,6 +484,9 @@ static DAPState dap_state = {
     .rx_callback_v1 = NULL,
     .rx_callback_v2 = NULL,
     .rx_callback_cdc = NULL,
+    .tx_complete_v1 = NULL,
+    .tx_complete_v2 = NULL,
+    .tx_complete_swo = NULL,
     .control_line_callback_cdc = NULL,
     .config_callback_cdc = NULL,
     .context = NULL,
@@ -520,6 +541,35 @@ int32_t dap_v2_usb_tx(uint8_t* buffer, uint8_t size) {
     }
 }
 
+bool dap_v1_usb_tx_ready() {
+    if((dap_state.semaphore_v1 == NULL) || (dap_state.connected == false)) return false;
+    return furi_semaphore_get_count(dap_state.semaphore_v1) > 0;
+}
+
+bool dap_v2_usb_tx_ready() {
+    if((dap_state.semaphore_v2 == NULL) || (dap_state.connected == false)) return false;
+    return furi_semaphore_get_count(dap_state.semaphore_v2) > 0;
+}
+
+int32_t dap_swo_usb_tx(uint8_t* buffer, uint8_t size) {
+    if((dap_state.semaphore_swo == NULL) || (dap_state.connected == false)) return 0;
+
+    furi_check(furi_semaphore_acquire(dap_state.semaphore_swo, FuriWaitForever) == FuriStatusOk);
+
+    if(dap_state.connected) {
+        int32_t len = usbd_ep_write(dap_state.usb_dev, DAP_HID_EP_BULK_SWO, buffer, size);
+        furi_console_log_printf("swo tx %ld", len);
+        return len;
+    } else {
+        return 0;
+    }
+}
+
+bool dap_swo_usb_tx_ready() {
+    if((dap_state.semaphore_swo == NULL) || (dap_state.connected == false)) return false;
+    return furi_semaphore_get_count(dap_state.semaphore_swo) > 0;
+}
+
 int32_t dap_cdc_usb_tx(uint8_t* buffer, uint8_t size) {
     if((dap_state.semaphore_cdc == NULL) || (dap_state.connected == false)) return 0;
 
@@ -534,6 +584,11 @@ int32_t dap_cdc_usb_tx(uint8_t* buffer, uint8_t size) {
     return 0;
 }
 
+bool dap_cdc_usb_tx_ready() {
+    if((dap_state.semaphore_cdc == NULL) || (dap_state.connected == false)) return false;
+    return furi_semaphore_get_count(dap_state.semaphore_cdc) > 0;
+}
+
 void dap_v1_usb_set_rx_callback(DapRxCallback callback) {
     dap_state.rx_callback_v1 = callback;
 }
@@ -542,6 +597,18 @@ void dap_v2_usb_set_rx_callback(DapRxCallback callback) {
     dap_state.rx_callback_v2 = callback;
 }
 
+void dap_v1_usb_set_tx_complete_callback(DapRxCallback callback) {
+    dap_state.tx_complete_v1 = callback;
+}
+
+void dap_v2_usb_set_tx_complete_callback(DapRxCallback callback) {
+    dap_state.tx_complete_v2 = callback;
+}
+
+void dap_swo_usb_set_tx_complete_callback(DapRxCallback callback) {
+    dap_state.tx_complete_swo = callback;
+}
+
 void dap_cdc_usb_set_rx_callback(DapRxCallback callback) {
     dap_state.rx_callback_cdc = callback;
 }
@@ -621,6 +688,7 @@ static void hid_init(usbd_device* dev, FuriHalUsbInterface* intf, void* ctx) {
     dap_state.usb_dev = dev;
     if(dap_state.semaphore_v1 == NULL) dap_state.semaphore_v1 = furi_semaphore_alloc(1, 1);
     if(dap_state.semaphore_v2 == NULL) dap_state.semaphore_v2 = furi_semaphore_alloc(1, 1);
+    if(dap_state.semaphore_swo == NULL) dap_state.semaphore_swo = furi_semaphore_alloc(1, 1);
     if(dap_state.semaphore_cdc == NULL) dap_state.semaphore_cdc = furi_semaphore_alloc(1, 1);
 
     usbd_reg_config(dev, hid_ep_config);
@@ -634,9 +702,11 @@ static void hid_deinit(usbd_device* dev) {
 
     furi_semaphore_free(dap_state.semaphore_v1);
     furi_semaphore_free(dap_state.semaphore_v2);
+    furi_semaphore_free(dap_state.semaphore_swo);
     furi_semaphore_free(dap_state.semaphore_cdc);
     dap_state.semaphore_v1 = NULL;
     dap_state.semaphore_v2 = NULL;
+    dap_state.semaphore_swo = NULL;
     dap_state.semaphore_cdc = NULL;
 
     usbd_reg_config(dev, NULL);
@@ -700,6 +770,9 @@ static void hid_txrx_ep_callback(usbd_device* dev, uint8_t event, uint8_t ep) {
     switch(event) {
     case usbd_evt_eptx:
         furi_semaphore_release(dap_state.semaphore_v1);
+        if(dap_state.tx_complete_v1 != NULL) {
+            dap_state.tx_complete_v1(dap_state.context);
+        }
         furi_console_log_printf("hid tx complete");
         break;
     case usbd_evt_eprx:
@@ -715,11 +788,21 @@ static void hid_txrx_ep_callback(usbd_device* dev, uint8_t event, uint8_t ep) {
 
 static void hid_txrx_ep_bulk_callback(usbd_device* dev, uint8_t event, uint8_t ep) {
     UNUSED(dev);
-    UNUSED(ep);
 
     switch(event) {
     case usbd_evt_eptx:
+        if(ep == DAP_HID_EP_BULK_SWO) {
+            furi_semaphore_release(dap_state.semaphore_swo);
+            if(dap_state.tx_complete_swo != NULL) {
+                dap_state.tx_complete_swo(dap_state.context);
+            }
+            furi_console_log_printf("swo tx complete");
+            break;
+        }
         furi_semaphore_release(dap_state.semaphore_v2);
+        if(dap_state.tx_complete_v2 != NULL) {
+            dap_state.tx_complete_v2(dap_state.context);
+        }
         furi_console_log_printf("bulk tx complete");
         break;
     case usbd_evt_eprx:
@@ -763,6 +846,7 @@ static usbd_respond hid_ep_config(usbd_device* dev, uint8_t cfg) {
         usbd_ep_deconfig(dev, DAP_HID_EP_IN);
         usbd_ep_deconfig(dev, DAP_HID_EP_BULK_IN);
         usbd_ep_deconfig(dev, DAP_HID_EP_BULK_OUT);
+        usbd_ep_deconfig(dev, DAP_HID_EP_BULK_SWO);
         usbd_ep_deconfig(dev, HID_EP_IN | DAP_CDC_EP_COMM);
         usbd_ep_deconfig(dev, HID_EP_IN | DAP_CDC_EP_SEND);
         usbd_ep_deconfig(dev, HID_EP_OUT | DAP_CDC_EP_RECV);
@@ -778,6 +862,7 @@ static usbd_respond hid_ep_config(usbd_device* dev, uint8_t cfg) {
         usbd_ep_config(dev, DAP_HID_EP_OUT, USB_EPTYPE_INTERRUPT, DAP_HID_EP_SIZE);
         usbd_ep_config(dev, DAP_HID_EP_BULK_OUT, USB_EPTYPE_BULK, DAP_HID_EP_SIZE);
         usbd_ep_config(dev, DAP_HID_EP_BULK_IN, USB_EPTYPE_BULK, DAP_HID_EP_SIZE);
+        usbd_ep_config(dev, DAP_HID_EP_BULK_SWO, USB_EPTYPE_BULK, DAP_HID_EP_SIZE);
         usbd_ep_config(dev, HID_EP_OUT | DAP_CDC_EP_RECV, USB_EPTYPE_BULK, DAP_CDC_EP_SIZE);
         usbd_ep_config(dev, HID_EP_IN | DAP_CDC_EP_SEND, USB_EPTYPE_BULK, DAP_CDC_EP_SIZE);
         usbd_ep_config(dev, HID_EP_IN | DAP_CDC_EP_COMM, USB_EPTYPE_INTERRUPT, DAP_CDC_EP_SIZE);
@@ -785,6 +870,7 @@ static usbd_respond hid_ep_config(usbd_device* dev, uint8_t cfg) {
         usbd_reg_endpoint(dev, DAP_HID_EP_OUT, hid_txrx_ep_callback);
         usbd_reg_endpoint(dev, DAP_HID_EP_BULK_OUT, hid_txrx_ep_bulk_callback);
         usbd_reg_endpoint(dev, DAP_HID_EP_BULK_IN, hid_txrx_ep_bulk_callback);
+        usbd_reg_endpoint(dev, DAP_HID_EP_BULK_SWO, hid_txrx_ep_bulk_callback);
         usbd_reg_endpoint(dev, HID_EP_OUT | DAP_CDC_EP_RECV, cdc_txrx_ep_callback);
         usbd_reg_endpoint(dev, HID_EP_IN | DAP_CDC_EP_SEND, cdc_txrx_ep_callback);
         // usbd_ep_write(dev, DAP_HID_EP_IN, NULL, 0);
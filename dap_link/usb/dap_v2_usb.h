@@ -17,6 +17,11 @@ size_t dap_v1_usb_rx(uint8_t* buffer, size_t size);
 
 void dap_v1_usb_set_rx_callback(DapRxCallback callback);
 
+// true if the IN endpoint is free and dap_v1_usb_tx() will not block
+bool dap_v1_usb_tx_ready();
+
+void dap_v1_usb_set_tx_complete_callback(DapRxCallback callback);
+
 /************************************ V2 ***************************************/
 
 int32_t dap_v2_usb_tx(uint8_t* buffer, uint8_t size);
@@ -25,6 +30,19 @@ size_t dap_v2_usb_rx(uint8_t* buffer, size_t size);
 
 void dap_v2_usb_set_rx_callback(DapRxCallback callback);
 
+// true if the IN endpoint is free and dap_v2_usb_tx() will not block
+bool dap_v2_usb_tx_ready();
+
+void dap_v2_usb_set_tx_complete_callback(DapRxCallback callback);
+
+/************************************ SWO **************************************/
+
+int32_t dap_swo_usb_tx(uint8_t* buffer, uint8_t size);
+
+bool dap_swo_usb_tx_ready();
+
+void dap_swo_usb_set_tx_complete_callback(DapRxCallback callback);
+
 /************************************ CDC **************************************/
 
 typedef void (*DapCDCControlLineCallback)(uint8_t state, void* context);
@@ -32,6 +50,8 @@ typedef void (*DapCDCConfigCallback)(struct usb_cdc_line_coding* config, void* c
 
 int32_t dap_cdc_usb_tx(uint8_t* buffer, uint8_t size);
 
+bool dap_cdc_usb_tx_ready();
+
 size_t dap_cdc_usb_rx(uint8_t* buffer, size_t size);
 
 void dap_cdc_usb_set_rx_callback(DapRxCallback callback);
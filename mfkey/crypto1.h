@@ -13,7 +13,17 @@
 #define SWAPENDIAN(x) \
     ((x) = ((x) >> 8 & 0xff00ff) | ((x) & 0xff00ff) << 8, (x) = (x) >> 16 | (x) << 16)
 
+// CRYPTO1_BYTEWISE: step the LFSR 8 bits at a time in the word functions, taking the
+// feedback from the tables in crypto1_tables.h (3.5 KB of flash) instead of a parity per bit
+#ifndef CRYPTO1_BYTEWISE
+#define CRYPTO1_BYTEWISE 1
+#endif
+#if CRYPTO1_BYTEWISE
+#include "crypto1_tables.h"
+#endif
+
 static inline uint32_t prng_successor(uint32_t x, uint32_t n);
+static inline uint32_t prng_seed_nonce(uint32_t nt);
 static inline int filter(uint32_t const x);
 static inline uint8_t evenparity32(uint32_t x);
 static inline void update_contribution(unsigned int data[], int item, int mask1, int mask2);
@@ -28,6 +38,12 @@ static uint32_t crypt_word_par(
     uint32_t nt_plain,
     uint8_t* parity_keystream_bits);
 static inline void rollback_word_noret(struct Crypto1State* s, uint32_t in, int x);
+#if CRYPTO1_BYTEWISE
+static inline uint8_t crypt_byte_feedin(struct Crypto1State* s, uint8_t in);
+static inline void crypt_byte_shift(struct Crypto1State* s, uint8_t feedin);
+static inline uint8_t crypt_byte(struct Crypto1State* s, uint8_t in, int x);
+static inline uint8_t rollback_byte(struct Crypto1State* s, uint8_t in, int fb);
+#endif
 static inline uint8_t napi_lfsr_rollback_bit(struct Crypto1State* s, uint32_t in, int fb);
 static inline uint32_t napi_lfsr_rollback_word(struct Crypto1State* s, uint32_t in, int fb);
 
@@ -90,9 +106,76 @@ static inline void update_contribution(unsigned int data[], int item, int mask1,
     data[item] = p << 24 | (data[item] & 0xffffff);
 }
 
+#if CRYPTO1_BYTEWISE
+// Feedback bits of the next 8 steps without the keystream fed back, bit k for step k
+static inline uint8_t crypt_byte_feedin(struct Crypto1State* s, uint8_t in) {
+    return crypto1_forward_odd[0][s->odd & 0xff] ^ crypto1_forward_odd[1][s->odd >> 8 & 0xff] ^
+           crypto1_forward_odd[2][s->odd >> 16 & 0xff] ^ crypto1_forward_even[0][s->even & 0xff] ^
+           crypto1_forward_even[1][s->even >> 8 & 0xff] ^
+           crypto1_forward_even[2][s->even >> 16 & 0xff] ^ crypto1_forward_in[in];
+}
+
+// Shifts 8 known feedback bits into the LFSR at once
+static inline void crypt_byte_shift(struct Crypto1State* s, uint8_t feedin) {
+    s->odd = s->odd << 4 | BIT(feedin, 1) << 3 | BIT(feedin, 3) << 2 | BIT(feedin, 5) << 1 |
+             BIT(feedin, 7);
+    s->even = s->even << 4 | BIT(feedin, 0) << 3 | BIT(feedin, 2) << 2 | BIT(feedin, 4) << 1 |
+              BIT(feedin, 6);
+}
+
+// 8 steps of crypt_word_ret(), in and the returned keystream hold step k in bit k
+static inline uint8_t crypt_byte(struct Crypto1State* s, uint8_t in, int x) {
+    uint32_t odd = s->odd, even = s->even, t;
+    uint8_t ret = 0, f;
+    uint8_t feedin = crypt_byte_feedin(s, in);
+    if(!x) {
+        // The intermediate states are all known, filter them from the shifted halves
+        crypt_byte_shift(s, feedin);
+        return filter(odd) | filter(s->even >> 3) << 1 | filter(s->odd >> 3) << 2 |
+               filter(s->even >> 2) << 3 | filter(s->odd >> 2) << 4 | filter(s->even >> 1) << 5 |
+               filter(s->odd >> 1) << 6 | filter(s->even) << 7;
+    }
+    for(int k = 0; k < 8; k++) {
+        f = filter(odd);
+        ret |= f << k;
+        // Keystream fed back into the LFSR acts like an extra input bit
+        feedin ^= crypto1_forward_in[1 << k] & (0 - f);
+        even = even << 1 | BIT(feedin, k);
+        t = odd, odd = even, even = t;
+    }
+    s->odd = odd;
+    s->even = even;
+    return ret;
+}
+
+// 8 steps of napi_lfsr_rollback_word(), in and the returned keystream hold step k in bit 7 - k
+static inline uint8_t rollback_byte(struct Crypto1State* s, uint8_t in, int fb) {
+    uint32_t odd = s->odd & 0xffffff, even = s->even & 0xffffff;
+    // Rolling back never reaches the bits it recovers, so the keystream is known upfront
+    uint8_t ret = filter(even) << 7 | filter(odd >> 1) << 6 | filter(even >> 1) << 5 |
+                  filter(odd >> 2) << 4 | filter(even >> 2) << 3 | filter(odd >> 3) << 2 |
+                  filter(even >> 3) << 1 | filter(odd >> 4);
+    uint8_t feedin = crypto1_rollback_odd[0][odd & 0xff] ^
+                     crypto1_rollback_odd[1][odd >> 8 & 0xff] ^
+                     crypto1_rollback_odd[2][odd >> 16] ^ crypto1_rollback_even[0][even & 0xff] ^
+                     crypto1_rollback_even[1][even >> 8 & 0xff] ^
+                     crypto1_rollback_even[2][even >> 16] ^
+                     crypto1_rollback_in[in ^ (ret & (0 - !!fb))];
+    s->odd = odd >> 4 | (uint32_t)(feedin & 0xf) << 20;
+    s->even = even >> 4 | (uint32_t)(feedin >> 4) << 20;
+    return ret;
+}
+#endif
+
 static inline uint32_t crypt_word(struct Crypto1State* s) {
     // "in" and "x" are always 0 (last iteration)
     uint32_t res_ret = 0;
+#if CRYPTO1_BYTEWISE
+    for(int i = 24; i >= 0; i -= 8) {
+        res_ret |= (uint32_t)crypt_byte(s, 0, 0) << i;
+    }
+    return res_ret;
+#else
     uint32_t feedin, t;
     for(int i = 0; i <= 31; i++) {
         res_ret |= (filter(s->odd) << (24 ^ i)); //-V629
@@ -102,9 +185,19 @@ static inline uint32_t crypt_word(struct Crypto1State* s) {
         t = s->odd, s->odd = s->even, s->even = t;
     }
     return res_ret;
+#endif
 }
 
 static inline void crypt_word_noret(struct Crypto1State* s, uint32_t in, int x) {
+#if CRYPTO1_BYTEWISE
+    for(int i = 24; i >= 0; i -= 8) {
+        if(x) {
+            crypt_byte(s, in >> i, x);
+        } else {
+            crypt_byte_shift(s, crypt_byte_feedin(s, in >> i));
+        }
+    }
+#else
     uint8_t ret;
     uint32_t feedin, t, next_in;
     for(int i = 0; i <= 31; i++) {
@@ -117,11 +210,17 @@ static inline void crypt_word_noret(struct Crypto1State* s, uint32_t in, int x)
         s->even = s->even << 1 | (evenparity32(feedin));
         t = s->odd, s->odd = s->even, s->even = t;
     }
+#endif
     return;
 }
 
 static inline uint32_t crypt_word_ret(struct Crypto1State* s, uint32_t in, int x) {
     uint32_t ret = 0;
+#if CRYPTO1_BYTEWISE
+    for(int i = 24; i >= 0; i -= 8) {
+        ret |= (uint32_t)crypt_byte(s, in >> i, x) << i;
+    }
+#else
     uint32_t feedin, t, next_in;
     uint8_t next_ret;
     for(int i = 0; i <= 31; i++) {
@@ -135,6 +234,7 @@ static inline uint32_t crypt_word_ret(struct Crypto1State* s, uint32_t in, int x
         t = s->odd, s->odd = s->even, s->even = t;
         ret |= next_ret << (24 ^ i);
     }
+#endif
     return ret;
 }
 
@@ -167,6 +267,14 @@ static inline uint32_t crypt_word_par(
     uint32_t ret = 0;
     *parity_keystream_bits = 0; // Reset parity keystream bits
 
+#if CRYPTO1_BYTEWISE
+    for(int i = 0; i < 4; i++) {
+        ret |= (uint32_t)crypt_byte(s, in >> (24 - 8 * i), is_encrypted) << (24 - 8 * i);
+        // Save keystream parity bit
+        *parity_keystream_bits |=
+            (filter(s->odd) ^ nfc_util_even_parity8(get_nth_byte(nt_plain, i))) << (3 - i);
+    }
+#else
     for(int i = 0; i < 32; i++) {
         uint8_t bit = crypt_bit(s, BEBIT(in, i), is_encrypted);
         ret |= bit << (24 ^ i);
@@ -177,10 +285,16 @@ static inline uint32_t crypt_word_par(
                 << (3 - (i / 8));
         }
     }
+#endif
     return ret;
 }
 
 static inline void rollback_word_noret(struct Crypto1State* s, uint32_t in, int x) {
+#if CRYPTO1_BYTEWISE
+    for(int i = 0; i <= 24; i += 8) {
+        rollback_byte(s, in >> i, x);
+    }
+#else
     uint8_t ret;
     uint32_t feedin, t, next_in;
     for(int i = 31; i >= 0; i--) {
@@ -195,6 +309,7 @@ static inline void rollback_word_noret(struct Crypto1State* s, uint32_t in, int
         feedin ^= !!next_in;
         s->even |= (evenparity32(feedin)) << 23;
     }
+#endif
     return;
 }
 
@@ -241,8 +356,13 @@ uint8_t napi_lfsr_rollback_bit(struct Crypto1State* s, uint32_t in, int fb) {
 uint32_t napi_lfsr_rollback_word(struct Crypto1State* s, uint32_t in, int fb) {
     int i;
     uint32_t ret = 0;
+#if CRYPTO1_BYTEWISE
+    for(i = 0; i <= 24; i += 8)
+        ret |= (uint32_t)rollback_byte(s, in >> i, fb) << i;
+#else
     for(i = 31; i >= 0; --i)
         ret |= napi_lfsr_rollback_bit(s, BEBIT(in, i), fb) << (i ^ 24);
+#endif
     return ret;
 }
 
@@ -253,4 +373,10 @@ static inline uint32_t prng_successor(uint32_t x, uint32_t n) {
     return SWAPENDIAN(x);
 }
 
+// The tag's PRNG is a 16-bit LFSR, so the upper half of a nonce (seednt16) fixes the lower
+// half. Returns nt with its lower half generated from its upper half.
+static inline uint32_t prng_seed_nonce(uint32_t nt) {
+    return (nt & 0xffff0000) | (prng_successor(nt >> 16, 16) & 0xffff);
+}
+
 #endif // CRYPTO1_H
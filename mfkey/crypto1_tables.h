@@ -0,0 +1,358 @@
+// Generated by host/crypto1_tables_gen.c, do not edit
+
+#ifndef CRYPTO1_TABLES_H
+#define CRYPTO1_TABLES_H
+
+#include <stdint.h>
+
+static const uint8_t crypto1_forward_odd[3][256] = {
+    {
+        0x00, 0x70, 0xdc, 0xac, 0xb7, 0xc7, 0x6b, 0x1b, 0x25, 0x55, 0xf9, 0x89,
+        0x92, 0xe2, 0x4e, 0x3e, 0xf1, 0x81, 0x2d, 0x5d, 0x46, 0x36, 0x9a, 0xea,
+        0xd4, 0xa4, 0x08, 0x78, 0x63, 0x13, 0xbf, 0xcf, 0x84, 0xf4, 0x58, 0x28,
+        0x33, 0x43, 0xef, 0x9f, 0xa1, 0xd1, 0x7d, 0x0d, 0x16, 0x66, 0xca, 0xba,
+        0x75, 0x05, 0xa9, 0xd9, 0xc2, 0xb2, 0x1e, 0x6e, 0x50, 0x20, 0x8c, 0xfc,
+        0xe7, 0x97, 0x3b, 0x4b, 0xa1, 0xd1, 0x7d, 0x0d, 0x16, 0x66, 0xca, 0xba,
+        0x84, 0xf4, 0x58, 0x28, 0x33, 0x43, 0xef, 0x9f, 0x50, 0x20, 0x8c, 0xfc,
+        0xe7, 0x97, 0x3b, 0x4b, 0x75, 0x05, 0xa9, 0xd9, 0xc2, 0xb2, 0x1e, 0x6e,
+        0x25, 0x55, 0xf9, 0x89, 0x92, 0xe2, 0x4e, 0x3e, 0x00, 0x70, 0xdc, 0xac,
+        0xb7, 0xc7, 0x6b, 0x1b, 0xd4, 0xa4, 0x08, 0x78, 0x63, 0x13, 0xbf, 0xcf,
+        0xf1, 0x81, 0x2d, 0x5d, 0x46, 0x36, 0x9a, 0xea, 0x50, 0x20, 0x8c, 0xfc,
+        0xe7, 0x97, 0x3b, 0x4b, 0x75, 0x05, 0xa9, 0xd9, 0xc2, 0xb2, 0x1e, 0x6e,
+        0xa1, 0xd1, 0x7d, 0x0d, 0x16, 0x66, 0xca, 0xba, 0x84, 0xf4, 0x58, 0x28,
+        0x33, 0x43, 0xef, 0x9f, 0xd4, 0xa4, 0x08, 0x78, 0x63, 0x13, 0xbf, 0xcf,
+        0xf1, 0x81, 0x2d, 0x5d, 0x46, 0x36, 0x9a, 0xea, 0x25, 0x55, 0xf9, 0x89,
+        0x92, 0xe2, 0x4e, 0x3e, 0x00, 0x70, 0xdc, 0xac, 0xb7, 0xc7, 0x6b, 0x1b,
+        0xf1, 0x81, 0x2d, 0x5d, 0x46, 0x36, 0x9a, 0xea, 0xd4, 0xa4, 0x08, 0x78,
+        0x63, 0x13, 0xbf, 0xcf, 0x00, 0x70, 0xdc, 0xac, 0xb7, 0xc7, 0x6b, 0x1b,
+        0x25, 0x55, 0xf9, 0x89, 0x92, 0xe2, 0x4e, 0x3e, 0x75, 0x05, 0xa9, 0xd9,
+        0xc2, 0xb2, 0x1e, 0x6e, 0x50, 0x20, 0x8c, 0xfc, 0xe7, 0x97, 0x3b, 0x4b,
+        0x84, 0xf4, 0x58, 0x28, 0x33, 0x43, 0xef, 0x9f, 0xa1, 0xd1, 0x7d, 0x0d,
+        0x16, 0x66, 0xca, 0xba,
+    },
+    {
+        0x00, 0x54, 0x55, 0x01, 0x6d, 0x39, 0x38, 0x6c, 0x63, 0x37, 0x36, 0x62,
+        0x0e, 0x5a, 0x5b, 0x0f, 0x50, 0x04, 0x05, 0x51, 0x3d, 0x69, 0x68, 0x3c,
+        0x33, 0x67, 0x66, 0x32, 0x5e, 0x0a, 0x0b, 0x5f, 0x54, 0x00, 0x01, 0x55,
+        0x39, 0x6d, 0x6c, 0x38, 0x37, 0x63, 0x62, 0x36, 0x5a, 0x0e, 0x0f, 0x5b,
+        0x04, 0x50, 0x51, 0x05, 0x69, 0x3d, 0x3c, 0x68, 0x67, 0x33, 0x32, 0x66,
+        0x0a, 0x5e, 0x5f, 0x0b, 0xd5, 0x81, 0x80, 0xd4, 0xb8, 0xec, 0xed, 0xb9,
+        0xb6, 0xe2, 0xe3, 0xb7, 0xdb, 0x8f, 0x8e, 0xda, 0x85, 0xd1, 0xd0, 0x84,
+        0xe8, 0xbc, 0xbd, 0xe9, 0xe6, 0xb2, 0xb3, 0xe7, 0x8b, 0xdf, 0xde, 0x8a,
+        0x81, 0xd5, 0xd4, 0x80, 0xec, 0xb8, 0xb9, 0xed, 0xe2, 0xb6, 0xb7, 0xe3,
+        0x8f, 0xdb, 0xda, 0x8e, 0xd1, 0x85, 0x84, 0xd0, 0xbc, 0xe8, 0xe9, 0xbd,
+        0xb2, 0xe6, 0xe7, 0xb3, 0xdf, 0x8b, 0x8a, 0xde, 0xcd, 0x99, 0x98, 0xcc,
+        0xa0, 0xf4, 0xf5, 0xa1, 0xae, 0xfa, 0xfb, 0xaf, 0xc3, 0x97, 0x96, 0xc2,
+        0x9d, 0xc9, 0xc8, 0x9c, 0xf0, 0xa4, 0xa5, 0xf1, 0xfe, 0xaa, 0xab, 0xff,
+        0x93, 0xc7, 0xc6, 0x92, 0x99, 0xcd, 0xcc, 0x98, 0xf4, 0xa0, 0xa1, 0xf5,
+        0xfa, 0xae, 0xaf, 0xfb, 0x97, 0xc3, 0xc2, 0x96, 0xc9, 0x9d, 0x9c, 0xc8,
+        0xa4, 0xf0, 0xf1, 0xa5, 0xaa, 0xfe, 0xff, 0xab, 0xc7, 0x93, 0x92, 0xc6,
+        0x18, 0x4c, 0x4d, 0x19, 0x75, 0x21, 0x20, 0x74, 0x7b, 0x2f, 0x2e, 0x7a,
+        0x16, 0x42, 0x43, 0x17, 0x48, 0x1c, 0x1d, 0x49, 0x25, 0x71, 0x70, 0x24,
+        0x2b, 0x7f, 0x7e, 0x2a, 0x46, 0x12, 0x13, 0x47, 0x4c, 0x18, 0x19, 0x4d,
+        0x21, 0x75, 0x74, 0x20, 0x2f, 0x7b, 0x7a, 0x2e, 0x42, 0x16, 0x17, 0x43,
+        0x1c, 0x48, 0x49, 0x1d, 0x71, 0x25, 0x24, 0x70, 0x7f, 0x2b, 0x2a, 0x7e,
+        0x12, 0x46, 0x47, 0x13,
+    },
+    {
+        0x00, 0x4b, 0xda, 0x91, 0x06, 0x4d, 0xdc, 0x97, 0xf1, 0xba, 0x2b, 0x60,
+        0xf7, 0xbc, 0x2d, 0x66, 0x04, 0x4f, 0xde, 0x95, 0x02, 0x49, 0xd8, 0x93,
+        0xf5, 0xbe, 0x2f, 0x64, 0xf3, 0xb8, 0x29, 0x62, 0xc1, 0x8a, 0x1b, 0x50,
+        0xc7, 0x8c, 0x1d, 0x56, 0x30, 0x7b, 0xea, 0xa1, 0x36, 0x7d, 0xec, 0xa7,
+        0xc5, 0x8e, 0x1f, 0x54, 0xc3, 0x88, 0x19, 0x52, 0x34, 0x7f, 0xee, 0xa5,
+        0x32, 0x79, 0xe8, 0xa3, 0x08, 0x43, 0xd2, 0x99, 0x0e, 0x45, 0xd4, 0x9f,
+        0xf9, 0xb2, 0x23, 0x68, 0xff, 0xb4, 0x25, 0x6e, 0x0c, 0x47, 0xd6, 0x9d,
+        0x0a, 0x41, 0xd0, 0x9b, 0xfd, 0xb6, 0x27, 0x6c, 0xfb, 0xb0, 0x21, 0x6a,
+        0xc9, 0x82, 0x13, 0x58, 0xcf, 0x84, 0x15, 0x5e, 0x38, 0x73, 0xe2, 0xa9,
+        0x3e, 0x75, 0xe4, 0xaf, 0xcd, 0x86, 0x17, 0x5c, 0xcb, 0x80, 0x11, 0x5a,
+        0x3c, 0x77, 0xe6, 0xad, 0x3a, 0x71, 0xe0, 0xab, 0xc2, 0x89, 0x18, 0x53,
+        0xc4, 0x8f, 0x1e, 0x55, 0x33, 0x78, 0xe9, 0xa2, 0x35, 0x7e, 0xef, 0xa4,
+        0xc6, 0x8d, 0x1c, 0x57, 0xc0, 0x8b, 0x1a, 0x51, 0x37, 0x7c, 0xed, 0xa6,
+        0x31, 0x7a, 0xeb, 0xa0, 0x03, 0x48, 0xd9, 0x92, 0x05, 0x4e, 0xdf, 0x94,
+        0xf2, 0xb9, 0x28, 0x63, 0xf4, 0xbf, 0x2e, 0x65, 0x07, 0x4c, 0xdd, 0x96,
+        0x01, 0x4a, 0xdb, 0x90, 0xf6, 0xbd, 0x2c, 0x67, 0xf0, 0xbb, 0x2a, 0x61,
+        0xca, 0x81, 0x10, 0x5b, 0xcc, 0x87, 0x16, 0x5d, 0x3b, 0x70, 0xe1, 0xaa,
+        0x3d, 0x76, 0xe7, 0xac, 0xce, 0x85, 0x14, 0x5f, 0xc8, 0x83, 0x12, 0x59,
+        0x3f, 0x74, 0xe5, 0xae, 0x39, 0x72, 0xe3, 0xa8, 0x0b, 0x40, 0xd1, 0x9a,
+        0x0d, 0x46, 0xd7, 0x9c, 0xfa, 0xb1, 0x20, 0x6b, 0xfc, 0xb7, 0x26, 0x6d,
+        0x0f, 0x44, 0xd5, 0x9e, 0x09, 0x42, 0xd3, 0x98, 0xfe, 0xb5, 0x24, 0x6f,
+        0xf8, 0xb3, 0x22, 0x69,
+    },
+};
+
+static const uint8_t crypto1_forward_even[3][256] = {
+    {
+        0x00, 0xb8, 0x6e, 0xd6, 0xab, 0x13, 0xc5, 0x7d, 0xe2, 0x5a, 0x8c, 0x34,
+        0x49, 0xf1, 0x27, 0x9f, 0x08, 0xb0, 0x66, 0xde, 0xa3, 0x1b, 0xcd, 0x75,
+        0xea, 0x52, 0x84, 0x3c, 0x41, 0xf9, 0x2f, 0x97, 0x42, 0xfa, 0x2c, 0x94,
+        0xe9, 0x51, 0x87, 0x3f, 0xa0, 0x18, 0xce, 0x76, 0x0b, 0xb3, 0x65, 0xdd,
+        0x4a, 0xf2, 0x24, 0x9c, 0xe1, 0x59, 0x8f, 0x37, 0xa8, 0x10, 0xc6, 0x7e,
+        0x03, 0xbb, 0x6d, 0xd5, 0xa0, 0x18, 0xce, 0x76, 0x0b, 0xb3, 0x65, 0xdd,
+        0x42, 0xfa, 0x2c, 0x94, 0xe9, 0x51, 0x87, 0x3f, 0xa8, 0x10, 0xc6, 0x7e,
+        0x03, 0xbb, 0x6d, 0xd5, 0x4a, 0xf2, 0x24, 0x9c, 0xe1, 0x59, 0x8f, 0x37,
+        0xe2, 0x5a, 0x8c, 0x34, 0x49, 0xf1, 0x27, 0x9f, 0x00, 0xb8, 0x6e, 0xd6,
+        0xab, 0x13, 0xc5, 0x7d, 0xea, 0x52, 0x84, 0x3c, 0x41, 0xf9, 0x2f, 0x97,
+        0x08, 0xb0, 0x66, 0xde, 0xa3, 0x1b, 0xcd, 0x75, 0xa8, 0x10, 0xc6, 0x7e,
+        0x03, 0xbb, 0x6d, 0xd5, 0x4a, 0xf2, 0x24, 0x9c, 0xe1, 0x59, 0x8f, 0x37,
+        0xa0, 0x18, 0xce, 0x76, 0x0b, 0xb3, 0x65, 0xdd, 0x42, 0xfa, 0x2c, 0x94,
+        0xe9, 0x51, 0x87, 0x3f, 0xea, 0x52, 0x84, 0x3c, 0x41, 0xf9, 0x2f, 0x97,
+        0x08, 0xb0, 0x66, 0xde, 0xa3, 0x1b, 0xcd, 0x75, 0xe2, 0x5a, 0x8c, 0x34,
+        0x49, 0xf1, 0x27, 0x9f, 0x00, 0xb8, 0x6e, 0xd6, 0xab, 0x13, 0xc5, 0x7d,
+        0x08, 0xb0, 0x66, 0xde, 0xa3, 0x1b, 0xcd, 0x75, 0xea, 0x52, 0x84, 0x3c,
+        0x41, 0xf9, 0x2f, 0x97, 0x00, 0xb8, 0x6e, 0xd6, 0xab, 0x13, 0xc5, 0x7d,
+        0xe2, 0x5a, 0x8c, 0x34, 0x49, 0xf1, 0x27, 0x9f, 0x4a, 0xf2, 0x24, 0x9c,
+        0xe1, 0x59, 0x8f, 0x37, 0xa8, 0x10, 0xc6, 0x7e, 0x03, 0xbb, 0x6d, 0xd5,
+        0x42, 0xfa, 0x2c, 0x94, 0xe9, 0x51, 0x87, 0x3f, 0xa0, 0x18, 0xce, 0x76,
+        0x0b, 0xb3, 0x65, 0xdd,
+    },
+    {
+        0x00, 0xaa, 0xda, 0x70, 0xc6, 0x6c, 0x1c, 0xb6, 0x41, 0xeb, 0x9b, 0x31,
+        0x87, 0x2d, 0x5d, 0xf7, 0xa8, 0x02, 0x72, 0xd8, 0x6e, 0xc4, 0xb4, 0x1e,
+        0xe9, 0x43, 0x33, 0x99, 0x2f, 0x85, 0xf5, 0x5f, 0xaa, 0x00, 0x70, 0xda,
+        0x6c, 0xc6, 0xb6, 0x1c, 0xeb, 0x41, 0x31, 0x9b, 0x2d, 0x87, 0xf7, 0x5d,
+        0x02, 0xa8, 0xd8, 0x72, 0xc4, 0x6e, 0x1e, 0xb4, 0x43, 0xe9, 0x99, 0x33,
+        0x85, 0x2f, 0x5f, 0xf5, 0x9a, 0x30, 0x40, 0xea, 0x5c, 0xf6, 0x86, 0x2c,
+        0xdb, 0x71, 0x01, 0xab, 0x1d, 0xb7, 0xc7, 0x6d, 0x32, 0x98, 0xe8, 0x42,
+        0xf4, 0x5e, 0x2e, 0x84, 0x73, 0xd9, 0xa9, 0x03, 0xb5, 0x1f, 0x6f, 0xc5,
+        0x30, 0x9a, 0xea, 0x40, 0xf6, 0x5c, 0x2c, 0x86, 0x71, 0xdb, 0xab, 0x01,
+        0xb7, 0x1d, 0x6d, 0xc7, 0x98, 0x32, 0x42, 0xe8, 0x5e, 0xf4, 0x84, 0x2e,
+        0xd9, 0x73, 0x03, 0xa9, 0x1f, 0xb5, 0xc5, 0x6f, 0x96, 0x3c, 0x4c, 0xe6,
+        0x50, 0xfa, 0x8a, 0x20, 0xd7, 0x7d, 0x0d, 0xa7, 0x11, 0xbb, 0xcb, 0x61,
+        0x3e, 0x94, 0xe4, 0x4e, 0xf8, 0x52, 0x22, 0x88, 0x7f, 0xd5, 0xa5, 0x0f,
+        0xb9, 0x13, 0x63, 0xc9, 0x3c, 0x96, 0xe6, 0x4c, 0xfa, 0x50, 0x20, 0x8a,
+        0x7d, 0xd7, 0xa7, 0x0d, 0xbb, 0x11, 0x61, 0xcb, 0x94, 0x3e, 0x4e, 0xe4,
+        0x52, 0xf8, 0x88, 0x22, 0xd5, 0x7f, 0x0f, 0xa5, 0x13, 0xb9, 0xc9, 0x63,
+        0x0c, 0xa6, 0xd6, 0x7c, 0xca, 0x60, 0x10, 0xba, 0x4d, 0xe7, 0x97, 0x3d,
+        0x8b, 0x21, 0x51, 0xfb, 0xa4, 0x0e, 0x7e, 0xd4, 0x62, 0xc8, 0xb8, 0x12,
+        0xe5, 0x4f, 0x3f, 0x95, 0x23, 0x89, 0xf9, 0x53, 0xa6, 0x0c, 0x7c, 0xd6,
+        0x60, 0xca, 0xba, 0x10, 0xe7, 0x4d, 0x3d, 0x97, 0x21, 0x8b, 0xfb, 0x51,
+        0x0e, 0xa4, 0xd4, 0x7e, 0xc8, 0x62, 0x12, 0xb8, 0x4f, 0xe5, 0x95, 0x3f,
+        0x89, 0x23, 0x53, 0xf9,
+    },
+    {
+        0x00, 0x55, 0xed, 0xb8, 0x03, 0x56, 0xee, 0xbb, 0x08, 0x5d, 0xe5, 0xb0,
+        0x0b, 0x5e, 0xe6, 0xb3, 0x82, 0xd7, 0x6f, 0x3a, 0x81, 0xd4, 0x6c, 0x39,
+        0x8a, 0xdf, 0x67, 0x32, 0x89, 0xdc, 0x64, 0x31, 0x10, 0x45, 0xfd, 0xa8,
+        0x13, 0x46, 0xfe, 0xab, 0x18, 0x4d, 0xf5, 0xa0, 0x1b, 0x4e, 0xf6, 0xa3,
+        0x92, 0xc7, 0x7f, 0x2a, 0x91, 0xc4, 0x7c, 0x29, 0x9a, 0xcf, 0x77, 0x22,
+        0x99, 0xcc, 0x74, 0x21, 0x84, 0xd1, 0x69, 0x3c, 0x87, 0xd2, 0x6a, 0x3f,
+        0x8c, 0xd9, 0x61, 0x34, 0x8f, 0xda, 0x62, 0x37, 0x06, 0x53, 0xeb, 0xbe,
+        0x05, 0x50, 0xe8, 0xbd, 0x0e, 0x5b, 0xe3, 0xb6, 0x0d, 0x58, 0xe0, 0xb5,
+        0x94, 0xc1, 0x79, 0x2c, 0x97, 0xc2, 0x7a, 0x2f, 0x9c, 0xc9, 0x71, 0x24,
+        0x9f, 0xca, 0x72, 0x27, 0x16, 0x43, 0xfb, 0xae, 0x15, 0x40, 0xf8, 0xad,
+        0x1e, 0x4b, 0xf3, 0xa6, 0x1d, 0x48, 0xf0, 0xa5, 0xe1, 0xb4, 0x0c, 0x59,
+        0xe2, 0xb7, 0x0f, 0x5a, 0xe9, 0xbc, 0x04, 0x51, 0xea, 0xbf, 0x07, 0x52,
+        0x63, 0x36, 0x8e, 0xdb, 0x60, 0x35, 0x8d, 0xd8, 0x6b, 0x3e, 0x86, 0xd3,
+        0x68, 0x3d, 0x85, 0xd0, 0xf1, 0xa4, 0x1c, 0x49, 0xf2, 0xa7, 0x1f, 0x4a,
+        0xf9, 0xac, 0x14, 0x41, 0xfa, 0xaf, 0x17, 0x42, 0x73, 0x26, 0x9e, 0xcb,
+        0x70, 0x25, 0x9d, 0xc8, 0x7b, 0x2e, 0x96, 0xc3, 0x78, 0x2d, 0x95, 0xc0,
+        0x65, 0x30, 0x88, 0xdd, 0x66, 0x33, 0x8b, 0xde, 0x6d, 0x38, 0x80, 0xd5,
+        0x6e, 0x3b, 0x83, 0xd6, 0xe7, 0xb2, 0x0a, 0x5f, 0xe4, 0xb1, 0x09, 0x5c,
+        0xef, 0xba, 0x02, 0x57, 0xec, 0xb9, 0x01, 0x54, 0x75, 0x20, 0x98, 0xcd,
+        0x76, 0x23, 0x9b, 0xce, 0x7d, 0x28, 0x90, 0xc5, 0x7e, 0x2b, 0x93, 0xc6,
+        0xf7, 0xa2, 0x1a, 0x4f, 0xf4, 0xa1, 0x19, 0x4c, 0xff, 0xaa, 0x12, 0x47,
+        0xfc, 0xa9, 0x11, 0x44,
+    },
+};
+
+static const uint8_t crypto1_forward_in[256] = {
+    0x00, 0xe1, 0xc2, 0x23, 0x84, 0x65, 0x46, 0xa7, 0x08, 0xe9, 0xca, 0x2b,
+    0x8c, 0x6d, 0x4e, 0xaf, 0x10, 0xf1, 0xd2, 0x33, 0x94, 0x75, 0x56, 0xb7,
+    0x18, 0xf9, 0xda, 0x3b, 0x9c, 0x7d, 0x5e, 0xbf, 0x20, 0xc1, 0xe2, 0x03,
+    0xa4, 0x45, 0x66, 0x87, 0x28, 0xc9, 0xea, 0x0b, 0xac, 0x4d, 0x6e, 0x8f,
+    0x30, 0xd1, 0xf2, 0x13, 0xb4, 0x55, 0x76, 0x97, 0x38, 0xd9, 0xfa, 0x1b,
+    0xbc, 0x5d, 0x7e, 0x9f, 0x40, 0xa1, 0x82, 0x63, 0xc4, 0x25, 0x06, 0xe7,
+    0x48, 0xa9, 0x8a, 0x6b, 0xcc, 0x2d, 0x0e, 0xef, 0x50, 0xb1, 0x92, 0x73,
+    0xd4, 0x35, 0x16, 0xf7, 0x58, 0xb9, 0x9a, 0x7b, 0xdc, 0x3d, 0x1e, 0xff,
+    0x60, 0x81, 0xa2, 0x43, 0xe4, 0x05, 0x26, 0xc7, 0x68, 0x89, 0xaa, 0x4b,
+    0xec, 0x0d, 0x2e, 0xcf, 0x70, 0x91, 0xb2, 0x53, 0xf4, 0x15, 0x36, 0xd7,
+    0x78, 0x99, 0xba, 0x5b, 0xfc, 0x1d, 0x3e, 0xdf, 0x80, 0x61, 0x42, 0xa3,
+    0x04, 0xe5, 0xc6, 0x27, 0x88, 0x69, 0x4a, 0xab, 0x0c, 0xed, 0xce, 0x2f,
+    0x90, 0x71, 0x52, 0xb3, 0x14, 0xf5, 0xd6, 0x37, 0x98, 0x79, 0x5a, 0xbb,
+    0x1c, 0xfd, 0xde, 0x3f, 0xa0, 0x41, 0x62, 0x83, 0x24, 0xc5, 0xe6, 0x07,
+    0xa8, 0x49, 0x6a, 0x8b, 0x2c, 0xcd, 0xee, 0x0f, 0xb0, 0x51, 0x72, 0x93,
+    0x34, 0xd5, 0xf6, 0x17, 0xb8, 0x59, 0x7a, 0x9b, 0x3c, 0xdd, 0xfe, 0x1f,
+    0xc0, 0x21, 0x02, 0xe3, 0x44, 0xa5, 0x86, 0x67, 0xc8, 0x29, 0x0a, 0xeb,
+    0x4c, 0xad, 0x8e, 0x6f, 0xd0, 0x31, 0x12, 0xf3, 0x54, 0xb5, 0x96, 0x77,
+    0xd8, 0x39, 0x1a, 0xfb, 0x5c, 0xbd, 0x9e, 0x7f, 0xe0, 0x01, 0x22, 0xc3,
+    0x64, 0x85, 0xa6, 0x47, 0xe8, 0x09, 0x2a, 0xcb, 0x6c, 0x8d, 0xae, 0x4f,
+    0xf0, 0x11, 0x32, 0xd3, 0x74, 0x95, 0xb6, 0x57, 0xf8, 0x19, 0x3a, 0xdb,
+    0x7c, 0x9d, 0xbe, 0x5f,
+};
+
+static const uint8_t crypto1_rollback_odd[3][256] = {
+    {
+        0x00, 0x41, 0x82, 0xc3, 0x04, 0x45, 0x86, 0xc7, 0x51, 0x10, 0xd3, 0x92,
+        0x55, 0x14, 0xd7, 0x96, 0xba, 0xfb, 0x38, 0x79, 0xbe, 0xff, 0x3c, 0x7d,
+        0xeb, 0xaa, 0x69, 0x28, 0xef, 0xae, 0x6d, 0x2c, 0x7c, 0x3d, 0xfe, 0xbf,
+        0x78, 0x39, 0xfa, 0xbb, 0x2d, 0x6c, 0xaf, 0xee, 0x29, 0x68, 0xab, 0xea,
+        0xc6, 0x87, 0x44, 0x05, 0xc2, 0x83, 0x40, 0x01, 0x97, 0xd6, 0x15, 0x54,
+        0x93, 0xd2, 0x11, 0x50, 0xe8, 0xa9, 0x6a, 0x2b, 0xec, 0xad, 0x6e, 0x2f,
+        0xb9, 0xf8, 0x3b, 0x7a, 0xbd, 0xfc, 0x3f, 0x7e, 0x52, 0x13, 0xd0, 0x91,
+        0x56, 0x17, 0xd4, 0x95, 0x03, 0x42, 0x81, 0xc0, 0x07, 0x46, 0x85, 0xc4,
+        0x94, 0xd5, 0x16, 0x57, 0x90, 0xd1, 0x12, 0x53, 0xc5, 0x84, 0x47, 0x06,
+        0xc1, 0x80, 0x43, 0x02, 0x2e, 0x6f, 0xac, 0xed, 0x2a, 0x6b, 0xa8, 0xe9,
+        0x7f, 0x3e, 0xfd, 0xbc, 0x7b, 0x3a, 0xf9, 0xb8, 0xd8, 0x99, 0x5a, 0x1b,
+        0xdc, 0x9d, 0x5e, 0x1f, 0x89, 0xc8, 0x0b, 0x4a, 0x8d, 0xcc, 0x0f, 0x4e,
+        0x62, 0x23, 0xe0, 0xa1, 0x66, 0x27, 0xe4, 0xa5, 0x33, 0x72, 0xb1, 0xf0,
+        0x37, 0x76, 0xb5, 0xf4, 0xa4, 0xe5, 0x26, 0x67, 0xa0, 0xe1, 0x22, 0x63,
+        0xf5, 0xb4, 0x77, 0x36, 0xf1, 0xb0, 0x73, 0x32, 0x1e, 0x5f, 0x9c, 0xdd,
+        0x1a, 0x5b, 0x98, 0xd9, 0x4f, 0x0e, 0xcd, 0x8c, 0x4b, 0x0a, 0xc9, 0x88,
+        0x30, 0x71, 0xb2, 0xf3, 0x34, 0x75, 0xb6, 0xf7, 0x61, 0x20, 0xe3, 0xa2,
+        0x65, 0x24, 0xe7, 0xa6, 0x8a, 0xcb, 0x08, 0x49, 0x8e, 0xcf, 0x0c, 0x4d,
+        0xdb, 0x9a, 0x59, 0x18, 0xdf, 0x9e, 0x5d, 0x1c, 0x4c, 0x0d, 0xce, 0x8f,
+        0x48, 0x09, 0xca, 0x8b, 0x1d, 0x5c, 0x9f, 0xde, 0x19, 0x58, 0x9b, 0xda,
+        0xf6, 0xb7, 0x74, 0x35, 0xf2, 0xb3, 0x70, 0x31, 0xa7, 0xe6, 0x25, 0x64,
+        0xa3, 0xe2, 0x21, 0x60,
+    },
+    {
+        0x00, 0xa0, 0x40, 0xe0, 0x98, 0x38, 0xd8, 0x78, 0x38, 0x98, 0x78, 0xd8,
+        0xa0, 0x00, 0xe0, 0x40, 0x39, 0x99, 0x79, 0xd9, 0xa1, 0x01, 0xe1, 0x41,
+        0x01, 0xa1, 0x41, 0xe1, 0x99, 0x39, 0xd9, 0x79, 0x62, 0xc2, 0x22, 0x82,
+        0xfa, 0x5a, 0xba, 0x1a, 0x5a, 0xfa, 0x1a, 0xba, 0xc2, 0x62, 0x82, 0x22,
+        0x5b, 0xfb, 0x1b, 0xbb, 0xc3, 0x63, 0x83, 0x23, 0x63, 0xc3, 0x23, 0x83,
+        0xfb, 0x5b, 0xbb, 0x1b, 0xc4, 0x64, 0x84, 0x24, 0x5c, 0xfc, 0x1c, 0xbc,
+        0xfc, 0x5c, 0xbc, 0x1c, 0x64, 0xc4, 0x24, 0x84, 0xfd, 0x5d, 0xbd, 0x1d,
+        0x65, 0xc5, 0x25, 0x85, 0xc5, 0x65, 0x85, 0x25, 0x5d, 0xfd, 0x1d, 0xbd,
+        0xa6, 0x06, 0xe6, 0x46, 0x3e, 0x9e, 0x7e, 0xde, 0x9e, 0x3e, 0xde, 0x7e,
+        0x06, 0xa6, 0x46, 0xe6, 0x9f, 0x3f, 0xdf, 0x7f, 0x07, 0xa7, 0x47, 0xe7,
+        0xa7, 0x07, 0xe7, 0x47, 0x3f, 0x9f, 0x7f, 0xdf, 0x90, 0x30, 0xd0, 0x70,
+        0x08, 0xa8, 0x48, 0xe8, 0xa8, 0x08, 0xe8, 0x48, 0x30, 0x90, 0x70, 0xd0,
+        0xa9, 0x09, 0xe9, 0x49, 0x31, 0x91, 0x71, 0xd1, 0x91, 0x31, 0xd1, 0x71,
+        0x09, 0xa9, 0x49, 0xe9, 0xf2, 0x52, 0xb2, 0x12, 0x6a, 0xca, 0x2a, 0x8a,
+        0xca, 0x6a, 0x8a, 0x2a, 0x52, 0xf2, 0x12, 0xb2, 0xcb, 0x6b, 0x8b, 0x2b,
+        0x53, 0xf3, 0x13, 0xb3, 0xf3, 0x53, 0xb3, 0x13, 0x6b, 0xcb, 0x2b, 0x8b,
+        0x54, 0xf4, 0x14, 0xb4, 0xcc, 0x6c, 0x8c, 0x2c, 0x6c, 0xcc, 0x2c, 0x8c,
+        0xf4, 0x54, 0xb4, 0x14, 0x6d, 0xcd, 0x2d, 0x8d, 0xf5, 0x55, 0xb5, 0x15,
+        0x55, 0xf5, 0x15, 0xb5, 0xcd, 0x6d, 0x8d, 0x2d, 0x36, 0x96, 0x76, 0xd6,
+        0xae, 0x0e, 0xee, 0x4e, 0x0e, 0xae, 0x4e, 0xee, 0x96, 0x36, 0xd6, 0x76,
+        0x0f, 0xaf, 0x4f, 0xef, 0x97, 0x37, 0xd7, 0x77, 0x37, 0x97, 0x77, 0xd7,
+        0xaf, 0x0f, 0xef, 0x4f,
+    },
+    {
+        0x00, 0x38, 0x39, 0x01, 0x23, 0x1b, 0x1a, 0x22, 0x07, 0x3f, 0x3e, 0x06,
+        0x24, 0x1c, 0x1d, 0x25, 0x16, 0x2e, 0x2f, 0x17, 0x35, 0x0d, 0x0c, 0x34,
+        0x11, 0x29, 0x28, 0x10, 0x32, 0x0a, 0x0b, 0x33, 0x2c, 0x14, 0x15, 0x2d,
+        0x0f, 0x37, 0x36, 0x0e, 0x2b, 0x13, 0x12, 0x2a, 0x08, 0x30, 0x31, 0x09,
+        0x3a, 0x02, 0x03, 0x3b, 0x19, 0x21, 0x20, 0x18, 0x3d, 0x05, 0x04, 0x3c,
+        0x1e, 0x26, 0x27, 0x1f, 0x50, 0x68, 0x69, 0x51, 0x73, 0x4b, 0x4a, 0x72,
+        0x57, 0x6f, 0x6e, 0x56, 0x74, 0x4c, 0x4d, 0x75, 0x46, 0x7e, 0x7f, 0x47,
+        0x65, 0x5d, 0x5c, 0x64, 0x41, 0x79, 0x78, 0x40, 0x62, 0x5a, 0x5b, 0x63,
+        0x7c, 0x44, 0x45, 0x7d, 0x5f, 0x67, 0x66, 0x5e, 0x7b, 0x43, 0x42, 0x7a,
+        0x58, 0x60, 0x61, 0x59, 0x6a, 0x52, 0x53, 0x6b, 0x49, 0x71, 0x70, 0x48,
+        0x6d, 0x55, 0x54, 0x6c, 0x4e, 0x76, 0x77, 0x4f, 0xa0, 0x98, 0x99, 0xa1,
+        0x83, 0xbb, 0xba, 0x82, 0xa7, 0x9f, 0x9e, 0xa6, 0x84, 0xbc, 0xbd, 0x85,
+        0xb6, 0x8e, 0x8f, 0xb7, 0x95, 0xad, 0xac, 0x94, 0xb1, 0x89, 0x88, 0xb0,
+        0x92, 0xaa, 0xab, 0x93, 0x8c, 0xb4, 0xb5, 0x8d, 0xaf, 0x97, 0x96, 0xae,
+        0x8b, 0xb3, 0xb2, 0x8a, 0xa8, 0x90, 0x91, 0xa9, 0x9a, 0xa2, 0xa3, 0x9b,
+        0xb9, 0x81, 0x80, 0xb8, 0x9d, 0xa5, 0xa4, 0x9c, 0xbe, 0x86, 0x87, 0xbf,
+        0xf0, 0xc8, 0xc9, 0xf1, 0xd3, 0xeb, 0xea, 0xd2, 0xf7, 0xcf, 0xce, 0xf6,
+        0xd4, 0xec, 0xed, 0xd5, 0xe6, 0xde, 0xdf, 0xe7, 0xc5, 0xfd, 0xfc, 0xc4,
+        0xe1, 0xd9, 0xd8, 0xe0, 0xc2, 0xfa, 0xfb, 0xc3, 0xdc, 0xe4, 0xe5, 0xdd,
+        0xff, 0xc7, 0xc6, 0xfe, 0xdb, 0xe3, 0xe2, 0xda, 0xf8, 0xc0, 0xc1, 0xf9,
+        0xca, 0xf2, 0xf3, 0xcb, 0xe9, 0xd1, 0xd0, 0xe8, 0xcd, 0xf5, 0xf4, 0xcc,
+        0xee, 0xd6, 0xd7, 0xef,
+    },
+};
+
+static const uint8_t crypto1_rollback_even[3][256] = {
+    {
+        0x00, 0x18, 0x20, 0x38, 0x01, 0x19, 0x21, 0x39, 0x5b, 0x43, 0x7b, 0x63,
+        0x5a, 0x42, 0x7a, 0x62, 0xe7, 0xff, 0xc7, 0xdf, 0xe6, 0xfe, 0xc6, 0xde,
+        0xbc, 0xa4, 0x9c, 0x84, 0xbd, 0xa5, 0x9d, 0x85, 0xce, 0xd6, 0xee, 0xf6,
+        0xcf, 0xd7, 0xef, 0xf7, 0x95, 0x8d, 0xb5, 0xad, 0x94, 0x8c, 0xb4, 0xac,
+        0x29, 0x31, 0x09, 0x11, 0x28, 0x30, 0x08, 0x10, 0x72, 0x6a, 0x52, 0x4a,
+        0x73, 0x6b, 0x53, 0x4b, 0xcd, 0xd5, 0xed, 0xf5, 0xcc, 0xd4, 0xec, 0xf4,
+        0x96, 0x8e, 0xb6, 0xae, 0x97, 0x8f, 0xb7, 0xaf, 0x2a, 0x32, 0x0a, 0x12,
+        0x2b, 0x33, 0x0b, 0x13, 0x71, 0x69, 0x51, 0x49, 0x70, 0x68, 0x50, 0x48,
+        0x03, 0x1b, 0x23, 0x3b, 0x02, 0x1a, 0x22, 0x3a, 0x58, 0x40, 0x78, 0x60,
+        0x59, 0x41, 0x79, 0x61, 0xe4, 0xfc, 0xc4, 0xdc, 0xe5, 0xfd, 0xc5, 0xdd,
+        0xbf, 0xa7, 0x9f, 0x87, 0xbe, 0xa6, 0x9e, 0x86, 0x8a, 0x92, 0xaa, 0xb2,
+        0x8b, 0x93, 0xab, 0xb3, 0xd1, 0xc9, 0xf1, 0xe9, 0xd0, 0xc8, 0xf0, 0xe8,
+        0x6d, 0x75, 0x4d, 0x55, 0x6c, 0x74, 0x4c, 0x54, 0x36, 0x2e, 0x16, 0x0e,
+        0x37, 0x2f, 0x17, 0x0f, 0x44, 0x5c, 0x64, 0x7c, 0x45, 0x5d, 0x65, 0x7d,
+        0x1f, 0x07, 0x3f, 0x27, 0x1e, 0x06, 0x3e, 0x26, 0xa3, 0xbb, 0x83, 0x9b,
+        0xa2, 0xba, 0x82, 0x9a, 0xf8, 0xe0, 0xd8, 0xc0, 0xf9, 0xe1, 0xd9, 0xc1,
+        0x47, 0x5f, 0x67, 0x7f, 0x46, 0x5e, 0x66, 0x7e, 0x1c, 0x04, 0x3c, 0x24,
+        0x1d, 0x05, 0x3d, 0x25, 0xa0, 0xb8, 0x80, 0x98, 0xa1, 0xb9, 0x81, 0x99,
+        0xfb, 0xe3, 0xdb, 0xc3, 0xfa, 0xe2, 0xda, 0xc2, 0x89, 0x91, 0xa9, 0xb1,
+        0x88, 0x90, 0xa8, 0xb0, 0xd2, 0xca, 0xf2, 0xea, 0xd3, 0xcb, 0xf3, 0xeb,
+        0x6e, 0x76, 0x4e, 0x56, 0x6f, 0x77, 0x4f, 0x57, 0x35, 0x2d, 0x15, 0x0d,
+        0x34, 0x2c, 0x14, 0x0c,
+    },
+    {
+        0x00, 0x04, 0x49, 0x4d, 0xc3, 0xc7, 0x8a, 0x8e, 0xc7, 0xc3, 0x8e, 0x8a,
+        0x04, 0x00, 0x4d, 0x49, 0x96, 0x92, 0xdf, 0xdb, 0x55, 0x51, 0x1c, 0x18,
+        0x51, 0x55, 0x18, 0x1c, 0x92, 0x96, 0xdb, 0xdf, 0x2c, 0x28, 0x65, 0x61,
+        0xef, 0xeb, 0xa6, 0xa2, 0xeb, 0xef, 0xa2, 0xa6, 0x28, 0x2c, 0x61, 0x65,
+        0xba, 0xbe, 0xf3, 0xf7, 0x79, 0x7d, 0x30, 0x34, 0x7d, 0x79, 0x34, 0x30,
+        0xbe, 0xba, 0xf7, 0xf3, 0x09, 0x0d, 0x40, 0x44, 0xca, 0xce, 0x83, 0x87,
+        0xce, 0xca, 0x87, 0x83, 0x0d, 0x09, 0x44, 0x40, 0x9f, 0x9b, 0xd6, 0xd2,
+        0x5c, 0x58, 0x15, 0x11, 0x58, 0x5c, 0x11, 0x15, 0x9b, 0x9f, 0xd2, 0xd6,
+        0x25, 0x21, 0x6c, 0x68, 0xe6, 0xe2, 0xaf, 0xab, 0xe2, 0xe6, 0xab, 0xaf,
+        0x21, 0x25, 0x68, 0x6c, 0xb3, 0xb7, 0xfa, 0xfe, 0x70, 0x74, 0x39, 0x3d,
+        0x74, 0x70, 0x3d, 0x39, 0xb7, 0xb3, 0xfe, 0xfa, 0x43, 0x47, 0x0a, 0x0e,
+        0x80, 0x84, 0xc9, 0xcd, 0x84, 0x80, 0xcd, 0xc9, 0x47, 0x43, 0x0e, 0x0a,
+        0xd5, 0xd1, 0x9c, 0x98, 0x16, 0x12, 0x5f, 0x5b, 0x12, 0x16, 0x5b, 0x5f,
+        0xd1, 0xd5, 0x98, 0x9c, 0x6f, 0x6b, 0x26, 0x22, 0xac, 0xa8, 0xe5, 0xe1,
+        0xa8, 0xac, 0xe1, 0xe5, 0x6b, 0x6f, 0x22, 0x26, 0xf9, 0xfd, 0xb0, 0xb4,
+        0x3a, 0x3e, 0x73, 0x77, 0x3e, 0x3a, 0x77, 0x73, 0xfd, 0xf9, 0xb4, 0xb0,
+        0x4a, 0x4e, 0x03, 0x07, 0x89, 0x8d, 0xc0, 0xc4, 0x8d, 0x89, 0xc4, 0xc0,
+        0x4e, 0x4a, 0x07, 0x03, 0xdc, 0xd8, 0x95, 0x91, 0x1f, 0x1b, 0x56, 0x52,
+        0x1b, 0x1f, 0x52, 0x56, 0xd8, 0xdc, 0x91, 0x95, 0x66, 0x62, 0x2f, 0x2b,
+        0xa5, 0xa1, 0xec, 0xe8, 0xa1, 0xa5, 0xe8, 0xec, 0x62, 0x66, 0x2b, 0x2f,
+        0xf0, 0xf4, 0xb9, 0xbd, 0x33, 0x37, 0x7a, 0x7e, 0x37, 0x33, 0x7e, 0x7a,
+        0xf4, 0xf0, 0xbd, 0xb9,
+    },
+    {
+        0x00, 0xc7, 0x96, 0x51, 0x34, 0xf3, 0xa2, 0x65, 0x31, 0xf6, 0xa7, 0x60,
+        0x05, 0xc2, 0x93, 0x54, 0x62, 0xa5, 0xf4, 0x33, 0x56, 0x91, 0xc0, 0x07,
+        0x53, 0x94, 0xc5, 0x02, 0x67, 0xa0, 0xf1, 0x36, 0x85, 0x42, 0x13, 0xd4,
+        0xb1, 0x76, 0x27, 0xe0, 0xb4, 0x73, 0x22, 0xe5, 0x80, 0x47, 0x16, 0xd1,
+        0xe7, 0x20, 0x71, 0xb6, 0xd3, 0x14, 0x45, 0x82, 0xd6, 0x11, 0x40, 0x87,
+        0xe2, 0x25, 0x74, 0xb3, 0x0a, 0xcd, 0x9c, 0x5b, 0x3e, 0xf9, 0xa8, 0x6f,
+        0x3b, 0xfc, 0xad, 0x6a, 0x0f, 0xc8, 0x99, 0x5e, 0x68, 0xaf, 0xfe, 0x39,
+        0x5c, 0x9b, 0xca, 0x0d, 0x59, 0x9e, 0xcf, 0x08, 0x6d, 0xaa, 0xfb, 0x3c,
+        0x8f, 0x48, 0x19, 0xde, 0xbb, 0x7c, 0x2d, 0xea, 0xbe, 0x79, 0x28, 0xef,
+        0x8a, 0x4d, 0x1c, 0xdb, 0xed, 0x2a, 0x7b, 0xbc, 0xd9, 0x1e, 0x4f, 0x88,
+        0xdc, 0x1b, 0x4a, 0x8d, 0xe8, 0x2f, 0x7e, 0xb9, 0x04, 0xc3, 0x92, 0x55,
+        0x30, 0xf7, 0xa6, 0x61, 0x35, 0xf2, 0xa3, 0x64, 0x01, 0xc6, 0x97, 0x50,
+        0x66, 0xa1, 0xf0, 0x37, 0x52, 0x95, 0xc4, 0x03, 0x57, 0x90, 0xc1, 0x06,
+        0x63, 0xa4, 0xf5, 0x32, 0x81, 0x46, 0x17, 0xd0, 0xb5, 0x72, 0x23, 0xe4,
+        0xb0, 0x77, 0x26, 0xe1, 0x84, 0x43, 0x12, 0xd5, 0xe3, 0x24, 0x75, 0xb2,
+        0xd7, 0x10, 0x41, 0x86, 0xd2, 0x15, 0x44, 0x83, 0xe6, 0x21, 0x70, 0xb7,
+        0x0e, 0xc9, 0x98, 0x5f, 0x3a, 0xfd, 0xac, 0x6b, 0x3f, 0xf8, 0xa9, 0x6e,
+        0x0b, 0xcc, 0x9d, 0x5a, 0x6c, 0xab, 0xfa, 0x3d, 0x58, 0x9f, 0xce, 0x09,
+        0x5d, 0x9a, 0xcb, 0x0c, 0x69, 0xae, 0xff, 0x38, 0x8b, 0x4c, 0x1d, 0xda,
+        0xbf, 0x78, 0x29, 0xee, 0xba, 0x7d, 0x2c, 0xeb, 0x8e, 0x49, 0x18, 0xdf,
+        0xe9, 0x2e, 0x7f, 0xb8, 0xdd, 0x1a, 0x4b, 0x8c, 0xd8, 0x1f, 0x4e, 0x89,
+        0xec, 0x2b, 0x7a, 0xbd,
+    },
+};
+
+static const uint8_t crypto1_rollback_in[256] = {
+    0x00, 0x80, 0x08, 0x88, 0x40, 0xc0, 0x48, 0xc8, 0x04, 0x84, 0x0c, 0x8c,
+    0x44, 0xc4, 0x4c, 0xcc, 0x20, 0xa0, 0x28, 0xa8, 0x60, 0xe0, 0x68, 0xe8,
+    0x24, 0xa4, 0x2c, 0xac, 0x64, 0xe4, 0x6c, 0xec, 0x82, 0x02, 0x8a, 0x0a,
+    0xc2, 0x42, 0xca, 0x4a, 0x86, 0x06, 0x8e, 0x0e, 0xc6, 0x46, 0xce, 0x4e,
+    0xa2, 0x22, 0xaa, 0x2a, 0xe2, 0x62, 0xea, 0x6a, 0xa6, 0x26, 0xae, 0x2e,
+    0xe6, 0x66, 0xee, 0x6e, 0x18, 0x98, 0x10, 0x90, 0x58, 0xd8, 0x50, 0xd0,
+    0x1c, 0x9c, 0x14, 0x94, 0x5c, 0xdc, 0x54, 0xd4, 0x38, 0xb8, 0x30, 0xb0,
+    0x78, 0xf8, 0x70, 0xf0, 0x3c, 0xbc, 0x34, 0xb4, 0x7c, 0xfc, 0x74, 0xf4,
+    0x9a, 0x1a, 0x92, 0x12, 0xda, 0x5a, 0xd2, 0x52, 0x9e, 0x1e, 0x96, 0x16,
+    0xde, 0x5e, 0xd6, 0x56, 0xba, 0x3a, 0xb2, 0x32, 0xfa, 0x7a, 0xf2, 0x72,
+    0xbe, 0x3e, 0xb6, 0x36, 0xfe, 0x7e, 0xf6, 0x76, 0x41, 0xc1, 0x49, 0xc9,
+    0x01, 0x81, 0x09, 0x89, 0x45, 0xc5, 0x4d, 0xcd, 0x05, 0x85, 0x0d, 0x8d,
+    0x61, 0xe1, 0x69, 0xe9, 0x21, 0xa1, 0x29, 0xa9, 0x65, 0xe5, 0x6d, 0xed,
+    0x25, 0xa5, 0x2d, 0xad, 0xc3, 0x43, 0xcb, 0x4b, 0x83, 0x03, 0x8b, 0x0b,
+    0xc7, 0x47, 0xcf, 0x4f, 0x87, 0x07, 0x8f, 0x0f, 0xe3, 0x63, 0xeb, 0x6b,
+    0xa3, 0x23, 0xab, 0x2b, 0xe7, 0x67, 0xef, 0x6f, 0xa7, 0x27, 0xaf, 0x2f,
+    0x59, 0xd9, 0x51, 0xd1, 0x19, 0x99, 0x11, 0x91, 0x5d, 0xdd, 0x55, 0xd5,
+    0x1d, 0x9d, 0x15, 0x95, 0x79, 0xf9, 0x71, 0xf1, 0x39, 0xb9, 0x31, 0xb1,
+    0x7d, 0xfd, 0x75, 0xf5, 0x3d, 0xbd, 0x35, 0xb5, 0xdb, 0x5b, 0xd3, 0x53,
+    0x9b, 0x1b, 0x93, 0x13, 0xdf, 0x5f, 0xd7, 0x57, 0x9f, 0x1f, 0x97, 0x17,
+    0xfb, 0x7b, 0xf3, 0x73, 0xbb, 0x3b, 0xb3, 0x33, 0xff, 0x7f, 0xf7, 0x77,
+    0xbf, 0x3f, 0xb7, 0x37,
+};
+
+#endif // CRYPTO1_TABLES_H
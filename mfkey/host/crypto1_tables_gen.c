@@ -0,0 +1,95 @@
+// Generates crypto1_tables.h, the feedback tables for the byte-at-a-time Crypto1 functions
+//
+// With the filter output not fed back, 8 LFSR steps forward or backward are linear in the
+// state and the input bits. The tables hold the 8 new feedback bits contributed by every
+// byte of the odd and even halves and by the input byte, found by running the bit-serial
+// functions on each byte value.
+
+#define CRYPTO1_BYTEWISE 0
+#include <furi.h>
+#include "../crypto1.h"
+
+// New bits after 8 forward steps, bit k = feedback bit of step k
+static uint8_t forward_bits(uint32_t odd, uint32_t even, uint8_t in) {
+    struct Crypto1State s = {odd, even};
+    // crypt_word_noret() feeds bit k of the top byte at step k
+    uint32_t in_word = (uint32_t)in << 24;
+    uint32_t feedin, t;
+    for(int i = 0; i < 8; i++) {
+        feedin = LF_POLY_EVEN & s.even;
+        feedin ^= LF_POLY_ODD & s.odd;
+        feedin ^= !!BEBIT(in_word, i);
+        s.even = s.even << 1 | evenparity32(feedin);
+        t = s.odd, s.odd = s.even, s.even = t;
+    }
+    uint8_t bits = 0;
+    for(int k = 0; k < 8; k++) {
+        bits |= (k & 1 ? BIT(s.odd, (7 - k) / 2) : BIT(s.even, (6 - k) / 2)) << k;
+    }
+    return bits;
+}
+
+// Recovered bits after 8 rollback steps, low nibble holds the bits that end up in the top
+// of the odd half, high nibble the ones for the even half
+static uint8_t rollback_bits(uint32_t odd, uint32_t even, uint8_t in) {
+    struct Crypto1State s = {odd, even};
+    // napi_lfsr_rollback_word() feeds bit 7 - k of the low byte at step k
+    for(int i = 31; i >= 24; i--) {
+        napi_lfsr_rollback_bit(&s, BEBIT(in, i), 0);
+    }
+    return (s.odd >> 20 & 0xf) | (s.even >> 20 & 0xf) << 4;
+}
+
+static void print_values(const uint8_t* values, const char* indent) {
+    for(int v = 0; v < 256; v++) {
+        printf(
+            "%s0x%02x,%s",
+            v % 12 == 0 ? indent : "",
+            values[v],
+            v % 12 == 11 || v == 255 ? "\n" : " ");
+    }
+}
+
+static void print_table(const char* name, uint8_t (*table)[256]) {
+    printf("static const uint8_t %s[3][256] = {\n", name);
+    for(int b = 0; b < 3; b++) {
+        printf("    {\n");
+        print_values(table[b], "        ");
+        printf("    },\n");
+    }
+    printf("};\n\n");
+}
+
+static void print_input_table(const char* name, const uint8_t* table) {
+    printf("static const uint8_t %s[256] = {\n", name);
+    print_values(table, "    ");
+    printf("};\n\n");
+}
+
+int main(void) {
+    static uint8_t fwd_odd[3][256], fwd_even[3][256], fwd_in[256];
+    static uint8_t rb_odd[3][256], rb_even[3][256], rb_in[256];
+    for(int b = 0; b < 3; b++) {
+        for(uint32_t v = 0; v < 256; v++) {
+            fwd_odd[b][v] = forward_bits(v << (8 * b), 0, 0);
+            fwd_even[b][v] = forward_bits(0, v << (8 * b), 0);
+            rb_odd[b][v] = rollback_bits(v << (8 * b), 0, 0);
+            rb_even[b][v] = rollback_bits(0, v << (8 * b), 0);
+        }
+    }
+    for(uint32_t v = 0; v < 256; v++) {
+        fwd_in[v] = forward_bits(0, 0, v);
+        rb_in[v] = rollback_bits(0, 0, v);
+    }
+
+    printf("// Generated by host/crypto1_tables_gen.c, do not edit\n\n");
+    printf("#ifndef CRYPTO1_TABLES_H\n#define CRYPTO1_TABLES_H\n\n#include <stdint.h>\n\n");
+    print_table("crypto1_forward_odd", fwd_odd);
+    print_table("crypto1_forward_even", fwd_even);
+    print_input_table("crypto1_forward_in", fwd_in);
+    print_table("crypto1_rollback_odd", rb_odd);
+    print_table("crypto1_rollback_even", rb_even);
+    print_input_table("crypto1_rollback_in", rb_in);
+    printf("#endif // CRYPTO1_TABLES_H\n");
+    return 0;
+}
@@ -0,0 +1,720 @@
+#include <furi.h>
+#include <errno.h>
+#include <pthread.h>
+#include <stdarg.h>
+#include <sys/stat.h>
+#include <time.h>
+#include <unistd.h>
+#include "../mfkey.h"
+
+// Heap accounting
+//
+// The binary is linked with -Wl,--wrap for the allocator entry points so every
+// allocation made by mfkey.c, init_plugin.c and this file is tracked. The
+// optional limit emulates the Flipper's heap for memmgr_heap_get_max_free_block().
+// Like the firmware allocator, malloc() hands out zeroed memory. The counters are
+// shared by the worker threads of mfkey_parallel.c, hence the lock.
+
+typedef struct {
+    size_t size;
+    size_t pad;
+} HeapHeader;
+
+static size_t heap_limit = 0;
+static size_t heap_used = 0;
+static size_t heap_peak = 0;
+static pthread_mutex_t heap_lock = PTHREAD_MUTEX_INITIALIZER;
+
+static void heap_account(size_t added, size_t removed) {
+    pthread_mutex_lock(&heap_lock);
+    heap_used = heap_used + added - removed;
+    if(heap_used > heap_peak) heap_peak = heap_used;
+    pthread_mutex_unlock(&heap_lock);
+}
+
+void* __real_malloc(size_t size);
+void* __real_realloc(void* ptr, size_t size);
+void __real_free(void* ptr);
+
+void* __wrap_malloc(size_t size) {
+    HeapHeader* header = __real_malloc(sizeof(HeapHeader) + size);
+    if(!header) abort();
+    memset(header + 1, 0, size);
+    header->size = size;
+    heap_account(size, 0);
+    return header + 1;
+}
+
+void __wrap_free(void* ptr) {
+    if(!ptr) return;
+    HeapHeader* header = (HeapHeader*)ptr - 1;
+    heap_account(0, header->size);
+    __real_free(header);
+}
+
+void* __wrap_calloc(size_t count, size_t size) {
+    return __wrap_malloc(count * size);
+}
+
+void* __wrap_realloc(void* ptr, size_t size) {
+    if(!ptr) return __wrap_malloc(size);
+    HeapHeader* header = (HeapHeader*)ptr - 1;
+    size_t old_size = header->size;
+    header = __real_realloc(header, sizeof(HeapHeader) + size);
+    if(!header) abort();
+    header->size = size;
+    heap_account(size, old_size);
+    return header + 1;
+}
+
+void furi_host_heap_set_limit(size_t limit) {
+    heap_limit = limit;
+}
+
+size_t furi_host_heap_get_used(void) {
+    return heap_used;
+}
+
+size_t furi_host_heap_get_peak(void) {
+    return heap_peak;
+}
+
+void furi_host_heap_reset_peak(void) {
+    heap_peak = heap_used;
+}
+
+size_t memmgr_get_free_heap(void) {
+    if(heap_limit == 0) return SIZE_MAX / 2;
+    return heap_used < heap_limit ? heap_limit - heap_used : 0;
+}
+
+size_t memmgr_heap_get_max_free_block(void) {
+    // The host heap does not fragment, so the largest block is all that is free
+    return memmgr_get_free_heap();
+}
+
+// Records, RTC
+
+void* furi_record_open(const char* name) {
+    (void)name;
+    return NULL;
+}
+
+void furi_record_close(const char* name) {
+    (void)name;
+}
+
+uint32_t furi_hal_rtc_get_timestamp(void) {
+    return (uint32_t)time(NULL);
+}
+
+FuriHalCortexTimer furi_hal_cortex_timer_get(uint32_t timeout_us) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    FuriHalCortexTimer timer = {
+        .start = (uint32_t)(ts.tv_sec * 1000000000ULL + ts.tv_nsec),
+        .value = timeout_us * furi_hal_cortex_instructions_per_microsecond(),
+    };
+    return timer;
+}
+
+uint32_t furi_hal_cortex_instructions_per_microsecond(void) {
+    return 1000;
+}
+
+uint32_t furi_get_tick(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint32_t)(ts.tv_sec * 1000 + ts.tv_nsec / 1000000);
+}
+
+// FuriString
+
+struct FuriString {
+    char* data;
+    size_t size;
+    size_t capacity;
+};
+
+FuriString* furi_string_alloc(void) {
+    FuriString* string = malloc(sizeof(FuriString));
+    string->capacity = 64;
+    string->data = malloc(string->capacity);
+    string->data[0] = '\0';
+    string->size = 0;
+    return string;
+}
+
+FuriString* furi_string_alloc_printf(const char* format, ...) {
+    FuriString* string = furi_string_alloc();
+    va_list args;
+    va_start(args, format);
+    int size = vsnprintf(string->data, string->capacity, format, args);
+    va_end(args);
+    if((size_t)size >= string->capacity) {
+        string->capacity = size + 1;
+        string->data = realloc(string->data, string->capacity);
+        va_start(args, format);
+        vsnprintf(string->data, string->capacity, format, args);
+        va_end(args);
+    }
+    string->size = size;
+    return string;
+}
+
+void furi_string_free(FuriString* string) {
+    free(string->data);
+    free(string);
+}
+
+void furi_string_reset(FuriString* string) {
+    string->size = 0;
+    string->data[0] = '\0';
+}
+
+void furi_string_push_back(FuriString* string, char c) {
+    if(string->size + 2 > string->capacity) {
+        string->capacity *= 2;
+        string->data = realloc(string->data, string->capacity);
+    }
+    string->data[string->size++] = c;
+    string->data[string->size] = '\0';
+}
+
+const char* furi_string_get_cstr(const FuriString* string) {
+    return string->data;
+}
+
+size_t furi_string_size(const FuriString* string) {
+    return string->size;
+}
+
+size_t furi_string_search_str(const FuriString* string, const char* needle) {
+    const char* found = strstr(string->data, needle);
+    return found ? (size_t)(found - string->data) : FURI_STRING_FAILURE;
+}
+
+bool furi_string_start_with_str(const FuriString* string, const char* start) {
+    return strncmp(string->data, start, strlen(start)) == 0;
+}
+
+// Kernel objects: the benchmark drives the worker code synchronously
+
+struct FuriMutex {
+    int unused;
+};
+
+FuriMutex* furi_mutex_alloc(FuriMutexType type) {
+    (void)type;
+    return malloc(sizeof(FuriMutex));
+}
+
+void furi_mutex_free(FuriMutex* mutex) {
+    free(mutex);
+}
+
+FuriStatus furi_mutex_acquire(FuriMutex* mutex, uint32_t timeout) {
+    (void)mutex;
+    (void)timeout;
+    return FuriStatusOk;
+}
+
+FuriStatus furi_mutex_release(FuriMutex* mutex) {
+    (void)mutex;
+    return FuriStatusOk;
+}
+
+struct FuriThread {
+    FuriThreadCallback callback;
+    void* context;
+};
+
+FuriThread* furi_thread_alloc_ex(
+    const char* name,
+    uint32_t stack_size,
+    FuriThreadCallback callback,
+    void* context) {
+    (void)name;
+    (void)stack_size;
+    FuriThread* thread = malloc(sizeof(FuriThread));
+    thread->callback = callback;
+    thread->context = context;
+    return thread;
+}
+
+void furi_thread_free(FuriThread* thread) {
+    free(thread);
+}
+
+void furi_thread_start(FuriThread* thread) {
+    thread->callback(thread->context);
+}
+
+bool furi_thread_join(FuriThread* thread) {
+    (void)thread;
+    return true;
+}
+
+struct FuriMessageQueue {
+    int unused;
+};
+
+FuriMessageQueue* furi_message_queue_alloc(uint32_t msg_count, uint32_t msg_size) {
+    (void)msg_count;
+    (void)msg_size;
+    return malloc(sizeof(FuriMessageQueue));
+}
+
+void furi_message_queue_free(FuriMessageQueue* instance) {
+    free(instance);
+}
+
+FuriStatus furi_message_queue_put(FuriMessageQueue* instance, const void* msg, uint32_t timeout) {
+    (void)instance;
+    (void)msg;
+    (void)timeout;
+    return FuriStatusOk;
+}
+
+FuriStatus furi_message_queue_get(FuriMessageQueue* instance, void* msg, uint32_t timeout) {
+    (void)instance;
+    (void)msg;
+    (void)timeout;
+    return FuriStatusErrorTimeout;
+}
+
+// Storage
+
+struct Stream {
+    FILE* file;
+};
+
+static char storage_root[256] = ".";
+
+void furi_host_storage_set_root(const char* root) {
+    snprintf(storage_root, sizeof(storage_root), "%s", root);
+}
+
+static void storage_resolve_path(const char* path, char* host_path, size_t host_path_size) {
+    if(strncmp(path, "/ext/", 5) == 0) {
+        snprintf(host_path, host_path_size, "%s/%s", storage_root, path + 5);
+    } else {
+        snprintf(host_path, host_path_size, "%s", path);
+    }
+}
+
+FS_Error storage_common_stat(Storage* storage, const char* path, FileInfo* fileinfo) {
+    (void)storage;
+    char host_path[512];
+    storage_resolve_path(path, host_path, sizeof(host_path));
+    struct stat st;
+    if(stat(host_path, &st) != 0) return FSE_NOT_EXIST;
+    if(fileinfo) fileinfo->size = st.st_size;
+    return FSE_OK;
+}
+
+bool storage_simply_mkdir(Storage* storage, const char* path) {
+    (void)storage;
+    char host_path[512];
+    storage_resolve_path(path, host_path, sizeof(host_path));
+    return mkdir(host_path, 0755) == 0 || storage_common_stat(storage, path, NULL) == FSE_OK;
+}
+
+bool storage_simply_remove(Storage* storage, const char* path) {
+    (void)storage;
+    char host_path[512];
+    storage_resolve_path(path, host_path, sizeof(host_path));
+    return unlink(host_path) == 0 || errno == ENOENT;
+}
+
+bool storage_file_exists(Storage* storage, const char* path) {
+    return storage_common_stat(storage, path, NULL) == FSE_OK;
+}
+
+FS_Error storage_common_rename(Storage* storage, const char* old_path, const char* new_path) {
+    (void)storage;
+    char host_old[512], host_new[512];
+    storage_resolve_path(old_path, host_old, sizeof(host_old));
+    storage_resolve_path(new_path, host_new, sizeof(host_new));
+    return rename(host_old, host_new) == 0 ? FSE_OK : FSE_NOT_EXIST;
+}
+
+Stream* buffered_file_stream_alloc(Storage* storage) {
+    (void)storage;
+    Stream* stream = malloc(sizeof(Stream));
+    stream->file = NULL;
+    return stream;
+}
+
+bool buffered_file_stream_open(
+    Stream* stream,
+    const char* path,
+    FS_AccessMode access_mode,
+    FS_OpenMode open_mode) {
+    char host_path[512];
+    storage_resolve_path(path, host_path, sizeof(host_path));
+    buffered_file_stream_close(stream);
+
+    if(open_mode == FSOM_CREATE_ALWAYS) {
+        stream->file = fopen(host_path, (access_mode & FSAM_READ) ? "w+b" : "wb");
+    } else if(open_mode == FSOM_OPEN_EXISTING) {
+        stream->file = fopen(host_path, (access_mode & FSAM_WRITE) ? "r+b" : "rb");
+    } else {
+        stream->file = fopen(host_path, "r+b");
+        if(!stream->file && open_mode != FSOM_CREATE_NEW) stream->file = fopen(host_path, "w+b");
+        if(stream->file && open_mode == FSOM_OPEN_APPEND) fseek(stream->file, 0, SEEK_END);
+    }
+    return stream->file != NULL;
+}
+
+Stream* furi_host_stream_alloc_temp(void) {
+    Stream* stream = buffered_file_stream_alloc(NULL);
+    stream->file = tmpfile();
+    furi_check(stream->file);
+    return stream;
+}
+
+bool buffered_file_stream_sync(Stream* stream) {
+    return stream->file && fflush(stream->file) == 0;
+}
+
+bool buffered_file_stream_close(Stream* stream) {
+    bool flushed = true;
+    if(stream->file) {
+        flushed = fclose(stream->file) == 0;
+        stream->file = NULL;
+    }
+    return flushed;
+}
+
+void stream_free(Stream* stream) {
+    buffered_file_stream_close(stream);
+    free(stream);
+}
+
+bool stream_eof(Stream* stream) {
+    return stream_tell(stream) >= stream_size(stream);
+}
+
+bool stream_rewind(Stream* stream) {
+    return fseek(stream->file, 0, SEEK_SET) == 0;
+}
+
+bool stream_seek(Stream* stream, int32_t offset, StreamOffset offset_type) {
+    int whence = offset_type == StreamOffsetFromStart ? SEEK_SET :
+                 offset_type == StreamOffsetFromEnd   ? SEEK_END :
+                                                        SEEK_CUR;
+    return fseek(stream->file, offset, whence) == 0;
+}
+
+size_t stream_tell(Stream* stream) {
+    return ftell(stream->file);
+}
+
+size_t stream_size(Stream* stream) {
+    long position = ftell(stream->file);
+    fseek(stream->file, 0, SEEK_END);
+    long size = ftell(stream->file);
+    fseek(stream->file, position, SEEK_SET);
+    return size;
+}
+
+bool stream_delete(Stream* stream, size_t size) {
+    long position = ftell(stream->file);
+    size_t total = stream_size(stream);
+    if(position + size > total) return false;
+    size_t rest = total - position - size;
+    uint8_t* tail = malloc(rest + 1);
+    fseek(stream->file, position + size, SEEK_SET);
+    bool ok = fread(tail, 1, rest, stream->file) == rest;
+    fseek(stream->file, position, SEEK_SET);
+    ok = ok && fwrite(tail, 1, rest, stream->file) == rest;
+    free(tail);
+    fflush(stream->file);
+    ok = ok && ftruncate(fileno(stream->file), total - size) == 0;
+    fseek(stream->file, position, SEEK_SET);
+    return ok;
+}
+
+size_t stream_read(Stream* stream, uint8_t* data, size_t size) {
+    return fread(data, 1, size, stream->file);
+}
+
+size_t stream_write(Stream* stream, const uint8_t* data, size_t size) {
+    // Switching between reading and writing requires a positioning call
+    fseek(stream->file, 0, SEEK_CUR);
+    return fwrite(data, 1, size, stream->file);
+}
+
+size_t stream_write_char(Stream* stream, char c) {
+    return stream_write(stream, (const uint8_t*)&c, 1);
+}
+
+bool stream_read_line(Stream* stream, FuriString* str_result) {
+    furi_string_reset(str_result);
+    int c;
+    while((c = fgetc(stream->file)) != EOF) {
+        furi_string_push_back(str_result, c);
+        if(c == '\n') break;
+    }
+    return furi_string_size(str_result) > 0;
+}
+
+// KeysDict, stored as one 12 character hex key per line like the firmware
+
+bool keys_dict_check_presence(const char* path) {
+    return storage_common_stat(NULL, path, NULL) == FSE_OK;
+}
+
+static bool keys_dict_parse_line(FuriString* line, uint8_t* key, size_t key_size) {
+    const char* str = furi_string_get_cstr(line);
+    if(str[0] == '#' || furi_string_size(line) < key_size * 2) return false;
+    for(size_t i = 0; i < key_size; i++) {
+        unsigned int byte;
+        if(sscanf(&str[i * 2], "%2x", &byte) != 1) return false;
+        key[i] = byte;
+    }
+    return true;
+}
+
+KeysDict* keys_dict_alloc(const char* path, KeysDictMode mode, size_t key_size) {
+    KeysDict* instance = malloc(sizeof(KeysDict));
+    instance->stream = buffered_file_stream_alloc(NULL);
+    instance->key_size = key_size;
+    instance->key_size_symbols = key_size * 2 + 1;
+    instance->total_keys = 0;
+
+    bool opened = buffered_file_stream_open(
+        instance->stream,
+        path,
+        FSAM_READ_WRITE,
+        mode == KeysDictModeOpenAlways ? FSOM_OPEN_ALWAYS : FSOM_OPEN_EXISTING);
+    furi_check(opened);
+
+    uint8_t key[16];
+    while(keys_dict_get_next_key(instance, key, key_size)) {
+        instance->total_keys++;
+    }
+    keys_dict_rewind(instance);
+    return instance;
+}
+
+void keys_dict_free(KeysDict* instance) {
+    stream_free(instance->stream);
+    free(instance);
+}
+
+size_t keys_dict_get_total_keys(KeysDict* instance) {
+    return instance->total_keys;
+}
+
+bool keys_dict_rewind(KeysDict* instance) {
+    return stream_rewind(instance->stream);
+}
+
+bool keys_dict_get_next_key(KeysDict* instance, uint8_t* key, size_t key_size) {
+    FuriString* line = furi_string_alloc();
+    bool key_read = false;
+    while(!key_read && stream_read_line(instance->stream, line)) {
+        key_read = keys_dict_parse_line(line, key, key_size);
+    }
+    furi_string_free(line);
+    return key_read;
+}
+
+bool keys_dict_is_key_present(KeysDict* instance, const uint8_t* key, size_t key_size) {
+    uint8_t next_key[16];
+    bool present = false;
+    keys_dict_rewind(instance);
+    while(keys_dict_get_next_key(instance, next_key, key_size)) {
+        if(memcmp(next_key, key, key_size) == 0) {
+            present = true;
+            break;
+        }
+    }
+    return present;
+}
+
+bool keys_dict_add_key(KeysDict* instance, const uint8_t* key, size_t key_size) {
+    if(keys_dict_is_key_present(instance, key, key_size)) return true;
+    char line[40];
+    for(size_t i = 0; i < key_size; i++) {
+        snprintf(&line[i * 2], 3, "%02X", key[i]);
+    }
+    line[key_size * 2] = '\n';
+    stream_seek(instance->stream, 0, StreamOffsetFromEnd);
+    stream_write(instance->stream, (const uint8_t*)line, key_size * 2 + 1);
+    fflush(instance->stream->file);
+    instance->total_keys++;
+    return true;
+}
+
+// NFC helpers
+
+uint8_t nfc_util_even_parity8(uint8_t data) {
+    return __builtin_parity(data);
+}
+
+uint32_t crc32_calc_buffer(uint32_t crc, const void* buffer, size_t size) {
+    const uint8_t* data = buffer;
+    crc = ~crc;
+    while(size--) {
+        crc ^= *data++;
+        for(int i = 0; i < 8; i++) {
+            crc = (crc >> 1) ^ (0xEDB88320 & (0 - (crc & 1)));
+        }
+    }
+    return ~crc;
+}
+
+uint64_t bit_lib_bytes_to_num_be(const uint8_t src[], uint8_t len) {
+    uint64_t res = 0;
+    while(len--) {
+        res = res << 8 | *src++;
+    }
+    return res;
+}
+
+void bit_lib_num_to_bytes_be(uint64_t src, uint8_t len, uint8_t* dest) {
+    while(len--) {
+        dest[len] = src & 0xff;
+        src >>= 8;
+    }
+}
+
+// Application loader: the init plugin is linked in, so "loading" it only
+// hands back its descriptor
+
+const FlipperAppPluginDescriptor* init_plugin_ep(void);
+const void* firmware_api_interface = NULL;
+
+struct FlipperApplication {
+    int unused;
+};
+
+FlipperApplication* flipper_application_alloc(Storage* storage, const void* api_interface) {
+    (void)storage;
+    (void)api_interface;
+    return malloc(sizeof(FlipperApplication));
+}
+
+void flipper_application_free(FlipperApplication* app) {
+    free(app);
+}
+
+int flipper_application_preload(FlipperApplication* app, const char* path) {
+    (void)app;
+    (void)path;
+    return 0;
+}
+
+int flipper_application_map_to_memory(FlipperApplication* app) {
+    (void)app;
+    return 0;
+}
+
+const FlipperAppPluginDescriptor* flipper_application_plugin_get_descriptor(FlipperApplication* app) {
+    (void)app;
+    return init_plugin_ep();
+}
+
+// GUI, notification and dolphin are not rendered on the host
+
+const Icon I_mfkey = {0};
+const NotificationSequence sequence_audiovisual_alert = {0};
+const NotificationSequence sequence_display_backlight_on = {0};
+
+void canvas_draw_frame(Canvas* canvas, int32_t x, int32_t y, size_t width, size_t height) {
+    (void)canvas, (void)x, (void)y, (void)width, (void)height;
+}
+
+void canvas_draw_icon(Canvas* canvas, int32_t x, int32_t y, const Icon* icon) {
+    (void)canvas, (void)x, (void)y, (void)icon;
+}
+
+void canvas_draw_str_aligned(
+    Canvas* canvas,
+    int32_t x,
+    int32_t y,
+    Align horizontal,
+    Align vertical,
+    const char* str) {
+    (void)canvas, (void)x, (void)y, (void)horizontal, (void)vertical, (void)str;
+}
+
+void canvas_set_font(Canvas* canvas, Font font) {
+    (void)canvas, (void)font;
+}
+
+void elements_button_left(Canvas* canvas, const char* str) {
+    (void)canvas, (void)str;
+}
+
+void elements_button_center(Canvas* canvas, const char* str) {
+    (void)canvas, (void)str;
+}
+
+void elements_button_right(Canvas* canvas, const char* str) {
+    (void)canvas, (void)str;
+}
+
+void elements_progress_bar(Canvas* canvas, int32_t x, int32_t y, size_t width, float progress) {
+    (void)canvas, (void)x, (void)y, (void)width, (void)progress;
+}
+
+void elements_progress_bar_with_text(
+    Canvas* canvas,
+    int32_t x,
+    int32_t y,
+    size_t width,
+    float progress,
+    const char* text) {
+    (void)canvas, (void)x, (void)y, (void)width, (void)progress, (void)text;
+}
+
+struct ViewPort {
+    int unused;
+};
+
+ViewPort* view_port_alloc(void) {
+    return malloc(sizeof(ViewPort));
+}
+
+void view_port_free(ViewPort* view_port) {
+    free(view_port);
+}
+
+void view_port_draw_callback_set(ViewPort* view_port, ViewPortDrawCallback callback, void* context) {
+    (void)view_port, (void)callback, (void)context;
+}
+
+void view_port_input_callback_set(
+    ViewPort* view_port,
+    ViewPortInputCallback callback,
+    void* context) {
+    (void)view_port, (void)callback, (void)context;
+}
+
+void view_port_enabled_set(ViewPort* view_port, bool enabled) {
+    (void)view_port, (void)enabled;
+}
+
+void view_port_update(ViewPort* view_port) {
+    (void)view_port;
+}
+
+void gui_add_view_port(Gui* gui, ViewPort* view_port, GuiLayer layer) {
+    (void)gui, (void)view_port, (void)layer;
+}
+
+void gui_remove_view_port(Gui* gui, ViewPort* view_port) {
+    (void)gui, (void)view_port;
+}
+
+void notification_message(NotificationApp* app, const NotificationSequence* sequence) {
+    (void)app, (void)sequence;
+}
+
+void dolphin_deed(DolphinDeed deed) {
+    (void)deed;
+}
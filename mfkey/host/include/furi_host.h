@@ -0,0 +1,327 @@
+#pragma once
+
+// Minimal Furi/storage surface used by mfkey.c and init_plugin.c, backed by
+// libc so the recovery code can be built and benchmarked on a Linux host.
+// Only the calls MFKey actually makes are provided; GUI, notification and
+// loader calls are no-ops.
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#define furi_assert(x) \
+    do {               \
+        if(!(x)) {     \
+            abort();   \
+        }              \
+    } while(0)
+#define furi_check furi_assert
+
+#define FURI_LOG_E(tag, fmt, ...) fprintf(stderr, "[E][%s] " fmt "\n", tag, ##__VA_ARGS__)
+#define FURI_LOG_W(tag, fmt, ...) fprintf(stderr, "[W][%s] " fmt "\n", tag, ##__VA_ARGS__)
+#define FURI_LOG_I(tag, fmt, ...) fprintf(stderr, "[I][%s] " fmt "\n", tag, ##__VA_ARGS__)
+#define FURI_LOG_D(tag, fmt, ...) \
+    do {                          \
+    } while(0)
+#define FURI_LOG_T(tag, fmt, ...) \
+    do {                          \
+    } while(0)
+
+#define EXT_PATH(path)        "/ext/" path
+#define APP_ASSETS_PATH(path) "/ext/apps_assets/mfkey/" path
+
+#define RECORD_STORAGE "storage"
+#define RECORD_GUI     "gui"
+
+typedef enum {
+    FuriStatusOk = 0,
+    FuriStatusError = -1,
+    FuriStatusErrorTimeout = -2,
+} FuriStatus;
+
+#define FuriWaitForever 0xFFFFFFFFU
+
+void* furi_record_open(const char* name);
+void furi_record_close(const char* name);
+
+// Heap
+
+size_t memmgr_get_free_heap(void);
+size_t memmgr_heap_get_max_free_block(void);
+
+// Host-only heap accounting, see furi_host.c
+void furi_host_heap_set_limit(size_t limit);
+size_t furi_host_heap_get_used(void);
+size_t furi_host_heap_get_peak(void);
+void furi_host_heap_reset_peak(void);
+
+// RTC
+
+uint32_t furi_hal_rtc_get_timestamp(void);
+uint32_t furi_get_tick(void); // 1 kHz, like the device
+
+// Cycle counter: nanoseconds on the host, so 1000 "instructions" per microsecond
+typedef struct {
+    uint32_t start;
+    uint32_t value;
+} FuriHalCortexTimer;
+FuriHalCortexTimer furi_hal_cortex_timer_get(uint32_t timeout_us);
+uint32_t furi_hal_cortex_instructions_per_microsecond(void);
+
+// FuriString
+
+typedef struct FuriString FuriString;
+#define FURI_STRING_FAILURE ((size_t)-1)
+
+FuriString* furi_string_alloc(void);
+FuriString* furi_string_alloc_printf(const char* format, ...);
+void furi_string_free(FuriString* string);
+void furi_string_reset(FuriString* string);
+void furi_string_push_back(FuriString* string, char c);
+const char* furi_string_get_cstr(const FuriString* string);
+size_t furi_string_size(const FuriString* string);
+size_t furi_string_search_str(const FuriString* string, const char* needle);
+bool furi_string_start_with_str(const FuriString* string, const char* start);
+
+// Kernel objects
+
+typedef struct FuriMutex FuriMutex;
+typedef enum {
+    FuriMutexTypeNormal,
+    FuriMutexTypeRecursive,
+} FuriMutexType;
+FuriMutex* furi_mutex_alloc(FuriMutexType type);
+void furi_mutex_free(FuriMutex* mutex);
+FuriStatus furi_mutex_acquire(FuriMutex* mutex, uint32_t timeout);
+FuriStatus furi_mutex_release(FuriMutex* mutex);
+
+typedef struct FuriThread FuriThread;
+typedef int32_t (*FuriThreadCallback)(void* context);
+FuriThread* furi_thread_alloc_ex(
+    const char* name,
+    uint32_t stack_size,
+    FuriThreadCallback callback,
+    void* context);
+void furi_thread_free(FuriThread* thread);
+void furi_thread_start(FuriThread* thread);
+bool furi_thread_join(FuriThread* thread);
+
+typedef struct FuriMessageQueue FuriMessageQueue;
+FuriMessageQueue* furi_message_queue_alloc(uint32_t msg_count, uint32_t msg_size);
+void furi_message_queue_free(FuriMessageQueue* instance);
+FuriStatus furi_message_queue_put(FuriMessageQueue* instance, const void* msg, uint32_t timeout);
+FuriStatus furi_message_queue_get(FuriMessageQueue* instance, void* msg, uint32_t timeout);
+
+// Storage and streams
+
+typedef struct Storage Storage;
+typedef struct Stream Stream;
+
+typedef enum {
+    FSE_OK = 0,
+    FSE_NOT_EXIST = 2,
+} FS_Error;
+
+typedef enum {
+    FSAM_READ = (1 << 0),
+    FSAM_WRITE = (1 << 1),
+    FSAM_READ_WRITE = FSAM_READ | FSAM_WRITE,
+} FS_AccessMode;
+
+typedef enum {
+    FSOM_OPEN_EXISTING = 1,
+    FSOM_OPEN_ALWAYS = 2,
+    FSOM_OPEN_APPEND = 4,
+    FSOM_CREATE_NEW = 8,
+    FSOM_CREATE_ALWAYS = 16,
+} FS_OpenMode;
+
+typedef enum {
+    StreamOffsetFromCurrent,
+    StreamOffsetFromStart,
+    StreamOffsetFromEnd,
+} StreamOffset;
+
+typedef struct {
+    uint64_t size;
+} FileInfo;
+
+// "/ext/..." paths are resolved relative to this directory
+void furi_host_storage_set_root(const char* root);
+
+FS_Error storage_common_stat(Storage* storage, const char* path, FileInfo* fileinfo);
+bool storage_simply_mkdir(Storage* storage, const char* path);
+bool storage_simply_remove(Storage* storage, const char* path);
+bool storage_file_exists(Storage* storage, const char* path);
+FS_Error storage_common_rename(Storage* storage, const char* old_path, const char* new_path);
+
+Stream* buffered_file_stream_alloc(Storage* storage);
+bool buffered_file_stream_open(
+    Stream* stream,
+    const char* path,
+    FS_AccessMode access_mode,
+    FS_OpenMode open_mode);
+// Anonymous read/write stream, removed when freed
+Stream* furi_host_stream_alloc_temp(void);
+bool buffered_file_stream_sync(Stream* stream);
+bool buffered_file_stream_close(Stream* stream);
+void stream_free(Stream* stream);
+bool stream_eof(Stream* stream);
+bool stream_rewind(Stream* stream);
+bool stream_seek(Stream* stream, int32_t offset, StreamOffset offset_type);
+size_t stream_tell(Stream* stream);
+size_t stream_size(Stream* stream);
+bool stream_delete(Stream* stream, size_t size);
+size_t stream_read(Stream* stream, uint8_t* data, size_t size);
+size_t stream_write(Stream* stream, const uint8_t* data, size_t size);
+size_t stream_write_char(Stream* stream, char c);
+bool stream_read_line(Stream* stream, FuriString* str_result);
+
+// KeysDict (struct layout is provided by mfkey.h)
+
+typedef struct KeysDict KeysDict;
+typedef enum {
+    KeysDictModeOpenExisting,
+    KeysDictModeOpenAlways,
+} KeysDictMode;
+
+bool keys_dict_check_presence(const char* path);
+KeysDict* keys_dict_alloc(const char* path, KeysDictMode mode, size_t key_size);
+void keys_dict_free(KeysDict* instance);
+size_t keys_dict_get_total_keys(KeysDict* instance);
+bool keys_dict_rewind(KeysDict* instance);
+bool keys_dict_is_key_present(KeysDict* instance, const uint8_t* key, size_t key_size);
+bool keys_dict_get_next_key(KeysDict* instance, uint8_t* key, size_t key_size);
+bool keys_dict_add_key(KeysDict* instance, const uint8_t* key, size_t key_size);
+
+// NFC
+
+#define MF_CLASSIC_KEY_SIZE (6)
+
+typedef struct {
+    uint8_t data[MF_CLASSIC_KEY_SIZE];
+} MfClassicKey;
+
+uint8_t nfc_util_even_parity8(uint8_t data);
+uint32_t crc32_calc_buffer(uint32_t crc, const void* buffer, size_t size);
+uint64_t bit_lib_bytes_to_num_be(const uint8_t src[], uint8_t len);
+void bit_lib_num_to_bytes_be(uint64_t src, uint8_t len, uint8_t* dest);
+
+// Application loader
+
+typedef struct FlipperApplication FlipperApplication;
+typedef struct {
+    const char* appid;
+    uint32_t ep_api_version;
+    const void* entry_point;
+} FlipperAppPluginDescriptor;
+
+extern const void* firmware_api_interface;
+
+FlipperApplication* flipper_application_alloc(Storage* storage, const void* api_interface);
+void flipper_application_free(FlipperApplication* app);
+int flipper_application_preload(FlipperApplication* app, const char* path);
+int flipper_application_map_to_memory(FlipperApplication* app);
+const FlipperAppPluginDescriptor* flipper_application_plugin_get_descriptor(FlipperApplication* app);
+
+// GUI, input, notification, dolphin
+
+typedef struct Gui Gui;
+typedef struct Canvas Canvas;
+typedef struct ViewPort ViewPort;
+typedef struct {
+    int unused;
+} Icon;
+extern const Icon I_mfkey;
+
+typedef enum {
+    FontPrimary,
+    FontSecondary,
+} Font;
+
+typedef enum {
+    AlignLeft,
+    AlignRight,
+    AlignTop,
+    AlignBottom,
+    AlignCenter,
+} Align;
+
+typedef enum {
+    GuiLayerFullscreen,
+} GuiLayer;
+
+typedef enum {
+    InputKeyUp,
+    InputKeyDown,
+    InputKeyRight,
+    InputKeyLeft,
+    InputKeyOk,
+    InputKeyBack,
+} InputKey;
+
+typedef enum {
+    InputTypePress,
+    InputTypeRelease,
+    InputTypeShort,
+    InputTypeLong,
+    InputTypeRepeat,
+} InputType;
+
+typedef struct {
+    InputKey key;
+    InputType type;
+} InputEvent;
+
+typedef void (*ViewPortDrawCallback)(Canvas* canvas, void* context);
+typedef void (*ViewPortInputCallback)(InputEvent* event, void* context);
+
+void canvas_draw_frame(Canvas* canvas, int32_t x, int32_t y, size_t width, size_t height);
+void canvas_draw_icon(Canvas* canvas, int32_t x, int32_t y, const Icon* icon);
+void canvas_draw_str_aligned(
+    Canvas* canvas,
+    int32_t x,
+    int32_t y,
+    Align horizontal,
+    Align vertical,
+    const char* str);
+void canvas_set_font(Canvas* canvas, Font font);
+void elements_button_left(Canvas* canvas, const char* str);
+void elements_button_center(Canvas* canvas, const char* str);
+void elements_button_right(Canvas* canvas, const char* str);
+void elements_progress_bar(Canvas* canvas, int32_t x, int32_t y, size_t width, float progress);
+void elements_progress_bar_with_text(
+    Canvas* canvas,
+    int32_t x,
+    int32_t y,
+    size_t width,
+    float progress,
+    const char* text);
+
+ViewPort* view_port_alloc(void);
+void view_port_free(ViewPort* view_port);
+void view_port_draw_callback_set(ViewPort* view_port, ViewPortDrawCallback callback, void* context);
+void view_port_input_callback_set(
+    ViewPort* view_port,
+    ViewPortInputCallback callback,
+    void* context);
+void view_port_enabled_set(ViewPort* view_port, bool enabled);
+void view_port_update(ViewPort* view_port);
+void gui_add_view_port(Gui* gui, ViewPort* view_port, GuiLayer layer);
+void gui_remove_view_port(Gui* gui, ViewPort* view_port);
+
+typedef struct NotificationApp NotificationApp;
+typedef struct {
+    int unused;
+} NotificationSequence;
+extern const NotificationSequence sequence_audiovisual_alert;
+extern const NotificationSequence sequence_display_backlight_on;
+void notification_message(NotificationApp* app, const NotificationSequence* sequence);
+
+typedef enum {
+    DolphinDeedNfcMfcAdd,
+} DolphinDeed;
+void dolphin_deed(DolphinDeed deed);
@@ -0,0 +1,324 @@
+// Host benchmark for MFKey key recovery
+//
+// Loads nonces from <root>/nfc/.mfkey32.log and <root>/nfc/.nested.log through the
+// init plugin (with the dictionaries in <root>/nfc/assets), then runs recover() on
+// every remaining nonce and reports wall time, peak heap and the recovered key.
+
+#include <furi.h>
+#include <inttypes.h>
+#include <time.h>
+#include <unistd.h>
+#include "../mfkey.h"
+#include "../plugin_interface.h"
+#include "mfkey_parallel.h"
+
+#define KEYS_DICT_SYSTEM_PATH EXT_PATH("nfc/assets/mf_classic_dict.nfc")
+#define KEYS_DICT_USER_PATH   EXT_PATH("nfc/assets/mf_classic_dict_user.nfc")
+
+bool recover(MfClassicNonce* n, int ks2, unsigned int in, ProgramState* program_state);
+CandidateWriter* candidate_writer_alloc(KeysDict* dict);
+void candidate_writer_free(
+    CandidateWriter* writer,
+    ProgramState* program_state,
+    MfClassicNonce* done_nonce);
+const FlipperAppPluginDescriptor* init_plugin_ep(void);
+void hot_keys_restore_user_dict(void);
+void hot_keys_load(ProgramState* program_state);
+void hot_keys_credit(ProgramState* program_state, const MfClassicKey* key);
+void hot_keys_save(ProgramState* program_state);
+void hot_keys_sort_user_dict(ProgramState* program_state);
+void hot_keys_free(ProgramState* program_state);
+
+static const char* attack_names[] = {
+    [mfkey32] = "mfkey32",
+    [static_nested] = "static_nested",
+    [static_encrypted] = "static_encrypted",
+};
+
+static double bench_now_ms(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec * 1000.0 + ts.tv_nsec / 1000000.0;
+}
+
+static void bench_result(
+    MfClassicNonce* n,
+    bool found,
+    int candidates,
+    int* keys_found,
+    char* result,
+    size_t size) {
+    if(found) {
+        (*keys_found)++;
+        uint64_t key = bit_lib_bytes_to_num_be(n->key.data, sizeof(MfClassicKey));
+        snprintf(result, size, "key %012" PRIx64, key);
+    } else if(n->attack == static_encrypted) {
+        snprintf(result, size, "%d candidates", candidates);
+    } else {
+        snprintf(result, size, "no key");
+    }
+}
+
+// -k: what mfkey() does with a recovered key
+static void bench_keep_key(ProgramState* program_state, KeysDict* user_dict, MfClassicNonce* n) {
+    hot_keys_credit(program_state, &n->key);
+    keys_dict_add_key(user_dict, n->key.data, sizeof(MfClassicKey));
+}
+
+static void bench_usage(const char* name) {
+    fprintf(
+        stderr,
+        "Usage: %s [-d sd_root] [-m heap_limit_bytes] [-n max_nonces] [-j threads] [-k]\n"
+        "  -d  directory standing in for /ext (default: .)\n"
+        "  -m  emulated heap size for memmgr_heap_get_max_free_block (default: unlimited)\n"
+        "  -n  stop after this many nonces\n"
+        "  -j  worker threads for recover_parallel() (default: 1, plain recover())\n"
+        "  -k  keep found keys in the user dictionary and the hot key cache, like mfkey()\n",
+        name);
+}
+
+int main(int argc, char** argv) {
+    const char* root = ".";
+    size_t heap_limit = 0;
+    long max_nonces = -1;
+    int threads = 1;
+    bool keep_keys = false;
+    int opt;
+    while((opt = getopt(argc, argv, "d:m:n:j:kh")) != -1) {
+        switch(opt) {
+        case 'd':
+            root = optarg;
+            break;
+        case 'm':
+            heap_limit = strtoul(optarg, NULL, 0);
+            break;
+        case 'n':
+            max_nonces = strtol(optarg, NULL, 0);
+            break;
+        case 'j':
+            threads = atoi(optarg);
+            if(threads < 1) threads = 1;
+            break;
+        case 'k':
+            keep_keys = true;
+            break;
+        default:
+            bench_usage(argv[0]);
+            return 1;
+        }
+    }
+    furi_host_storage_set_root(root);
+    furi_host_heap_set_limit(heap_limit);
+
+    ProgramState* program_state = calloc(1, sizeof(ProgramState));
+    const MfkeyPlugin* init_plugin = init_plugin_ep()->entry_point;
+    program_state->mfkey32_present = init_plugin->napi_mf_classic_mfkey32_nonces_check_presence();
+    program_state->nested_present = init_plugin->napi_mf_classic_nested_nonces_check_presence();
+    if(!program_state->mfkey32_present && !program_state->nested_present) {
+        fprintf(stderr, "No nonces found under %s/nfc\n", root);
+        free(program_state);
+        return 1;
+    }
+
+    // Dictionary phase, same as mfkey()
+    double dict_start = bench_now_ms();
+    if(keep_keys) {
+        hot_keys_restore_user_dict();
+    }
+    bool system_dict_exists = keys_dict_check_presence(KEYS_DICT_SYSTEM_PATH);
+    KeysDict* system_dict = NULL;
+    if(system_dict_exists) {
+        system_dict =
+            keys_dict_alloc(KEYS_DICT_SYSTEM_PATH, KeysDictModeOpenExisting, sizeof(MfClassicKey));
+    }
+    KeysDict* user_dict =
+        keys_dict_alloc(KEYS_DICT_USER_PATH, KeysDictModeOpenAlways, sizeof(MfClassicKey));
+    if(keep_keys) {
+        hot_keys_load(program_state);
+    }
+    MfClassicNonceArray* nonce_arr = init_plugin->napi_mf_classic_nonce_array_alloc(
+        system_dict, system_dict_exists, user_dict, program_state);
+    if(system_dict_exists) {
+        keys_dict_free(system_dict);
+    }
+    double dict_ms = bench_now_ms() - dict_start;
+    printf(
+        "Loaded %d nonces, %d solved by dictionary in %.1f ms\n",
+        program_state->total,
+        program_state->cracked,
+        dict_ms);
+
+    printf(
+        "%-4s %-16s %-8s %12s %12s  %s\n", "#", "attack", "uid", "time_ms", "peak_heap", "result");
+    double total_ms = 0;
+    int keys_found = 0;
+    uint32_t count = nonce_arr->total_nonces;
+    if(max_nonces >= 0 && (uint32_t)max_nonces < count) count = max_nonces;
+    if(threads > 1) {
+        // Rows show the work time summed over rounds and the peak heap of the whole run
+        ParallelResult* results = malloc(sizeof(ParallelResult) * (count ? count : 1));
+        size_t heap_base = furi_host_heap_get_used();
+        furi_host_heap_reset_peak();
+        double start = bench_now_ms();
+        recover_parallel(
+            nonce_arr->remaining_nonce_array, count, threads, program_state, results);
+        total_ms = bench_now_ms() - start;
+        size_t peak = furi_host_heap_get_peak() - heap_base;
+        for(uint32_t i = 0; i < count; i++) {
+            MfClassicNonce* n = &nonce_arr->remaining_nonce_array[i];
+            char result[32];
+            bench_result(
+                n, results[i].found, results[i].candidates, &keys_found, result, sizeof(result));
+            if(keep_keys && results[i].found) {
+                bench_keep_key(program_state, user_dict, n);
+            }
+            printf(
+                "%-4" PRIu32 " %-16s %08" PRIx32 " %12.1f %12zu  %s\n",
+                i,
+                attack_names[n->attack],
+                n->uid,
+                results[i].work_ms,
+                peak,
+                result);
+        }
+        free(results);
+    } else {
+        for(uint32_t i = 0; i < count; i++) {
+            MfClassicNonce next_nonce = nonce_arr->remaining_nonce_array[i];
+            uint32_t ks_enc = 0, nt_xor_uid = 0;
+            FuriString* cuid_dict_path = NULL;
+            switch(next_nonce.attack) {
+            case mfkey32:
+                ks_enc = next_nonce.ar0_enc ^ next_nonce.p64;
+                nt_xor_uid = 0;
+                break;
+            case static_nested:
+                ks_enc = next_nonce.ks1_2_enc;
+                nt_xor_uid = next_nonce.uid_xor_nt1;
+                break;
+            case static_encrypted:
+                ks_enc = next_nonce.ks1_1_enc;
+                nt_xor_uid = next_nonce.uid_xor_nt0;
+                cuid_dict_path = furi_string_alloc_printf(
+                    "%s/mf_classic_dict_%08" PRIx32 ".nfc", EXT_PATH("nfc/assets"), next_nonce.uid);
+                program_state->cuid_dict = keys_dict_alloc(
+                    furi_string_get_cstr(cuid_dict_path),
+                    KeysDictModeOpenAlways,
+                    sizeof(MfClassicKey));
+                furi_string_free(cuid_dict_path);
+                break;
+            }
+
+            int candidates_before = program_state->num_candidates;
+            size_t heap_base = furi_host_heap_get_used();
+            furi_host_heap_reset_peak();
+            if(next_nonce.attack == static_encrypted) {
+                // Counted in peak_heap, the buffer is part of the attack's RAM use
+                program_state->candidates = candidate_writer_alloc(program_state->cuid_dict);
+            }
+            double start = bench_now_ms();
+            bool found = recover(&next_nonce, ks_enc, nt_xor_uid, program_state);
+            double elapsed = bench_now_ms() - start;
+            size_t peak = furi_host_heap_get_peak() - heap_base;
+            total_ms += elapsed;
+
+            char result[32];
+            bench_result(
+                &next_nonce,
+                found,
+                program_state->num_candidates - candidates_before,
+                &keys_found,
+                result,
+                sizeof(result));
+            if(keep_keys && found) {
+                bench_keep_key(program_state, user_dict, &next_nonce);
+            }
+            if(next_nonce.attack == static_encrypted) {
+                candidate_writer_free(program_state->candidates, program_state, &next_nonce);
+                program_state->candidates = NULL;
+                keys_dict_free(program_state->cuid_dict);
+                program_state->cuid_dict = NULL;
+            }
+            printf(
+                "%-4" PRIu32 " %-16s %08" PRIx32 " %12.1f %12zu  %s\n",
+                i,
+                attack_names[next_nonce.attack],
+                next_nonce.uid,
+                elapsed,
+                peak,
+                result);
+        }
+    }
+    printf(
+        "Total: %" PRIu32 " nonces, %d keys, %d candidates, %.1f ms\n",
+        count,
+        keys_found,
+        program_state->num_candidates,
+        total_ms);
+    if(program_state->candidate_flushes) {
+        printf(
+            "Candidate writer: %" PRIu32 " flushes, %" PRIu32 " ms, %" PRIu32 " duplicates\n",
+            program_state->candidate_flushes,
+            program_state->candidate_flush_ticks,
+            program_state->candidate_duplicates);
+    }
+    uint64_t phase_total = 0;
+    for(int phase = 0; phase < PhaseCount; phase++) {
+        phase_total += program_state->phase_cycles[phase];
+    }
+    if(phase_total) {
+        // Host cycle counter runs in nanoseconds
+        printf(
+            "Phases: table build %.1f ms, sort %.1f ms, join %.1f ms, check %.1f ms",
+            program_state->phase_cycles[PhaseTableBuild] / 1e6,
+            program_state->phase_cycles[PhaseSort] / 1e6,
+            program_state->phase_cycles[PhaseJoin] / 1e6,
+            program_state->phase_cycles[PhaseCheck] / 1e6);
+        if(program_state->rounds_done) {
+            printf(
+                ", %" PRIu32 " rounds of %.1f ms",
+                program_state->rounds_done,
+                (double)program_state->rounds_ms / program_state->rounds_done);
+        }
+        printf("\n");
+    }
+    if(program_state->msb_lookups) {
+        printf(
+            "MSB dedup: %" PRIu32 " lookups, %.2f probes/lookup, %" PRIu32 " collisions (%.1f%%)\n",
+            program_state->msb_lookups,
+            (double)program_state->msb_probes / program_state->msb_lookups,
+            program_state->msb_collisions,
+            100.0 * program_state->msb_collisions / program_state->msb_lookups);
+    }
+    if(program_state->parity_checked) {
+        printf(
+            "Parity pre-filter: %" PRIu32 " states, %" PRIu32 " pruned (%.2f%%)\n",
+            program_state->parity_checked,
+            program_state->parity_pruned,
+            100.0 * program_state->parity_pruned / program_state->parity_checked);
+    }
+    if(program_state->seed_checked) {
+        printf(
+            "Seed check: %" PRIu32 " states, %" PRIu32 " pruned (%.2f%%)\n",
+            program_state->seed_checked,
+            program_state->seed_pruned,
+            100.0 * program_state->seed_pruned / program_state->seed_checked);
+    }
+
+    if(keep_keys) {
+        printf(
+            "Hot keys: %" PRIu32 " cached, %" PRIu32 " nonces solved by them\n",
+            program_state->hot_key_count,
+            program_state->hot_key_hits);
+    }
+
+    init_plugin->napi_mf_classic_nonce_array_free(nonce_arr);
+    keys_dict_free(user_dict);
+    if(keep_keys) {
+        hot_keys_save(program_state);
+        hot_keys_sort_user_dict(program_state);
+        hot_keys_free(program_state);
+    }
+    free(program_state);
+    return 0;
+}
@@ -0,0 +1,271 @@
+// Multi-threaded recover() for the host build
+//
+// The MSB rounds of a nonce are independent, so every (nonce, round) pair is a work item.
+// Workers take items in order. A key found in round r cancels the rounds after r that
+// are still running for that nonce, but the rounds before r finish: the lowest round with
+// a key wins, exactly like the single-threaded loop in recover(). Static encrypted
+// candidates of each round go to a private temporary dictionary and are added to the
+// per-UID dictionary in round order at the end.
+
+#include <furi.h>
+#include <inttypes.h>
+#include <pthread.h>
+#include <time.h>
+#include "mfkey_parallel.h"
+
+size_t recover_heap_size(int msb_limit);
+void** recover_alloc(ProgramState* program_state, int max_msb_limit);
+void recover_free(void** block_pointers);
+int recover_msb_rounds();
+bool recover_round(
+    MfClassicNonce* n,
+    int ks2,
+    unsigned int in,
+    int msb,
+    void** block_pointers,
+    ProgramState* program_state);
+CandidateWriter* candidate_writer_alloc(KeysDict* dict);
+void candidate_writer_add_stream(CandidateWriter* writer, Stream* source);
+void candidate_writer_free(
+    CandidateWriter* writer,
+    ProgramState* program_state,
+    MfClassicNonce* done_nonce);
+
+typedef struct ParallelRun ParallelRun;
+
+typedef struct {
+    ParallelRun* run;
+    pthread_t thread;
+    ProgramState state; // Private counters and cancel flag
+    void** blocks;
+    int64_t nonce; // Item in progress, -1 when idle
+    int msb;
+} ParallelWorker;
+
+struct ParallelRun {
+    MfClassicNonce* nonces;
+    ParallelResult* results;
+    uint32_t count;
+    int rounds;
+    uint64_t next_item;
+    int* found_round; // Lowest round that found the key, rounds if none yet
+    Stream** round_candidates; // Per item, static encrypted only
+    ParallelWorker* workers;
+    int threads;
+    pthread_mutex_t lock;
+};
+
+// Splits the free heap between the workers before any of them allocates. The tables grow
+// with the MSB chunk size while a round costs much the same at any size, so when the heap
+// is tight, more workers on smaller chunks can finish later than fewer on larger ones. Picks
+// the chunk size and worker count with the fewest rounds per worker, the larger chunk on a
+// tie. Returns the worker count, 0 if not even one worker fits.
+static int parallel_plan(uint32_t count, int threads, int* msb_limit) {
+    size_t free_block = memmgr_heap_get_max_free_block();
+    uint64_t best_cost = UINT64_MAX;
+    int best_workers = 0;
+
+    // Keep at least one item per worker, rounds are the unit of work
+    int max_msb_limit = 256;
+    while(max_msb_limit > 1 && (uint64_t)count * (256 / max_msb_limit) < (uint64_t)threads) {
+        max_msb_limit /= 2;
+    }
+    for(int limit = max_msb_limit; limit >= 1; limit /= 2) {
+        size_t worker_size = recover_heap_size(limit);
+        size_t fit = free_block / worker_size;
+        int workers = fit < (size_t)threads ? (int)fit : threads;
+        if(workers == 0) continue;
+        uint64_t items = (uint64_t)count * (256 / limit);
+        uint64_t cost = (items + workers - 1) / workers;
+        if(cost < best_cost) {
+            best_cost = cost;
+            best_workers = workers;
+            *msb_limit = limit;
+        }
+    }
+    return best_workers;
+}
+
+static double parallel_now_ms(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec * 1000.0 + ts.tv_nsec / 1000000.0;
+}
+
+// Same arguments as mfkey() passes to recover()
+static void parallel_recover_args(MfClassicNonce* n, uint32_t* ks_enc, uint32_t* nt_xor_uid) {
+    switch(n->attack) {
+    case mfkey32:
+        *ks_enc = n->ar0_enc ^ n->p64;
+        *nt_xor_uid = 0;
+        break;
+    case static_nested:
+        *ks_enc = n->ks1_2_enc;
+        *nt_xor_uid = n->uid_xor_nt1;
+        break;
+    case static_encrypted:
+        *ks_enc = n->ks1_1_enc;
+        *nt_xor_uid = n->uid_xor_nt0;
+        break;
+    }
+}
+
+static void* parallel_worker(void* ctx) {
+    ParallelWorker* worker = ctx;
+    ParallelRun* run = worker->run;
+    uint64_t total_items = (uint64_t)run->count * run->rounds;
+
+    for(;;) {
+        pthread_mutex_lock(&run->lock);
+        uint64_t item = run->next_item++;
+        if(item >= total_items) {
+            pthread_mutex_unlock(&run->lock);
+            break;
+        }
+        uint32_t index = item / run->rounds;
+        int msb = item % run->rounds;
+        if(run->found_round[index] < msb) {
+            // A lower round already has the key
+            pthread_mutex_unlock(&run->lock);
+            continue;
+        }
+        MfClassicNonce n = run->nonces[index];
+        worker->nonce = index;
+        worker->msb = msb;
+        worker->state.close_thread_please = false;
+        pthread_mutex_unlock(&run->lock);
+
+        uint32_t ks_enc = 0, nt_xor_uid = 0;
+        parallel_recover_args(&n, &ks_enc, &nt_xor_uid);
+        KeysDict dict = {
+            .key_size = sizeof(MfClassicKey),
+            .key_size_symbols = sizeof(MfClassicKey) * 2 + 1,
+        };
+        if(n.attack == static_encrypted) {
+            dict.stream = furi_host_stream_alloc_temp();
+            worker->state.candidates = candidate_writer_alloc(&dict);
+        }
+        int candidates_before = worker->state.num_candidates;
+        double start = parallel_now_ms();
+        bool found = recover_round(&n, ks_enc, nt_xor_uid, msb, worker->blocks, &worker->state);
+        double elapsed = parallel_now_ms() - start;
+        if(worker->state.candidates) {
+            candidate_writer_free(worker->state.candidates, &worker->state, NULL);
+            worker->state.candidates = NULL;
+            run->round_candidates[item] = dict.stream;
+        }
+
+        pthread_mutex_lock(&run->lock);
+        worker->nonce = -1;
+        run->results[index].work_ms += elapsed;
+        run->results[index].candidates += worker->state.num_candidates - candidates_before;
+        if(found && msb < run->found_round[index]) {
+            run->found_round[index] = msb;
+            run->nonces[index].key = n.key;
+            run->results[index].found = true;
+            for(int w = 0; w < run->threads; w++) {
+                ParallelWorker* other = &run->workers[w];
+                if(other->nonce == index && other->msb > msb) {
+                    __atomic_store_n(&other->state.close_thread_please, true, __ATOMIC_RELAXED);
+                }
+            }
+        }
+        pthread_mutex_unlock(&run->lock);
+    }
+    return NULL;
+}
+
+// Appends the candidates of every round of nonce index to its per-UID dictionary
+static void parallel_write_candidates(ParallelRun* run, uint32_t index, ProgramState* state) {
+    MfClassicNonce* n = &run->nonces[index];
+    FuriString* path = furi_string_alloc_printf(
+        "%s/mf_classic_dict_%08" PRIx32 ".nfc", EXT_PATH("nfc/assets"), n->uid);
+    KeysDict* dict =
+        keys_dict_alloc(furi_string_get_cstr(path), KeysDictModeOpenAlways, sizeof(MfClassicKey));
+    furi_string_free(path);
+    CandidateWriter* writer = candidate_writer_alloc(dict);
+    for(int msb = 0; msb < run->rounds; msb++) {
+        Stream* round = run->round_candidates[(uint64_t)index * run->rounds + msb];
+        if(!round) continue;
+        // Through the writer, which drops the keys of earlier rounds and runs
+        candidate_writer_add_stream(writer, round);
+        stream_free(round);
+    }
+    candidate_writer_free(writer, state, n);
+    keys_dict_free(dict);
+}
+
+bool recover_parallel(
+    MfClassicNonce* nonces,
+    uint32_t count,
+    int threads,
+    ProgramState* program_state,
+    ParallelResult* results) {
+    ParallelRun run = {
+        .nonces = nonces,
+        .results = results,
+        .count = count,
+        .workers = calloc(threads, sizeof(ParallelWorker)),
+    };
+    pthread_mutex_init(&run.lock, NULL);
+    int msb_limit = 1;
+    threads = parallel_plan(count, threads, &msb_limit);
+    // All tables first, all at the planned chunk size: MSB_LIMIT fixes the number of rounds
+    for(run.threads = 0; run.threads < threads; run.threads++) {
+        ParallelWorker* worker = &run.workers[run.threads];
+        worker->blocks = recover_alloc(&worker->state, msb_limit);
+        if(!worker->blocks) break;
+    }
+    if(run.threads == 0) {
+        program_state->err = InsufficientRAM;
+        program_state->mfkey_state = Error;
+        free(run.workers);
+        pthread_mutex_destroy(&run.lock);
+        return false;
+    }
+    run.rounds = recover_msb_rounds();
+    run.found_round = malloc(sizeof(int) * count);
+    for(uint32_t i = 0; i < count; i++) {
+        run.found_round[i] = run.rounds;
+        results[i] = (ParallelResult){0};
+    }
+    run.round_candidates = calloc((uint64_t)count * run.rounds, sizeof(Stream*));
+
+    for(int w = 0; w < run.threads; w++) {
+        run.workers[w].run = &run;
+        run.workers[w].nonce = -1;
+        pthread_create(&run.workers[w].thread, NULL, parallel_worker, &run.workers[w]);
+    }
+    for(int w = 0; w < run.threads; w++) {
+        pthread_join(run.workers[w].thread, NULL);
+    }
+
+    for(uint32_t i = 0; i < count; i++) {
+        if(nonces[i].attack == static_encrypted) {
+            parallel_write_candidates(&run, i, program_state);
+        }
+    }
+    for(int w = 0; w < run.threads; w++) {
+        ProgramState* state = &run.workers[w].state;
+        program_state->num_candidates += state->num_candidates;
+        program_state->msb_lookups += state->msb_lookups;
+        program_state->msb_probes += state->msb_probes;
+        program_state->msb_collisions += state->msb_collisions;
+        program_state->parity_checked += state->parity_checked;
+        program_state->parity_pruned += state->parity_pruned;
+        program_state->seed_checked += state->seed_checked;
+        program_state->seed_pruned += state->seed_pruned;
+        program_state->candidate_duplicates += state->candidate_duplicates;
+        program_state->candidate_flushes += state->candidate_flushes;
+        program_state->candidate_flush_ticks += state->candidate_flush_ticks;
+        for(int phase = 0; phase < PhaseCount; phase++) {
+            program_state->phase_cycles[phase] += state->phase_cycles[phase];
+        }
+        recover_free(run.workers[w].blocks);
+    }
+    free(run.round_candidates);
+    free(run.found_round);
+    free(run.workers);
+    pthread_mutex_destroy(&run.lock);
+    return true;
+}
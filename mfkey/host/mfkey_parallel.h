@@ -0,0 +1,23 @@
+#ifndef MFKEY_PARALLEL_H
+#define MFKEY_PARALLEL_H
+
+#include "../mfkey.h"
+
+typedef struct {
+    bool found; // Key stored in the nonce
+    uint32_t candidates; // Static encrypted key candidates
+    double work_ms; // Summed over the rounds of this nonce, across workers
+} ParallelResult;
+
+// Runs recover() on count nonces with threads workers, each owning its own tables. Work
+// items are (nonce, MSB round) pairs taken in order, so all workers stay busy on a single
+// nonce as well as on many. Produces the same keys and per-UID dictionaries, byte for byte,
+// as calling recover() on one nonce after the other. Returns false if no worker got RAM.
+bool recover_parallel(
+    MfClassicNonce* nonces,
+    uint32_t count,
+    int threads,
+    ProgramState* program_state,
+    ParallelResult* results);
+
+#endif // MFKEY_PARALLEL_H
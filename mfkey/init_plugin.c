@@ -3,6 +3,7 @@
 #include <toolbox/keys_dict.h>
 #include <bit_lib/bit_lib.h>
 #include <toolbox/stream/buffered_file_stream.h>
+#include <toolbox/crc32_calc.h>
 #include <nfc/protocols/mf_classic/mf_classic.h>
 #include "mfkey.h"
 #include "crypto1.h"
@@ -14,6 +15,7 @@
 // TODO: Remove defines that are not needed
 #define MF_CLASSIC_NONCE_PATH        EXT_PATH("nfc/.mfkey32.log")
 #define MF_CLASSIC_NESTED_NONCE_PATH EXT_PATH("nfc/.nested.log")
+#define MF_CLASSIC_NONCE_CACHE_PATH  EXT_PATH("nfc/.mfkey_nonces.bin")
 #define MAX_NAME_LEN                 32
 #define MAX_PATH_LEN                 64
 
@@ -28,34 +30,219 @@
 #define SWAPENDIAN(x) \
     ((x) = ((x) >> 8 & 0xff00ff) | ((x) & 0xff00ff) << 8, (x) = (x) >> 16 | (x) << 16)
 
-bool key_already_found_for_nonce_in_dict(KeysDict* dict, MfClassicNonce* nonce) {
+#define NONCE_CACHE_MAGIC   0x4E4B464D // "MFKN"
+#define NONCE_CACHE_VERSION 3
+#define NONCE_CACHE_CHUNK   8 // Records per read/write
+#define NONCE_CACHE_PARITY  0x01 // Record flag: par_1 and par_2 are valid
+
+// Binary nonce cache: the header, then count fixed size records. It remembers the size and CRC32
+// of the text logs it was converted from; when either log changes it is rebuilt from the text.
+// Log lines are fixed width, so a new capture with as many nonces has the same size.
+typedef struct {
+    uint32_t magic;
+    uint16_t version;
+    uint16_t record_size;
+    uint32_t count;
+    uint32_t mfkey32_log_size;
+    uint32_t mfkey32_log_crc;
+    uint32_t nested_log_size;
+    uint32_t nested_log_crc;
+    uint32_t crc; // CRC32 of the records
+} NonceCacheHeader;
+
+typedef struct {
+    uint8_t attack;
+    uint8_t par_1;
+    uint8_t par_2;
+    uint8_t flags;
+    uint32_t uid;
+    uint32_t nt0;
+    uint32_t nt1;
+    uint32_t enc[4]; // nr0, ar0, nr1, ar1 (Mfkey32) or ks1_1, ks1_2 (nested)
+} NonceCacheRecord;
+
+// Heap left free after loading the dictionaries into a KeyIndex
+#define KEY_INDEX_HEAP_RESERVE 8192
+
+// System and user dictionary keys, loaded once, sorted and deduplicated
+typedef struct {
+    uint64_t* keys;
+    size_t count;
+} KeyIndex;
+
+static struct Crypto1State key_to_state(uint64_t k) {
+    struct Crypto1State state = {0, 0};
+    for(int i = 0; i < 24; i++) {
+        state.odd |= (BIT(k, 2 * i + 1) << (i ^ 3));
+        state.even |= (BIT(k, 2 * i) << (i ^ 3));
+    }
+    return state;
+}
+
+static bool key_matches_nonce(struct Crypto1State key_state, MfClassicNonce* nonce) {
+    struct Crypto1State* temp = &key_state;
+    if(nonce->attack == mfkey32) {
+        crypt_word_noret(temp, nonce->uid_xor_nt1, 0);
+        crypt_word_noret(temp, nonce->nr1_enc, 1);
+        if(nonce->ar1_enc == (crypt_word(temp) ^ nonce->p64b)) {
+            return true;
+        }
+    } else if(nonce->attack == static_nested || nonce->attack == static_encrypted) {
+        uint32_t expected_ks1 = crypt_word_ret(temp, nonce->uid_xor_nt0, 0);
+        if(nonce->ks1_1_enc == expected_ks1) {
+            return true;
+        }
+    }
+    return false;
+}
+
+static int key_index_compare(const void* a, const void* b) {
+    uint64_t ka = *(const uint64_t*)a, kb = *(const uint64_t*)b;
+    return (ka > kb) - (ka < kb);
+}
+
+static size_t key_index_read_dict(KeyIndex* index, KeysDict* dict, size_t capacity) {
+    uint8_t key_bytes[sizeof(MfClassicKey)];
+    keys_dict_rewind(dict);
+    while(index->count < capacity &&
+          keys_dict_get_next_key(dict, key_bytes, sizeof(MfClassicKey))) {
+        index->keys[index->count++] = bit_lib_bytes_to_num_be(key_bytes, sizeof(MfClassicKey));
+    }
+    return index->count;
+}
+
+// Reads both dictionaries into RAM. Returns false, leaving the index empty, when they do not
+// fit; the nonce checks then read the dictionary files directly.
+bool key_index_load(
+    KeyIndex* index,
+    KeysDict* system_dict,
+    bool system_dict_exists,
+    KeysDict* user_dict) {
+    size_t capacity = keys_dict_get_total_keys(user_dict);
+    if(system_dict_exists) {
+        capacity += keys_dict_get_total_keys(system_dict);
+    }
+    index->keys = NULL;
+    index->count = 0;
+    if(capacity == 0 ||
+       memmgr_heap_get_max_free_block() < capacity * sizeof(uint64_t) + KEY_INDEX_HEAP_RESERVE) {
+        return false;
+    }
+    index->keys = malloc(capacity * sizeof(uint64_t));
+    if(system_dict_exists) {
+        key_index_read_dict(index, system_dict, capacity);
+    }
+    key_index_read_dict(index, user_dict, capacity);
+    qsort(index->keys, index->count, sizeof(uint64_t), key_index_compare);
+    // Drop keys present in both dictionaries (or twice in one)
+    size_t unique = 0;
+    for(size_t i = 0; i < index->count; i++) {
+        if(unique == 0 || index->keys[i] != index->keys[unique - 1]) {
+            index->keys[unique++] = index->keys[i];
+        }
+    }
+    index->count = unique;
+    return true;
+}
+
+void key_index_free(KeyIndex* index) {
+    free(index->keys);
+    index->keys = NULL;
+    index->count = 0;
+}
+
+// Tests one dictionary key against every unsolved nonce, returns the number it solved
+static size_t dict_test_key(
+    uint64_t k,
+    MfClassicNonceArray* nonce_array,
+    bool* solved,
+    ProgramState* program_state) {
+    struct Crypto1State key_state = key_to_state(k);
+    size_t found = 0;
+    for(size_t i = 0; i < nonce_array->total_nonces; i++) {
+        MfClassicNonce* nonce = &nonce_array->remaining_nonce_array[i];
+        if(solved[i] || !key_matches_nonce(key_state, nonce)) {
+            continue;
+        }
+        solved[i] = true;
+        bit_lib_num_to_bytes_be(k, sizeof(MfClassicKey), nonce->key.data);
+        (program_state->cracked)++;
+        (program_state->num_completed)++;
+        found++;
+    }
+    return found;
+}
+
+static size_t dict_test_file(
+    KeysDict* dict,
+    MfClassicNonceArray* nonce_array,
+    bool* solved,
+    size_t unsolved,
+    ProgramState* program_state) {
     // This function must not be passed the CUID dictionary
-    bool found = false;
     uint8_t key_bytes[sizeof(MfClassicKey)];
     keys_dict_rewind(dict);
-    while(keys_dict_get_next_key(dict, key_bytes, sizeof(MfClassicKey))) {
+    while(unsolved > 0 && keys_dict_get_next_key(dict, key_bytes, sizeof(MfClassicKey))) {
         uint64_t k = bit_lib_bytes_to_num_be(key_bytes, sizeof(MfClassicKey));
-        struct Crypto1State temp = {0, 0};
-        for(int i = 0; i < 24; i++) {
-            (&temp)->odd |= (BIT(k, 2 * i + 1) << (i ^ 3));
-            (&temp)->even |= (BIT(k, 2 * i) << (i ^ 3));
+        unsolved -= dict_test_key(k, nonce_array, solved, program_state);
+    }
+    return unsolved;
+}
+
+// Dictionary attack on all loaded nonces in a single pass over the keys: each key is expanded
+// once and tested against every nonce not solved yet. Solved nonces are dropped from the
+// array, so mfkey() only sees the ones left for recover().
+void dict_attack_nonces(
+    MfClassicNonceArray* nonce_array,
+    KeysDict* system_dict,
+    bool system_dict_exists,
+    KeysDict* user_dict,
+    ProgramState* program_state) {
+    size_t unsolved = nonce_array->total_nonces;
+    if(unsolved == 0) {
+        return;
+    }
+    bool* solved = malloc(unsolved * sizeof(bool));
+    memset(solved, 0, unsolved * sizeof(bool));
+
+    // Keys recovered in earlier runs first, most hits first: at a site that keeps reusing a
+    // few keys they solve most nonces before a dictionary key is expanded
+    uint32_t now = furi_hal_rtc_get_timestamp();
+    for(uint32_t h = 0; h < program_state->hot_key_count && unsolved > 0; h++) {
+        HotKey* hot_key = &program_state->hot_keys[h];
+        size_t found = dict_test_key(hot_key->key, nonce_array, solved, program_state);
+        if(found > 0) {
+            hot_key->hits += found;
+            hot_key->last_seen = now;
+            program_state->hot_key_hits += found;
+            unsolved -= found;
         }
-        if(nonce->attack == mfkey32) {
-            crypt_word_noret(&temp, nonce->uid_xor_nt1, 0);
-            crypt_word_noret(&temp, nonce->nr1_enc, 1);
-            if(nonce->ar1_enc == (crypt_word(&temp) ^ nonce->p64b)) {
-                found = true;
-                break;
-            }
-        } else if(nonce->attack == static_nested || nonce->attack == static_encrypted) {
-            uint32_t expected_ks1 = crypt_word_ret(&temp, nonce->uid_xor_nt0, 0);
-            if(nonce->ks1_1_enc == expected_ks1) {
-                found = true;
-                break;
-            }
+    }
+
+    KeyIndex key_index;
+    if(unsolved == 0) {
+        // All solved by hot keys, the dictionaries are not read at all
+    } else if(key_index_load(&key_index, system_dict, system_dict_exists, user_dict)) {
+        for(size_t k = 0; k < key_index.count && unsolved > 0; k++) {
+            unsolved -= dict_test_key(key_index.keys[k], nonce_array, solved, program_state);
+        }
+        key_index_free(&key_index);
+    } else {
+        if(system_dict_exists) {
+            unsolved = dict_test_file(system_dict, nonce_array, solved, unsolved, program_state);
         }
+        dict_test_file(user_dict, nonce_array, solved, unsolved, program_state);
     }
-    return found;
+
+    size_t remaining = 0;
+    for(size_t i = 0; i < nonce_array->total_nonces; i++) {
+        if(!solved[i]) {
+            nonce_array->remaining_nonce_array[remaining++] = nonce_array->remaining_nonce_array[i];
+        }
+    }
+    nonce_array->total_nonces = remaining;
+    nonce_array->remaining_nonces = remaining;
+    free(solved);
 }
 
 bool napi_mf_classic_mfkey32_nonces_check_presence() {
@@ -109,12 +296,215 @@ int binaryStringToInt(const char* binStr) {
     return result;
 }
 
-bool load_mfkey32_nonces(
-    MfClassicNonceArray* nonce_array,
-    ProgramState* program_state,
-    KeysDict* system_dict,
-    bool system_dict_exists,
-    KeysDict* user_dict) {
+// Checks the logged parity bits of a word against its keystream. Three of the four bits are
+// encrypted with keystream bits inside ks, only the last one uses the bit after the word and
+// tells candidate states apart. Mismatches mean the parity was logged in another form.
+static bool nonce_parity_consistent(uint32_t plain, uint32_t ks, uint8_t par) {
+    for(int i = 0; i < 3; i++) {
+        uint8_t expected = nfc_util_even_parity8(plain >> (24 - 8 * i)) ^ BEBIT(ks, 8 * (i + 1));
+        if(BIT(par, 3 - i) != expected) {
+            return false;
+        }
+    }
+    return true;
+}
+
+static void nonce_array_push(MfClassicNonceArray* nonce_array, const MfClassicNonce* nonce) {
+    if(nonce_array->remaining_nonces == nonce_array->capacity) {
+        // Grow geometrically, growing by one entry per nonce fragments the heap
+        nonce_array->capacity = nonce_array->capacity < 8 ? 8 : nonce_array->capacity * 2;
+        nonce_array->remaining_nonce_array = realloc( //-V701
+            nonce_array->remaining_nonce_array,
+            sizeof(MfClassicNonce) * nonce_array->capacity);
+    }
+    nonce_array->remaining_nonce_array[nonce_array->remaining_nonces++] = *nonce;
+    nonce_array->total_nonces++;
+}
+
+static void nonce_cache_pack(const MfClassicNonce* nonce, NonceCacheRecord* record) {
+    memset(record, 0, sizeof(NonceCacheRecord));
+    record->attack = nonce->attack;
+    record->uid = nonce->uid;
+    record->nt0 = nonce->nt0;
+    record->nt1 = nonce->nt1;
+    record->par_1 = nonce->par_1;
+    record->par_2 = nonce->par_2;
+    record->flags = nonce->parity ? NONCE_CACHE_PARITY : 0;
+    if(nonce->attack == mfkey32) {
+        record->enc[0] = nonce->nr0_enc;
+        record->enc[1] = nonce->ar0_enc;
+        record->enc[2] = nonce->nr1_enc;
+        record->enc[3] = nonce->ar1_enc;
+    } else {
+        record->enc[0] = nonce->ks1_1_enc;
+        record->enc[1] = nonce->ks1_2_enc;
+    }
+}
+
+static void nonce_cache_unpack(const NonceCacheRecord* record, MfClassicNonce* nonce) {
+    memset(nonce, 0, sizeof(MfClassicNonce));
+    nonce->attack = record->attack;
+    nonce->uid = record->uid;
+    nonce->nt0 = record->nt0;
+    nonce->nt1 = record->nt1;
+    nonce->uid_xor_nt0 = nonce->uid ^ nonce->nt0;
+    nonce->par_1 = record->par_1;
+    nonce->par_2 = record->par_2;
+    nonce->parity = record->flags & NONCE_CACHE_PARITY;
+    if(nonce->attack == mfkey32) {
+        nonce->nr0_enc = record->enc[0];
+        nonce->ar0_enc = record->enc[1];
+        nonce->nr1_enc = record->enc[2];
+        nonce->ar1_enc = record->enc[3];
+        nonce->p64 = prng_successor(nonce->nt0, 64);
+        nonce->p64b = prng_successor(nonce->nt1, 64);
+        nonce->uid_xor_nt1 = nonce->uid ^ nonce->nt1;
+    } else {
+        nonce->ks1_1_enc = record->enc[0];
+        nonce->ks1_2_enc = record->enc[1];
+        nonce->nt0_seeded = prng_seed_nonce(nonce->nt0);
+        if(nonce->attack == static_nested) {
+            nonce->uid_xor_nt1 = nonce->uid ^ nonce->nt1;
+        }
+    }
+}
+
+// Size and CRC32 of a text log, both 0 if it does not exist
+static void
+    nonce_cache_log_digest(Stream* stream, const char* path, uint32_t* size, uint32_t* crc) {
+    uint8_t buffer[64];
+    size_t read;
+
+    *size = 0;
+    *crc = 0;
+    if(buffered_file_stream_open(stream, path, FSAM_READ, FSOM_OPEN_EXISTING)) {
+        while((read = stream_read(stream, buffer, sizeof(buffer))) > 0) {
+            *crc = crc32_calc_buffer(*crc, buffer, read);
+            *size += read;
+        }
+    }
+    buffered_file_stream_close(stream);
+}
+
+static void nonce_cache_log_digests(Stream* stream, NonceCacheHeader* header) {
+    nonce_cache_log_digest(
+        stream, MF_CLASSIC_NONCE_PATH, &header->mfkey32_log_size, &header->mfkey32_log_crc);
+    nonce_cache_log_digest(
+        stream, MF_CLASSIC_NESTED_NONCE_PATH, &header->nested_log_size, &header->nested_log_crc);
+}
+
+// Loads the nonces from the binary cache if it matches the current text logs
+bool load_nonce_cache(MfClassicNonceArray* nonce_array, ProgramState* program_state) {
+    NonceCacheHeader header, logs;
+    NonceCacheRecord records[NONCE_CACHE_CHUNK];
+    bool loaded = false;
+
+    nonce_cache_log_digests(nonce_array->stream, &logs);
+    do {
+        if(!buffered_file_stream_open(
+               nonce_array->stream, MF_CLASSIC_NONCE_CACHE_PATH, FSAM_READ, FSOM_OPEN_EXISTING)) {
+            break;
+        }
+        if(stream_read(nonce_array->stream, (uint8_t*)&header, sizeof(header)) !=
+           sizeof(header)) {
+            break;
+        }
+        if(header.magic != NONCE_CACHE_MAGIC || header.version != NONCE_CACHE_VERSION ||
+           header.record_size != sizeof(NonceCacheRecord) || header.count == 0 ||
+           header.mfkey32_log_size != logs.mfkey32_log_size ||
+           header.mfkey32_log_crc != logs.mfkey32_log_crc ||
+           header.nested_log_size != logs.nested_log_size ||
+           header.nested_log_crc != logs.nested_log_crc) {
+            break;
+        }
+        if(stream_size(nonce_array->stream) !=
+           sizeof(header) + header.count * sizeof(NonceCacheRecord)) {
+            break;
+        }
+        // The count is known upfront, allocate the array once
+        free(nonce_array->remaining_nonce_array);
+        nonce_array->remaining_nonce_array = malloc(sizeof(MfClassicNonce) * header.count);
+        nonce_array->capacity = header.count;
+        uint32_t crc = 0;
+        uint32_t read = 0;
+        while(read < header.count) {
+            uint32_t chunk = header.count - read;
+            if(chunk > NONCE_CACHE_CHUNK) chunk = NONCE_CACHE_CHUNK;
+            size_t chunk_bytes = chunk * sizeof(NonceCacheRecord);
+            if(stream_read(nonce_array->stream, (uint8_t*)records, chunk_bytes) != chunk_bytes) {
+                break;
+            }
+            crc = crc32_calc_buffer(crc, records, chunk_bytes);
+            for(uint32_t i = 0; i < chunk; i++) {
+                nonce_cache_unpack(&records[i], &nonce_array->remaining_nonce_array[read + i]);
+            }
+            read += chunk;
+        }
+        if(read != header.count || crc != header.crc) {
+            break;
+        }
+        nonce_array->remaining_nonces = header.count;
+        nonce_array->total_nonces = header.count;
+        program_state->total += header.count;
+        loaded = true;
+    } while(false);
+
+    buffered_file_stream_close(nonce_array->stream);
+    return loaded;
+}
+
+// Writes the nonces parsed from the text logs to the binary cache
+bool save_nonce_cache(MfClassicNonceArray* nonce_array) {
+    NonceCacheHeader header = {
+        .magic = NONCE_CACHE_MAGIC,
+        .version = NONCE_CACHE_VERSION,
+        .record_size = sizeof(NonceCacheRecord),
+        .count = nonce_array->total_nonces,
+    };
+    NonceCacheRecord records[NONCE_CACHE_CHUNK];
+    bool saved = false;
+
+    if(header.count == 0) {
+        return false;
+    }
+    nonce_cache_log_digests(nonce_array->stream, &header);
+    for(uint32_t i = 0; i < header.count; i++) {
+        nonce_cache_pack(&nonce_array->remaining_nonce_array[i], &records[0]);
+        header.crc = crc32_calc_buffer(header.crc, &records[0], sizeof(NonceCacheRecord));
+    }
+    do {
+        if(!buffered_file_stream_open(
+               nonce_array->stream,
+               MF_CLASSIC_NONCE_CACHE_PATH,
+               FSAM_WRITE,
+               FSOM_CREATE_ALWAYS)) {
+            break;
+        }
+        if(stream_write(nonce_array->stream, (uint8_t*)&header, sizeof(header)) !=
+           sizeof(header)) {
+            break;
+        }
+        uint32_t written = 0;
+        while(written < header.count) {
+            uint32_t chunk = header.count - written;
+            if(chunk > NONCE_CACHE_CHUNK) chunk = NONCE_CACHE_CHUNK;
+            size_t chunk_bytes = chunk * sizeof(NonceCacheRecord);
+            for(uint32_t i = 0; i < chunk; i++) {
+                nonce_cache_pack(&nonce_array->remaining_nonce_array[written + i], &records[i]);
+            }
+            if(stream_write(nonce_array->stream, (uint8_t*)records, chunk_bytes) != chunk_bytes) {
+                break;
+            }
+            written += chunk;
+        }
+        saved = written == header.count;
+    } while(false);
+
+    buffered_file_stream_close(nonce_array->stream);
+    return saved;
+}
+
+bool load_mfkey32_nonces(MfClassicNonceArray* nonce_array, ProgramState* program_state) {
     bool array_loaded = false;
 
     do {
@@ -200,21 +590,20 @@ bool load_mfkey32_nonces(
             res.uid_xor_nt0 = res.uid ^ res.nt0;
             res.uid_xor_nt1 = res.uid ^ res.nt1;
 
-            (program_state->total)++;
-            if((system_dict_exists && key_already_found_for_nonce_in_dict(system_dict, &res)) ||
-               (key_already_found_for_nonce_in_dict(user_dict, &res))) {
-                (program_state->cracked)++;
-                (program_state->num_completed)++;
-                continue;
+            // Optional parity of {nr}{ar}, only the ar bits can be checked here
+            const char* par = strstr(furi_string_get_cstr(next_line), " par0 ");
+            char par0_str[9], par1_str[9];
+            if(par && sscanf(par, " par0 %8[01] par1 %8[01]", par0_str, par1_str) == 2 &&
+               strlen(par0_str) == 8 && strlen(par1_str) == 8) {
+                res.par_1 = binaryStringToInt(par0_str);
+                res.par_2 = binaryStringToInt(par1_str);
+                res.parity =
+                    nonce_parity_consistent(res.p64, res.ar0_enc ^ res.p64, res.par_1 & 0xf) &&
+                    nonce_parity_consistent(res.p64b, res.ar1_enc ^ res.p64b, res.par_2 & 0xf);
             }
-            //FURI_LOG_I(TAG, "No key found for %8lx %8lx", res.uid, res.ar1_enc);
-            // TODO: Refactor
-            nonce_array->remaining_nonce_array = realloc( //-V701
-                nonce_array->remaining_nonce_array,
-                sizeof(MfClassicNonce) * ((nonce_array->remaining_nonces) + 1));
-            nonce_array->remaining_nonces++;
-            nonce_array->remaining_nonce_array[(nonce_array->remaining_nonces) - 1] = res;
-            nonce_array->total_nonces++;
+
+            (program_state->total)++;
+            nonce_array_push(nonce_array, &res);
         }
         furi_string_free(next_line);
         buffered_file_stream_close(nonce_array->stream);
@@ -226,12 +615,7 @@ bool load_mfkey32_nonces(
     return array_loaded;
 }
 
-bool load_nested_nonces(
-    MfClassicNonceArray* nonce_array,
-    ProgramState* program_state,
-    KeysDict* system_dict,
-    bool system_dict_exists,
-    KeysDict* user_dict) {
+bool load_nested_nonces(MfClassicNonceArray* nonce_array, ProgramState* program_state) {
     if(!buffered_file_stream_open(
            nonce_array->stream, MF_CLASSIC_NESTED_NONCE_PATH, FSAM_READ, FSOM_OPEN_EXISTING)) {
         return false;
@@ -266,27 +650,20 @@ bool load_nested_nonces(
         if(parsed >= 4) { // At least one nonce is present
             res.par_1 = binaryStringToInt(res.par_1_str);
             res.uid_xor_nt0 = res.uid ^ res.nt0;
+            res.nt0_seeded = prng_seed_nonce(res.nt0);
+            res.parity = nonce_parity_consistent(res.nt0, res.ks1_1_enc, res.par_1);
 
             if(parsed == 7) { // Both nonces are present
                 res.attack = static_nested;
                 res.par_2 = binaryStringToInt(res.par_2_str);
                 res.uid_xor_nt1 = res.uid ^ res.nt1;
+                res.parity = res.parity &&
+                             nonce_parity_consistent(res.nt1, res.ks1_2_enc, res.par_2);
             }
 
             (program_state->total)++;
-            if((system_dict_exists && key_already_found_for_nonce_in_dict(system_dict, &res)) ||
-               (key_already_found_for_nonce_in_dict(user_dict, &res))) {
-                (program_state->cracked)++;
-                (program_state->num_completed)++;
-                continue;
-            }
 
-            nonce_array->remaining_nonce_array = realloc(
-                nonce_array->remaining_nonce_array,
-                sizeof(MfClassicNonce) * (nonce_array->remaining_nonces + 1));
-            nonce_array->remaining_nonce_array[nonce_array->remaining_nonces] = res;
-            nonce_array->remaining_nonces++;
-            nonce_array->total_nonces++;
+            nonce_array_push(nonce_array, &res);
             array_loaded = true;
         }
     }
@@ -306,19 +683,25 @@ MfClassicNonceArray* napi_mf_classic_nonce_array_alloc(
     MfClassicNonceArray* nonce_array = malloc(sizeof(MfClassicNonceArray));
     MfClassicNonce* remaining_nonce_array_init = malloc(sizeof(MfClassicNonce) * 1);
     nonce_array->remaining_nonce_array = remaining_nonce_array_init;
+    nonce_array->capacity = 1;
     Storage* storage = furi_record_open(RECORD_STORAGE);
     nonce_array->stream = buffered_file_stream_alloc(storage);
     furi_record_close(RECORD_STORAGE);
 
-    if(program_state->mfkey32_present) {
-        load_mfkey32_nonces(
-            nonce_array, program_state, system_dict, system_dict_exists, user_dict);
-    }
+    if(!load_nonce_cache(nonce_array, program_state)) {
+        if(program_state->mfkey32_present) {
+            load_mfkey32_nonces(nonce_array, program_state);
+        }
+
+        if(program_state->nested_present) {
+            load_nested_nonces(nonce_array, program_state);
+        }
 
-    if(program_state->nested_present) {
-        load_nested_nonces(nonce_array, program_state, system_dict, system_dict_exists, user_dict);
+        save_nonce_cache(nonce_array);
     }
 
+    dict_attack_nonces(nonce_array, system_dict, system_dict_exists, user_dict, program_state);
+
     return nonce_array;
 }
 
@@ -1,18 +1,13 @@
 #pragma GCC optimize("O3")
 #pragma GCC optimize("-funroll-all-loops")
 
-// TODO: More efficient dictionary bruteforce by scanning through hardcoded very common keys and previously found dictionary keys first?
-//       (a cache for key_already_found_for_nonce_in_dict)
 // TODO: Selectively unroll loops to reduce binary size
 // TODO: Collect parity during Mfkey32 attacks to further optimize the attack
 // TODO: Why different sscanf between Mfkey32 and Nested?
 // TODO: "Read tag again with NFC app" message upon completion, "Complete. Keys added: <n>"
 // TODO: Separate Mfkey32 and Nested functions where possible to reduce branch statements
 // TODO: Find ~1 KB memory leak
-// TODO: Use seednt16 to reduce static encrypted key candidates: https://gist.github.com/noproto/8102f8f32546564cd674256e62ff76ea
-//       https://eprint.iacr.org/2024/1275.pdf section X
 // TODO: Static Encrypted: Minimum RAM for adding to keys dict (avoid crashes)
-// TODO: Static Encrypted: Optimize KeysDict or buffer keys to write in chunks
 
 #include <furi.h>
 #include <furi_hal.h>
@@ -22,6 +17,7 @@
 #include <inttypes.h>
 #include <toolbox/keys_dict.h>
 #include <bit_lib/bit_lib.h>
+#include <toolbox/crc32_calc.h>
 #include <toolbox/stream/buffered_file_stream.h>
 #include <dolphin/dolphin.h>
 #include <notification/notification_messages.h>
@@ -38,6 +34,14 @@
 // TODO: Remove defines that are not needed
 #define KEYS_DICT_SYSTEM_PATH EXT_PATH("nfc/assets/mf_classic_dict.nfc")
 #define KEYS_DICT_USER_PATH   EXT_PATH("nfc/assets/mf_classic_dict_user.nfc")
+#define CHECKPOINT_PATH       EXT_PATH("nfc/.mfkey_checkpoint.bin")
+#define CHECKPOINT_MAGIC      0x434B464D // "MFKC"
+#define CHECKPOINT_VERSION    2
+#define HOT_KEYS_PATH         EXT_PATH("nfc/.mfkey_hot_keys.bin")
+#define HOT_KEYS_MAGIC        0x484B464D // "MFKH"
+#define HOT_KEYS_VERSION      1
+#define HOT_KEYS_USER_TMP     EXT_PATH("nfc/assets/.mf_classic_dict_user.tmp")
+#define HOT_KEYS_USER_BAK     EXT_PATH("nfc/assets/.mf_classic_dict_user.bak")
 #define MAX_NAME_LEN          32
 #define MAX_PATH_LEN          64
 
@@ -52,11 +56,251 @@
 #define SWAPENDIAN(x) \
     ((x) = ((x) >> 8 & 0xff00ff) | ((x) & 0xff00ff) << 8, (x) = (x) >> 16 | (x) << 16)
 //#define SIZEOF(arr) sizeof(arr) / sizeof(*arr)
+// Ranges shorter than this are insertion sorted, radix_sort() passes cost 256 bins each
+#define RADIX_SORT_MIN 32
+// Entries radix_sort() can hold in its scratch space: states_buffer (1024) less the bins
+#define RADIX_SORT_CAPACITY 768
 
-static int eta_round_time = 44;
-static int eta_total_time = 705;
-// MSB_LIMIT: Chunk size (out of 256)
+// Candidate states are checked 32 at a time by the bitsliced kernel below check_state()
+#ifndef MFKEY_BITSLICED_CHECK
+#define MFKEY_BITSLICED_CHECK 1
+#endif
+
+// Per-phase timers: two reads of the cycle counter around each timed section
+#ifndef MFKEY_PHASE_TIMERS
+#define MFKEY_PHASE_TIMERS 1
+#endif
+#if MFKEY_PHASE_TIMERS
+#define PHASE_BEGIN(name)         uint32_t name = furi_hal_cortex_timer_get(0).start
+#define PHASE_END(ps, phase, name) \
+    ((ps)->phase_cycles[phase] += furi_hal_cortex_timer_get(0).start - (name))
+#else
+#define PHASE_BEGIN(name)
+#define PHASE_END(ps, phase, name)
+#endif
+
+#define STATS_LOG_PATH EXT_PATH("nfc/.mfkey_stats.log")
+
+#define CANDIDATE_SET_BITS 8
+#define CANDIDATE_SET_SIZE (1 << CANDIDATE_SET_BITS)
+// Flushed at half load, which keeps probe sequences short
+#define CANDIDATE_BATCH    (CANDIDATE_SET_SIZE / 2)
+#define CANDIDATE_USED     (1ULL << 48) // Keys are 48 bits, so a used slot is never 0
+#define CANDIDATE_LINE     13 // 12 hex digits and a newline, like keys_dict_add_key()
+
+// Round time assumed until one has been measured, in seconds
+#define ETA_ROUND_TIME 44
+
+static int eta_round_time = ETA_ROUND_TIME;
+static int eta_total_time = ETA_ROUND_TIME * 16;
+// Completed rounds and their time per attack type, at the current MSB_LIMIT
+static uint32_t eta_rounds[static_encrypted + 1];
+static uint32_t eta_rounds_ms[static_encrypted + 1];
+// MSB_LIMIT: Chunk size (out of 256), chosen by recover_alloc() from the free heap
 static int MSB_LIMIT = 16;
+#define MSB_LIMIT_MAX 256
+// Tables carved from the recover_alloc() arena, after the block pointers
+#define RECOVER_BLOCKS     5
+#define TEMP_STATES_LEN    1280
+#define STATES_BUFFER_LEN  1024
+// Left free for the allocations made during recover() (checkpoint stream, key candidates)
+#define RECOVER_HEAP_RESERVE 1024
+
+CandidateWriter* candidate_writer_alloc(KeysDict* dict) {
+    CandidateWriter* writer = malloc(sizeof(CandidateWriter));
+    memset(writer, 0, sizeof(CandidateWriter));
+    writer->dict = dict;
+    writer->set = malloc(sizeof(uint64_t) * CANDIDATE_SET_SIZE);
+    memset(writer->set, 0, sizeof(uint64_t) * CANDIDATE_SET_SIZE);
+    writer->text = malloc(CANDIDATE_BATCH * CANDIDATE_LINE);
+    return writer;
+}
+
+static int candidate_compare(const void* a, const void* b) {
+    uint64_t x = *(const uint64_t*)a, y = *(const uint64_t*)b;
+    return (x > y) - (x < y);
+}
+
+static int candidate_hex_digit(char c) {
+    if(c >= '0' && c <= '9') return c - '0';
+    if(c >= 'A' && c <= 'F') return c - 'A' + 10;
+    if(c >= 'a' && c <= 'f') return c - 'a' + 10;
+    return -1;
+}
+
+static void candidate_mark_known(uint64_t* keys, size_t n, uint64_t key, uint32_t* known) {
+    uint64_t entry = key | CANDIDATE_USED;
+    uint64_t* found = bsearch(&entry, keys, n, sizeof(uint64_t), candidate_compare);
+    if(found) {
+        size_t i = found - keys;
+        known[i / 32] |= 1UL << (i % 32);
+    }
+}
+
+// Removes the sorted keys[0..n) that the dictionary already holds: the set only dedups one
+// batch, the file has every earlier batch, round and run, and the nonces of the same UID.
+// The text buffer is free until the batch is formatted, so it is the read buffer
+static size_t candidate_writer_drop_known(CandidateWriter* writer, uint64_t* keys, size_t n) {
+    Stream* stream = writer->dict->stream;
+    uint8_t* buffer = (uint8_t*)writer->text;
+    uint32_t known[CANDIDATE_BATCH / 32] = {0};
+    uint64_t key = 0;
+    int digits = 0;
+    bool skip = false;
+    size_t read;
+    stream_rewind(stream);
+    while((read = stream_read(stream, buffer, CANDIDATE_BATCH * CANDIDATE_LINE)) > 0) {
+        for(size_t i = 0; i < read; i++) {
+            char c = buffer[i];
+            if(c == '\n') {
+                if(!skip && digits == CANDIDATE_LINE - 1) {
+                    candidate_mark_known(keys, n, key, known);
+                }
+                key = 0;
+                digits = 0;
+                skip = false;
+            } else if(!skip && c != '\r') {
+                int digit = candidate_hex_digit(c);
+                // Comments, markers and malformed lines
+                skip = digit < 0 || digits == CANDIDATE_LINE - 1;
+                key = key << 4 | digit;
+                digits++;
+            }
+        }
+    }
+    if(!skip && digits == CANDIDATE_LINE - 1) {
+        candidate_mark_known(keys, n, key, known);
+    }
+    size_t kept = 0;
+    for(size_t i = 0; i < n; i++) {
+        if(!(known[i / 32] & (1UL << (i % 32)))) {
+            keys[kept++] = keys[i];
+        }
+    }
+    writer->duplicates += n - kept;
+    return kept;
+}
+
+// Appends the buffered candidates the dictionary doesn't have yet, sorted, in a single
+// stream write
+void candidate_writer_flush(CandidateWriter* writer) {
+    static const char hex[] = "0123456789ABCDEF";
+    if(writer->count == 0) {
+        return;
+    }
+    uint32_t start = furi_get_tick();
+    size_t n = 0;
+    for(size_t i = 0; i < CANDIDATE_SET_SIZE; i++) {
+        if(writer->set[i]) {
+            writer->set[n++] = writer->set[i];
+        }
+    }
+    qsort(writer->set, n, sizeof(uint64_t), candidate_compare);
+    n = candidate_writer_drop_known(writer, writer->set, n);
+    char* line = writer->text;
+    for(size_t i = 0; i < n; i++) {
+        uint64_t key = writer->set[i];
+        for(int d = CANDIDATE_LINE - 2; d >= 0; d--) {
+            line[d] = hex[key & 0xf];
+            key >>= 4;
+        }
+        line[CANDIDATE_LINE - 1] = '\n';
+        line += CANDIDATE_LINE;
+    }
+    stream_seek(writer->dict->stream, 0, StreamOffsetFromEnd);
+    if(stream_write(writer->dict->stream, (uint8_t*)writer->text, n * CANDIDATE_LINE) !=
+       n * CANDIDATE_LINE) {
+        FURI_LOG_E(TAG, "Failed to write key candidates");
+    }
+    writer->dict->total_keys += n;
+    memset(writer->set, 0, sizeof(uint64_t) * CANDIDATE_SET_SIZE);
+    writer->count = 0;
+    writer->written += n;
+    writer->flushes++;
+    writer->flush_ticks += furi_get_tick() - start;
+}
+
+static inline void candidate_writer_add(CandidateWriter* writer, const MfClassicKey* key) {
+    uint64_t entry = bit_lib_bytes_to_num_be(key->data, sizeof(MfClassicKey)) | CANDIDATE_USED;
+    uint32_t slot = (entry * 0x9E3779B97F4A7C15ULL) >> (64 - CANDIDATE_SET_BITS);
+    while(writer->set[slot]) {
+        if(writer->set[slot] == entry) {
+            writer->duplicates++;
+            return;
+        }
+        slot = (slot + 1) & (CANDIDATE_SET_SIZE - 1);
+    }
+    writer->set[slot] = entry;
+    if(++writer->count >= CANDIDATE_BATCH) {
+        candidate_writer_flush(writer);
+    }
+}
+
+// Adds the candidates of another writer's stream, like a round of the host parallel build
+void candidate_writer_add_stream(CandidateWriter* writer, Stream* source) {
+    char line[CANDIDATE_LINE];
+    stream_rewind(source);
+    while(stream_read(source, (uint8_t*)line, CANDIDATE_LINE) == CANDIDATE_LINE) {
+        uint64_t value = 0;
+        for(int d = 0; d < CANDIDATE_LINE - 1; d++) {
+            value = value << 4 | candidate_hex_digit(line[d]);
+        }
+        MfClassicKey key;
+        bit_lib_num_to_bytes_be(value, sizeof(MfClassicKey), key.data);
+        candidate_writer_add(writer, &key);
+    }
+}
+
+// Drops candidates a stopped round flushed past size, they are written again on resume
+static void candidate_dict_truncate(KeysDict* dict, size_t size) {
+    size_t dict_size = stream_size(dict->stream);
+    if(dict_size > size && stream_seek(dict->stream, size, StreamOffsetFromStart) &&
+       stream_delete(dict->stream, dict_size - size)) {
+        dict->total_keys -= (dict_size - size) / CANDIDATE_LINE;
+    }
+}
+
+// Comment line appended once every candidate of a nonce is in the dictionary
+static void candidate_marker(MfClassicNonce* n, char* marker, size_t size) {
+    snprintf(
+        marker, size, "# mfkey %08lX %08lX", (unsigned long)n->nt0, (unsigned long)n->ks1_1_enc);
+}
+
+// Whether an earlier run already wrote all candidates of this nonce to the dictionary
+static bool candidate_writer_nonce_done(KeysDict* dict, MfClassicNonce* n) {
+    char marker[32];
+    bool done = false;
+    candidate_marker(n, marker, sizeof(marker));
+    FuriString* line = furi_string_alloc();
+    stream_rewind(dict->stream);
+    while(!done && stream_read_line(dict->stream, line)) {
+        done = furi_string_start_with_str(line, marker);
+    }
+    furi_string_free(line);
+    return done;
+}
+
+// Flushes and frees the writer, marking done_nonce as complete unless it is NULL
+void candidate_writer_free(
+    CandidateWriter* writer,
+    ProgramState* program_state,
+    MfClassicNonce* done_nonce) {
+    candidate_writer_flush(writer);
+    if(done_nonce) {
+        char marker[32];
+        candidate_marker(done_nonce, marker, sizeof(marker));
+        size_t len = strlen(marker);
+        marker[len++] = '\n';
+        stream_seek(writer->dict->stream, 0, StreamOffsetFromEnd);
+        stream_write(writer->dict->stream, (uint8_t*)marker, len);
+    }
+    program_state->candidate_duplicates += writer->duplicates;
+    program_state->candidate_flushes += writer->flushes;
+    program_state->candidate_flush_ticks += writer->flush_ticks;
+    free(writer->text);
+    free(writer->set);
+    free(writer);
+}
 
 static inline int
     check_state(struct Crypto1State* t, MfClassicNonce* n, ProgramState* program_state) {
@@ -86,6 +330,13 @@ static inline int
     } else if(n->attack == static_encrypted) {
         // TODO: Parity bits from rollback_word?
         if(n->ks1_1_enc == napi_lfsr_rollback_word(t, n->uid_xor_nt0, 0)) {
+            // The state decrypts {nt} to nt0. The tag draws nt from its 16-bit PRNG, so nt0
+            // must also be the nonce that PRNG generates from its seed (seednt16).
+            program_state->seed_checked++;
+            if(n->nt0 != n->nt0_seeded) {
+                program_state->seed_pruned++;
+                return 0;
+            }
             // Reduce with parity
             uint8_t local_parity_keystream_bits;
             struct Crypto1State temp = {t->odd, t->even};
@@ -95,13 +346,263 @@ static inline int
                 // Found key candidate
                 crypto1_get_lfsr(t, &(n->key));
                 program_state->num_candidates++;
-                keys_dict_add_key(program_state->cuid_dict, n->key.data, sizeof(MfClassicKey));
+                candidate_writer_add(program_state->candidates, &n->key);
             }
         }
     }
     return 0;
 }
 
+// Bitsliced candidate evaluation
+//
+// Tests up to 32 candidate states per call. Lane l of every word belongs to candidate l, so
+// one bitwise operation advances all 32 candidates by one LFSR bit. The LFSR is kept as a
+// bit stream: at time T the state is odd bit j = lfsr[T - 1 - 2j], even bit j = lfsr[T - 2 - 2j],
+// which makes every step a single new word instead of shifting 48 words.
+//
+// Lanes are only rejected when their first keystream word does not match, which is exactly
+// the first comparison check_state() does, so survivors still go through check_state().
+#define BITSLICE_LANES       32
+#define BITSLICE_T0          80 // Enough stream for one rollback word followed by one crypt word
+#define BITSLICE_BCAST(x, n) (0 - BIT(x, n))
+
+// Transposes a 32x32 bit matrix in place: bit j of a[l] ends up in bit l of a[j]
+static inline void bitslice_transpose32(uint32_t a[32]) {
+    uint32_t m = 0x0000FFFF;
+    for(int j = 16; j != 0; j = j >> 1, m = m ^ (m << j)) {
+        for(int k = 0; k < 32; k = (k + j + 1) & ~j) {
+            uint32_t t = ((a[k] >> j) ^ a[k + j]) & m;
+            a[k] ^= t << j;
+            a[k + j] ^= t;
+        }
+    }
+}
+
+// filter() as boolean logic, odd bit j of the state is at odd[-2j]
+// The two 4-bit filter functions (0xf22c, 0xd938) and the 5-bit output function (0xEC57E80A)
+// are the same truth tables lookup1, lookup2 and 0xEC57E80A encode
+static inline uint32_t bitslice_fa(uint32_t x0, uint32_t x1, uint32_t x2, uint32_t x3) {
+    return x2 ^ ((x1 | (x0 ^ x2)) & ~(x3 ^ (x0 & ~x1)));
+}
+
+static inline uint32_t bitslice_fb(uint32_t x0, uint32_t x1, uint32_t x2, uint32_t x3) {
+    return x0 ^ x1 ^ ((x0 ^ x2 ^ x3) | (x2 ^ (x0 | x1)));
+}
+
+static inline uint32_t bitslice_filter(const uint32_t* odd) {
+    uint32_t n0 = bitslice_fa(odd[0], odd[-2], odd[-4], odd[-6]);
+    uint32_t n1 = bitslice_fb(odd[-8], odd[-10], odd[-12], odd[-14]);
+    uint32_t n2 = bitslice_fa(odd[-16], odd[-18], odd[-20], odd[-22]);
+    uint32_t n3 = bitslice_fa(odd[-24], odd[-26], odd[-28], odd[-30]);
+    uint32_t n4 = bitslice_fb(odd[-32], odd[-34], odd[-36], odd[-38]);
+    uint32_t g0 = (n4 & n2) ^ ((n4 | n0) & ~n1);
+    uint32_t g1 = n1 ^ ((n4 ^ n2 ^ n1) & ~(n4 ^ (n2 | n0)));
+    return g0 ^ (n3 & g1);
+}
+
+// LFSR feedback, odd bit j is at odd[-2j] and even bit j at odd[-1 - 2j]. On a rollback
+// the oldest even tap (odd[-47]) is the bit being recovered and does not take part
+static inline uint32_t bitslice_feedback(const uint32_t* odd, bool rollback) {
+    uint32_t feedin = 0;
+    for(int j = 0; j < 24; j++) {
+        if(BIT(LF_POLY_ODD, j)) feedin ^= odd[-2 * j];
+        if(BIT(LF_POLY_EVEN, j) && !(rollback && j == 23)) feedin ^= odd[-1 - 2 * j];
+    }
+    return feedin;
+}
+
+// Bitsliced napi_lfsr_rollback_word()/rollback_word_noret() with fb = 0, compares the
+// keystream against ks (if alive is non-zero) and returns the lanes that still match
+static inline uint32_t
+    bitslice_rollback_word(uint32_t* lfsr, int* t, uint32_t in, uint32_t ks, uint32_t alive) {
+    for(int i = 31; i >= 0; i--) {
+        uint32_t* odd = &lfsr[*t - 2];
+        if(alive) {
+            alive &= ~(bitslice_filter(odd) ^ BITSLICE_BCAST(ks, i ^ 24));
+            if(!alive) return 0;
+        }
+        lfsr[*t - 49] = lfsr[*t - 1] ^ bitslice_feedback(odd, true) ^ BITSLICE_BCAST(in, i ^ 24);
+        (*t)--;
+    }
+    return alive;
+}
+
+// Bitsliced crypt_word_ret() with x = 0, returns the lanes whose keystream matches ks
+static inline uint32_t
+    bitslice_crypt_word(uint32_t* lfsr, int* t, uint32_t in, uint32_t ks, uint32_t alive) {
+    for(int i = 0; i <= 31; i++) {
+        uint32_t* odd = &lfsr[*t - 1];
+        alive &= ~(bitslice_filter(odd) ^ BITSLICE_BCAST(ks, i ^ 24));
+        if(!alive) return 0;
+        lfsr[*t] = bitslice_feedback(odd, false) ^ BITSLICE_BCAST(in, i ^ 24);
+        (*t)++;
+    }
+    return alive;
+}
+
+// Loads up to 32 candidate states into the stream, one lane per candidate
+static inline void bitslice_load_states(
+    uint32_t* lfsr,
+    int t,
+    const uint32_t* odd_halves,
+    const uint32_t* even_halves,
+    int count) {
+    // lfsr[0..31] is only written by the rollback later on, use it to transpose
+    uint32_t* planes = &lfsr[0];
+    for(int l = 0; l < BITSLICE_LANES; l++) {
+        planes[l] = l < count ? even_halves[l] : 0;
+    }
+    bitslice_transpose32(planes);
+    for(int j = 23; j >= 0; j--) {
+        lfsr[t - 2 - 2 * j] = planes[j];
+    }
+    for(int l = 0; l < BITSLICE_LANES; l++) {
+        planes[l] = l < count ? odd_halves[l] : 0;
+    }
+    bitslice_transpose32(planes);
+    for(int j = 23; j >= 0; j--) {
+        lfsr[t - 1 - 2 * j] = planes[j];
+    }
+}
+
+// Runs the first keystream comparison of check_state() on up to 32 candidates and returns
+// the mask of lanes that passed it
+static __attribute__((noinline)) uint32_t check_states_bitsliced(
+    const uint32_t* odd_halves,
+    const uint32_t* even_halves,
+    int count,
+    uint32_t* lfsr,
+    MfClassicNonce* n) {
+    int t = BITSLICE_T0;
+    uint32_t alive = count == BITSLICE_LANES ? 0xffffffff : (1u << count) - 1;
+    bitslice_load_states(lfsr, t, odd_halves, even_halves, count);
+
+    if(n->attack == mfkey32) {
+        alive = bitslice_rollback_word(lfsr, &t, 0, n->ar0_enc ^ n->p64, alive);
+    } else if(n->attack == static_nested) {
+        bitslice_rollback_word(lfsr, &t, n->uid_xor_nt1, 0, 0);
+        alive = bitslice_crypt_word(lfsr, &t, n->uid_xor_nt0, n->ks1_1_enc, alive);
+    } else if(n->attack == static_encrypted) {
+        alive = bitslice_rollback_word(lfsr, &t, n->uid_xor_nt0, n->ks1_1_enc, alive);
+    }
+    return alive;
+}
+
+// Parity pre-filter: the parity bit of the last byte of the word the tables were built from is
+// encrypted with the keystream bit after it, filter() of the candidate state itself. Returns
+// that bit, or -1 if the nonce has no usable parity.
+static inline int parity_filter_bit(MfClassicNonce* n) {
+    if(!n->parity) return -1;
+    switch(n->attack) {
+    case mfkey32:
+        return BIT(n->par_1, 0) ^ nfc_util_even_parity8(n->p64);
+    case static_nested:
+        return BIT(n->par_2, 0) ^ nfc_util_even_parity8(n->nt1);
+    case static_encrypted:
+        return BIT(n->par_1, 0) ^ nfc_util_even_parity8(n->nt0);
+    }
+    return -1;
+}
+
+// Final old_recover() step: every odd/even combination goes through check_state()
+static __attribute__((noinline)) int old_recover_scalar(
+    unsigned int odd[],
+    int o_head,
+    int o_tail,
+    unsigned int even[],
+    int e_head,
+    int e_tail,
+    int s,
+    MfClassicNonce* n,
+    unsigned int in,
+    ProgramState* program_state) {
+    int parity = parity_filter_bit(n);
+    uint32_t checked = 0, pruned = 0;
+    for(int e = e_head; e <= e_tail; ++e) {
+        even[e] = (even[e] << 1) ^ evenparity32(even[e] & LF_POLY_EVEN) ^ (!!(in & 4));
+        for(int o = o_head; o <= o_tail; ++o, ++s) {
+            struct Crypto1State temp = {0, 0};
+            temp.even = odd[o];
+            temp.odd = even[e] ^ evenparity32(odd[o] & LF_POLY_ODD);
+            if(parity >= 0) {
+                checked++;
+                if(filter(temp.odd) != parity) {
+                    pruned++;
+                    continue;
+                }
+            }
+            if(check_state(&temp, n, program_state)) {
+                s = -1;
+                break;
+            }
+        }
+        if(s < 0) break;
+    }
+    program_state->parity_checked += checked;
+    program_state->parity_pruned += pruned;
+    return s;
+}
+
+// Final old_recover() step with the bitsliced kernel: every odd/even combination is queued
+// into batches of 32 lanes, check_state() only sees the lanes that survive the kernel
+// The batches and the kernel's LFSR stream (144 words) live in the radix_sort() scratch, which
+// is free at this depth, rather than on the stack of the recursion
+static __attribute__((noinline)) int old_recover_bitsliced(
+    unsigned int odd[],
+    int o_head,
+    int o_tail,
+    unsigned int even[],
+    int e_head,
+    int e_tail,
+    int s,
+    MfClassicNonce* n,
+    unsigned int in,
+    unsigned int* scratch,
+    ProgramState* program_state) {
+    uint32_t* batch_odd = scratch;
+    uint32_t* batch_even = scratch + BITSLICE_LANES;
+    uint32_t* lfsr = scratch + 2 * BITSLICE_LANES;
+    int count = 0;
+    int parity = parity_filter_bit(n);
+    uint32_t checked = 0, pruned = 0;
+    for(int e = e_head; e <= e_tail; ++e) {
+        even[e] = (even[e] << 1) ^ evenparity32(even[e] & LF_POLY_EVEN) ^ (!!(in & 4));
+        for(int o = o_head; o <= o_tail; ++o, ++s) {
+            uint32_t state_odd = even[e] ^ evenparity32(odd[o] & LF_POLY_ODD);
+            bool keep = true;
+            if(parity >= 0) {
+                checked++;
+                keep = filter(state_odd) == parity;
+                pruned += !keep;
+            }
+            if(keep) {
+                batch_even[count] = odd[o];
+                batch_odd[count++] = state_odd;
+            }
+            if(count < BITSLICE_LANES && (o != o_tail || e != e_tail)) {
+                continue;
+            }
+            if(!count) continue;
+            uint32_t alive = check_states_bitsliced(batch_odd, batch_even, count, lfsr, n);
+            while(alive) {
+                int lane = __builtin_ctz(alive);
+                alive &= alive - 1;
+                struct Crypto1State temp = {batch_odd[lane], batch_even[lane]};
+                if(check_state(&temp, n, program_state)) {
+                    s = -1;
+                    break;
+                }
+            }
+            if(s < 0) break;
+            count = 0;
+        }
+        if(s < 0) break;
+    }
+    program_state->parity_checked += checked;
+    program_state->parity_pruned += pruned;
+    return s;
+}
+
 static inline int state_loop(
     unsigned int* states_buffer,
     int xks,
@@ -149,44 +650,90 @@ static inline int state_loop(
     return states_tail;
 }
 
-int binsearch(unsigned int data[], int start, int stop) {
-    int mid, val = data[stop] & 0xff000000;
-    while(start != stop) {
-        mid = (stop - start) >> 1;
-        if((data[start + mid] ^ 0x80000000) > (val ^ 0x80000000))
-            stop = start + mid;
-        else
-            start += mid + 1;
-    }
-    return start;
-}
-void quicksort(unsigned int array[], int low, int high) {
-    //if (SIZEOF(array) == 0)
-    //    return;
-    if(low >= high) return;
-    int middle = low + (high - low) / 2;
-    unsigned int pivot = array[middle];
-    int i = low, j = high;
-    while(i <= j) {
-        while(array[i] < pivot) {
-            i++;
-        }
-        while(array[j] > pivot) {
-            j--;
-        }
-        if(i <= j) { // swap
-            int temp = array[i];
-            array[i] = array[j];
-            array[j] = temp;
-            i++;
+// Start of the run of entries sharing data[stop]'s top byte, walking down from stop.
+// Entries whose low 24 bits are all zero are left out of the run, as they always were.
+static inline int group_head(unsigned int data[], int start, int stop) {
+    unsigned int val = data[stop] & 0xff000000;
+    while(stop > start && data[stop - 1] > val) {
+        stop--;
+    }
+    return stop;
+}
+
+static void insertion_sort(unsigned int data[], int low, int high) {
+    for(int i = low + 1; i <= high; i++) {
+        unsigned int val = data[i];
+        int j = i - 1;
+        while(j >= low && data[j] > val) {
+            data[j + 1] = data[j];
             j--;
         }
+        data[j + 1] = val;
+    }
+}
+
+static void heap_sift_down(unsigned int* heap, int root, int count) {
+    unsigned int val = heap[root];
+    for(int child; (child = 2 * root + 1) < count; root = child) {
+        if(child + 1 < count && heap[child + 1] > heap[child]) child++;
+        if(heap[child] <= val) break;
+        heap[root] = heap[child];
+    }
+    heap[root] = val;
+}
+
+// In place and O(n log n), for ranges that outgrow the radix_sort() scratch space
+static void heap_sort(unsigned int data[], int low, int high) {
+    unsigned int* heap = data + low;
+    int count = high - low + 1;
+    for(int i = count / 2 - 1; i >= 0; i--) {
+        heap_sift_down(heap, i, count);
     }
-    if(low < j) {
-        quicksort(array, low, j);
+    for(int end = count - 1; end > 0; end--) {
+        unsigned int top = heap[0];
+        heap[0] = heap[end];
+        heap[end] = top;
+        heap_sift_down(heap, 0, end);
     }
-    if(high > i) {
-        quicksort(array, i, high);
+}
+
+// Sorts data[low..high] with an LSD radix sort on bytes. scratch holds the 256 bins followed
+// by room for RADIX_SORT_CAPACITY entries; short ranges use insertion sort, oversized ones
+// (extended tables reach TEMP_STATES_LEN) heap sort.
+void radix_sort(unsigned int data[], int low, int high, unsigned int* scratch) {
+    int count = high - low + 1;
+    if(count < RADIX_SORT_MIN) {
+        insertion_sort(data, low, high);
+        return;
+    }
+    if(count > RADIX_SORT_CAPACITY) {
+        heap_sort(data, low, high);
+        return;
+    }
+    unsigned int* bins = scratch;
+    unsigned int* src = data + low;
+    unsigned int* dst = scratch + 256;
+    unsigned int* t;
+    for(int shift = 0; shift < 32; shift += 8) {
+        memset(bins, 0, 256 * sizeof(unsigned int));
+        for(int i = 0; i < count; i++) {
+            bins[src[i] >> shift & 0xff]++;
+        }
+        // Every entry has the same digit, this pass would not move anything
+        if(bins[src[0] >> shift & 0xff] == (unsigned int)count) continue;
+        unsigned int sum = 0;
+        for(int b = 0; b < 256; b++) {
+            unsigned int bin = bins[b];
+            bins[b] = sum;
+            sum += bin;
+        }
+        for(int i = 0; i < count; i++) {
+            dst[bins[src[i] >> shift & 0xff]++] = src[i];
+        }
+        t = src, src = dst, dst = t;
+    }
+    if(src != data + low) {
+        memcpy(data + low, src, count * sizeof(unsigned int));
     }
 }
 int extend_table(unsigned int data[], int tbl, int end, int bit, int m1, int m2, unsigned int in) {
@@ -224,20 +771,18 @@ int old_recover(
     MfClassicNonce* n,
     unsigned int in,
     int first_run,
+    unsigned int* sort_scratch,
     ProgramState* program_state) {
     int o, e, i;
     if(rem == -1) {
-        for(e = e_head; e <= e_tail; ++e) {
-            even[e] = (even[e] << 1) ^ evenparity32(even[e] & LF_POLY_EVEN) ^ (!!(in & 4));
-            for(o = o_head; o <= o_tail; ++o, ++s) {
-                struct Crypto1State temp = {0, 0};
-                temp.even = odd[o];
-                temp.odd = even[e] ^ evenparity32(odd[o] & LF_POLY_ODD);
-                if(check_state(&temp, n, program_state)) {
-                    return -1;
-                }
-            }
-        }
+        PHASE_BEGIN(check_start);
+#if MFKEY_BITSLICED_CHECK
+        s = old_recover_bitsliced(
+            odd, o_head, o_tail, even, e_head, e_tail, s, n, in, sort_scratch, program_state);
+#else
+        s = old_recover_scalar(odd, o_head, o_tail, even, e_head, e_tail, s, n, in, program_state);
+#endif
+        PHASE_END(program_state, PhaseCheck, check_start);
         return s;
     }
     if(first_run == 0) {
@@ -254,12 +799,15 @@ int old_recover(
         }
     }
     first_run = 0;
-    quicksort(odd, o_head, o_tail);
-    quicksort(even, e_head, e_tail);
+    PHASE_BEGIN(sort_start);
+    radix_sort(odd, o_head, o_tail, sort_scratch);
+    radix_sort(even, e_head, e_tail, sort_scratch);
+    PHASE_END(program_state, PhaseSort, sort_start);
+    // Merge-join the sorted tables from the top, one run of equal top bytes at a time
     while(o_tail >= o_head && e_tail >= e_head) {
         if(((odd[o_tail] ^ even[e_tail]) >> 24) == 0) {
-            o_tail = binsearch(odd, o_head, o = o_tail);
-            e_tail = binsearch(even, e_head, e = e_tail);
+            o_tail = group_head(odd, o_head, o = o_tail);
+            e_tail = group_head(even, e_head, e = e_tail);
             s = old_recover(
                 odd,
                 o_tail--,
@@ -274,14 +822,15 @@ int old_recover(
                 n,
                 in,
                 first_run,
+                sort_scratch,
                 program_state);
             if(s == -1) {
                 break;
             }
-        } else if((odd[o_tail] ^ 0x80000000) > (even[e_tail] ^ 0x80000000)) {
-            o_tail = binsearch(odd, o_head, o_tail) - 1;
+        } else if(odd[o_tail] > even[e_tail]) {
+            o_tail = group_head(odd, o_head, o_tail) - 1;
         } else {
-            e_tail = binsearch(even, e_head, e_tail) - 1;
+            e_tail = group_head(even, e_head, e_tail) - 1;
         }
     }
     return s;
@@ -307,6 +856,48 @@ static inline int sync_state(ProgramState* program_state) {
     return 0;
 }
 
+#define MSB_CAPACITY (sizeof(((struct Msb*)0)->states) / sizeof(uint32_t))
+// Every state in a bucket has the bucket's MSB as its top byte, so any other top byte marks an
+// empty slot
+#define MSB_EMPTY(msb) ((uint32_t)(~(msb) & 0xff) << 24)
+
+static inline void msb_clear(struct Msb* bucket, unsigned int msb) {
+    bucket->tail = 0;
+    for(unsigned int k = 0; k < MSB_CAPACITY; k++) {
+        bucket->states[k] = MSB_EMPTY(msb);
+    }
+}
+
+// Adds state to the bucket unless it is already present, returns the number of slots probed
+static inline uint32_t msb_insert(struct Msb* bucket, uint32_t state, unsigned int msb) {
+    // Fibonacci hashing of the low 24 bits, the top byte is the same for the whole bucket
+    uint32_t slot = (uint32_t)(((uint64_t)((state << 8) * 2654435769u) * MSB_CAPACITY) >> 32);
+    uint32_t probes = 1;
+    while(bucket->states[slot] != state) {
+        if(bucket->states[slot] == MSB_EMPTY(msb)) {
+            // Never fill the last slot, a lookup must always reach an empty one
+            if(bucket->tail < (int)MSB_CAPACITY - 1) {
+                bucket->states[slot] = state;
+                bucket->tail++;
+            }
+            break;
+        }
+        if(++slot == MSB_CAPACITY) slot = 0;
+        probes++;
+    }
+    return probes;
+}
+
+// Moves the states to the front of the bucket, as old_recover() expects
+static inline void msb_compact(struct Msb* bucket, unsigned int msb) {
+    int tail = 0;
+    for(unsigned int k = 0; k < MSB_CAPACITY; k++) {
+        if(bucket->states[k] != MSB_EMPTY(msb)) {
+            bucket->states[tail++] = bucket->states[k];
+        }
+    }
+}
+
 int calculate_msb_tables(
     int oks,
     int eks,
@@ -322,13 +913,16 @@ int calculate_msb_tables(
     //FURI_LOG_I(TAG, "MSB GO %i", msb_iter); // DEBUG
     unsigned int msb_head = (MSB_LIMIT * msb_round); // msb_iter ranges from 0 to (256/MSB_LIMIT)-1
     unsigned int msb_tail = (MSB_LIMIT * (msb_round + 1));
-    int states_tail = 0, tail = 0;
-    int i = 0, j = 0, semi_state = 0, found = 0;
+    PHASE_BEGIN(table_start);
+    int states_tail = 0;
+    int i = 0, semi_state = 0;
     unsigned int msb = 0;
+    uint32_t lookups = 0, probes = 0, probed = 0, collisions = 0;
     in = ((in >> 16 & 0xff) | (in << 16) | (in & 0xff00)) << 1;
-    // TODO: Why is this necessary?
-    memset(odd_msbs, 0, MSB_LIMIT * sizeof(struct Msb));
-    memset(even_msbs, 0, MSB_LIMIT * sizeof(struct Msb));
+    for(i = 0; i < MSB_LIMIT; i++) {
+        msb_clear(&odd_msbs[i], msb_head + i);
+        msb_clear(&even_msbs[i], msb_head + i);
+    }
 
     for(semi_state = 1 << 20; semi_state >= 0; semi_state--) {
         if(semi_state % 32768 == 0) {
@@ -344,18 +938,10 @@ int calculate_msb_tables(
             for(i = states_tail; i >= 0; i--) {
                 msb = states_buffer[i] >> 24;
                 if((msb >= msb_head) && (msb < msb_tail)) {
-                    found = 0;
-                    for(j = 0; j < odd_msbs[msb - msb_head].tail - 1; j++) {
-                        if(odd_msbs[msb - msb_head].states[j] == states_buffer[i]) {
-                            found = 1;
-                            break;
-                        }
-                    }
-
-                    if(!found) {
-                        tail = odd_msbs[msb - msb_head].tail++;
-                        odd_msbs[msb - msb_head].states[tail] = states_buffer[i];
-                    }
+                    probed = msb_insert(&odd_msbs[msb - msb_head], states_buffer[i], msb);
+                    probes += probed;
+                    collisions += probed > 1;
+                    lookups++;
                 }
             }
         }
@@ -367,24 +953,24 @@ int calculate_msb_tables(
             for(i = 0; i <= states_tail; i++) {
                 msb = states_buffer[i] >> 24;
                 if((msb >= msb_head) && (msb < msb_tail)) {
-                    found = 0;
-
-                    for(j = 0; j < even_msbs[msb - msb_head].tail; j++) {
-                        if(even_msbs[msb - msb_head].states[j] == states_buffer[i]) {
-                            found = 1;
-                            break;
-                        }
-                    }
-
-                    if(!found) {
-                        tail = even_msbs[msb - msb_head].tail++;
-                        even_msbs[msb - msb_head].states[tail] = states_buffer[i];
-                    }
+                    probed = msb_insert(&even_msbs[msb - msb_head], states_buffer[i], msb);
+                    probes += probed;
+                    collisions += probed > 1;
+                    lookups++;
                 }
             }
         }
     }
 
+    for(i = 0; i < MSB_LIMIT; i++) {
+        msb_compact(&odd_msbs[i], msb_head + i);
+        msb_compact(&even_msbs[i], msb_head + i);
+    }
+    program_state->msb_lookups += lookups;
+    program_state->msb_probes += probes;
+    program_state->msb_collisions += collisions;
+    PHASE_END(program_state, PhaseTableBuild, table_start);
+
     oks >>= 12;
     eks >>= 12;
 
@@ -392,11 +978,24 @@ int calculate_msb_tables(
         if(sync_state(program_state) == 1) {
             return 0;
         }
-        // TODO: Why is this necessary?
-        memset(temp_states_even, 0, sizeof(unsigned int) * (1280));
-        memset(temp_states_odd, 0, sizeof(unsigned int) * (1280));
         memcpy(temp_states_odd, odd_msbs[i].states, odd_msbs[i].tail * sizeof(unsigned int));
         memcpy(temp_states_even, even_msbs[i].states, even_msbs[i].tail * sizeof(unsigned int));
+        // old_recover() reads one entry past the tail and extends the tables in place, so
+        // the rest of the temp arrays has to start out zeroed
+        memset(
+            temp_states_odd + odd_msbs[i].tail,
+            0,
+            (TEMP_STATES_LEN - odd_msbs[i].tail) * sizeof(unsigned int));
+        memset(
+            temp_states_even + even_msbs[i].tail,
+            0,
+            (TEMP_STATES_LEN - even_msbs[i].tail) * sizeof(unsigned int));
+#if MFKEY_PHASE_TIMERS
+        // Sort and check time is recorded inside, join gets the rest
+        uint64_t nested_cycles =
+            program_state->phase_cycles[PhaseSort] + program_state->phase_cycles[PhaseCheck];
+#endif
+        PHASE_BEGIN(join_start);
         int res = old_recover(
             temp_states_odd,
             0,
@@ -411,7 +1010,14 @@ int calculate_msb_tables(
             n,
             in >> 16,
             1,
+            states_buffer,
             program_state);
+        PHASE_END(program_state, PhaseJoin, join_start);
+#if MFKEY_PHASE_TIMERS
+        program_state->phase_cycles[PhaseJoin] -= program_state->phase_cycles[PhaseSort] +
+                                                  program_state->phase_cycles[PhaseCheck] -
+                                                  nested_cycles;
+#endif
         if(res == -1) {
             return 1;
         }
@@ -422,105 +1028,590 @@ int calculate_msb_tables(
     return 0;
 }
 
-void** allocate_blocks(const size_t* block_sizes, int num_blocks) {
-    void** block_pointers = malloc(num_blocks * sizeof(void*));
+bool is_full_speed() {
+    return MSB_LIMIT >= 16;
+}
+
+// Progress of an interrupted mfkey() run, the found keys follow the header. Keys saved when
+// the run was stopped go to the user dict, so on resume the dictionary attack may solve more
+// nonces: the next nonce is located by its hash rather than its index. msb_done counts MSB
+// values (not rounds), a multiple of the msb_limit it was saved at
+typedef struct {
+    uint32_t magic;
+    uint16_t version;
+    uint16_t key_count;
+    uint32_t nonce_hash; // Hash of the nonce at nonce_index
+    uint32_t nonce_index;
+    uint32_t nonce_total; // nonce_index == nonce_total: all nonces were done
+    uint32_t msb_done;
+    uint32_t msb_limit; // MSB_LIMIT of the interrupted nonce
+    int32_t cracked;
+    int32_t unique_cracked;
+    int32_t num_completed;
+    int32_t num_candidates;
+    uint32_t candidate_dict_size; // Static encrypted: per-UID dict size covered by msb_done
+    uint32_t crc; // Header with crc = 0, then the keys
+} CheckpointHeader;
+
+// Keys recovered in earlier runs, ranked by how many nonces they solved. The records follow
+// the header, best first
+typedef struct {
+    uint32_t magic;
+    uint16_t version;
+    uint16_t count;
+    uint32_t crc; // Records only
+} HotKeysHeader;
+
+static struct {
+    bool enabled; // Set by mfkey(), recover() alone (host benchmark) never saves
+    MfClassicNonceArray* nonce_arr;
+    uint32_t nonce_index;
+    uint32_t msb_done; // Where recover() starts for nonce_index
+    uint32_t msb_limit;
+    uint32_t candidate_dict_size;
+    MfClassicKey* keys;
+    size_t key_count;
+} checkpoint;
+
+static uint32_t checkpoint_nonce_hash(MfClassicNonce* nonce) {
+    uint32_t words[6] = {nonce->attack, nonce->uid, nonce->nt0, nonce->nt1};
+    if(nonce->attack == mfkey32) {
+        words[4] = nonce->nr1_enc;
+        words[5] = nonce->ar1_enc;
+    } else {
+        words[4] = nonce->ks1_1_enc;
+        words[5] = nonce->ks1_2_enc;
+    }
+    return crc32_calc_buffer(0, words, sizeof(words));
+}
+
+static uint32_t checkpoint_crc(CheckpointHeader* header, MfClassicKey* keys) {
+    uint32_t crc = header->crc;
+    header->crc = 0;
+    uint32_t result = crc32_calc_buffer(0, header, sizeof(CheckpointHeader));
+    result = crc32_calc_buffer(result, keys, sizeof(MfClassicKey) * header->key_count);
+    header->crc = crc;
+    return result;
+}
+
+static bool checkpoint_exists() {
+    Storage* storage = furi_record_open(RECORD_STORAGE);
+    bool exists = storage_common_stat(storage, CHECKPOINT_PATH, NULL) == FSE_OK;
+    furi_record_close(RECORD_STORAGE);
+    return exists;
+}
+
+static void checkpoint_remove() {
+    Storage* storage = furi_record_open(RECORD_STORAGE);
+    storage_simply_remove(storage, CHECKPOINT_PATH);
+    furi_record_close(RECORD_STORAGE);
+}
+
+// Records that everything before MSB value msb_done of nonce nonce_index is done
+static void checkpoint_save(ProgramState* program_state, uint32_t nonce_index, uint32_t msb_done) {
+    if(!checkpoint.enabled) {
+        return;
+    }
+    MfClassicNonceArray* nonce_arr = checkpoint.nonce_arr;
+    CheckpointHeader header = {
+        .magic = CHECKPOINT_MAGIC,
+        .version = CHECKPOINT_VERSION,
+        .key_count = checkpoint.key_count,
+        .nonce_index = nonce_index,
+        .nonce_total = nonce_arr->total_nonces,
+        .msb_done = msb_done,
+        .msb_limit = MSB_LIMIT,
+        .cracked = program_state->cracked,
+        .unique_cracked = program_state->unique_cracked,
+        .num_completed = program_state->num_completed,
+        .num_candidates = program_state->num_candidates,
+    };
+    if(msb_done > 0 && program_state->cuid_dict) {
+        header.candidate_dict_size = stream_size(program_state->cuid_dict->stream);
+    }
+    if(nonce_index < nonce_arr->total_nonces) {
+        header.nonce_hash =
+            checkpoint_nonce_hash(&nonce_arr->remaining_nonce_array[nonce_index]);
+    }
+    header.crc = checkpoint_crc(&header, checkpoint.keys);
+    size_t keys_size = sizeof(MfClassicKey) * header.key_count;
+    Storage* storage = furi_record_open(RECORD_STORAGE);
+    Stream* stream = buffered_file_stream_alloc(storage);
+    if(buffered_file_stream_open(stream, CHECKPOINT_PATH, FSAM_WRITE, FSOM_CREATE_ALWAYS)) {
+        if(stream_write(stream, (uint8_t*)&header, sizeof(header)) != sizeof(header) ||
+           stream_write(stream, (uint8_t*)checkpoint.keys, keys_size) != keys_size) {
+            FURI_LOG_E(TAG, "Failed to write checkpoint");
+        }
+    }
+    buffered_file_stream_close(stream);
+    stream_free(stream);
+    furi_record_close(RECORD_STORAGE);
+}
 
-    for(int i = 0; i < num_blocks; i++) {
-        if(memmgr_heap_get_max_free_block() < block_sizes[i]) {
-            // Not enough memory, free previously allocated blocks
-            for(int j = 0; j < i; j++) {
-                free(block_pointers[j]);
+// Restores the counters and found keys of a checkpoint made for the current nonces
+static bool checkpoint_load(
+    ProgramState* program_state,
+    MfClassicKey** keyarray,
+    size_t* keyarray_size) {
+    MfClassicNonceArray* nonce_arr = checkpoint.nonce_arr;
+    uint32_t nonce_index = nonce_arr->total_nonces;
+    CheckpointHeader header;
+    MfClassicKey* keys = NULL;
+    bool loaded = false;
+    Storage* storage = furi_record_open(RECORD_STORAGE);
+    Stream* stream = buffered_file_stream_alloc(storage);
+    do {
+        if(!buffered_file_stream_open(stream, CHECKPOINT_PATH, FSAM_READ, FSOM_OPEN_EXISTING)) {
+            break;
+        }
+        if(stream_read(stream, (uint8_t*)&header, sizeof(header)) != sizeof(header)) {
+            break;
+        }
+        if(header.magic != CHECKPOINT_MAGIC || header.version != CHECKPOINT_VERSION ||
+           header.nonce_index > header.nonce_total || header.msb_done > 256 ||
+           header.msb_limit == 0 || header.msb_limit > MSB_LIMIT_MAX ||
+           (header.msb_limit & (header.msb_limit - 1)) != 0 ||
+           header.msb_done % header.msb_limit != 0) {
+            break;
+        }
+        size_t keys_size = sizeof(MfClassicKey) * header.key_count;
+        keys = malloc(keys_size + sizeof(MfClassicKey));
+        if(stream_read(stream, (uint8_t*)keys, keys_size) != keys_size) {
+            break;
+        }
+        if(checkpoint_crc(&header, keys) != header.crc) {
+            break;
+        }
+        if(header.nonce_index < header.nonce_total) {
+            // Nonces only ever disappear from the array, so look at or before the old index
+            uint32_t j = header.nonce_index < nonce_arr->total_nonces ? header.nonce_index + 1 :
+                                                                        nonce_arr->total_nonces;
+            while(j > 0 &&
+                  checkpoint_nonce_hash(&nonce_arr->remaining_nonce_array[j - 1]) !=
+                      header.nonce_hash) {
+                j--;
             }
-            free(block_pointers);
-            return NULL;
+            if(j == 0) {
+                break;
+            }
+            nonce_index = j - 1;
+        }
+        loaded = true;
+    } while(false);
+    buffered_file_stream_close(stream);
+    stream_free(stream);
+    furi_record_close(RECORD_STORAGE);
+    if(!loaded) {
+        free(keys);
+        return false;
+    }
+    free(*keyarray);
+    *keyarray = keys;
+    *keyarray_size = header.key_count;
+    checkpoint.nonce_index = nonce_index;
+    checkpoint.msb_done = header.msb_done;
+    checkpoint.msb_limit = header.msb_limit;
+    checkpoint.candidate_dict_size = header.candidate_dict_size;
+    program_state->cracked = header.cracked;
+    program_state->unique_cracked = header.unique_cracked;
+    program_state->num_completed = header.num_completed;
+    program_state->num_candidates = header.num_candidates;
+    return true;
+}
+
+static int hot_key_compare(const void* a, const void* b) {
+    const HotKey* ka = a;
+    const HotKey* kb = b;
+    if(ka->hits != kb->hits) return ka->hits < kb->hits ? 1 : -1;
+    if(ka->last_seen != kb->last_seen) return ka->last_seen < kb->last_seen ? 1 : -1;
+    return (ka->key > kb->key) - (ka->key < kb->key);
+}
+
+// Reads the hot key cache into program_state->hot_keys, ranked. The array always has room
+// for HOT_KEYS_MAX entries, so keys can be credited without reallocating.
+void hot_keys_load(ProgramState* program_state) {
+    HotKeysHeader header;
+    HotKey* keys = malloc(sizeof(HotKey) * HOT_KEYS_MAX);
+    program_state->hot_keys = keys;
+    program_state->hot_key_count = 0;
+    Storage* storage = furi_record_open(RECORD_STORAGE);
+    Stream* stream = buffered_file_stream_alloc(storage);
+    do {
+        if(!buffered_file_stream_open(stream, HOT_KEYS_PATH, FSAM_READ, FSOM_OPEN_EXISTING)) {
+            break;
+        }
+        if(stream_read(stream, (uint8_t*)&header, sizeof(header)) != sizeof(header)) {
+            break;
+        }
+        if(header.magic != HOT_KEYS_MAGIC || header.version != HOT_KEYS_VERSION ||
+           header.count > HOT_KEYS_MAX) {
+            break;
+        }
+        size_t keys_size = sizeof(HotKey) * header.count;
+        if(stream_read(stream, (uint8_t*)keys, keys_size) != keys_size ||
+           crc32_calc_buffer(0, keys, keys_size) != header.crc) {
+            FURI_LOG_W(TAG, "Hot key cache is damaged, starting a new one");
+            break;
         }
+        program_state->hot_key_count = header.count;
+    } while(false);
+    buffered_file_stream_close(stream);
+    stream_free(stream);
+    furi_record_close(RECORD_STORAGE);
+    qsort(keys, program_state->hot_key_count, sizeof(HotKey), hot_key_compare);
+}
 
-        block_pointers[i] = malloc(block_sizes[i]);
+// Counts a nonce solved by recover() for key. A new key replaces the lowest ranked one when
+// the cache is full.
+void hot_keys_credit(ProgramState* program_state, const MfClassicKey* key) {
+    HotKey* keys = program_state->hot_keys;
+    if(!keys) {
+        return;
     }
+    uint64_t value = bit_lib_bytes_to_num_be(key->data, sizeof(MfClassicKey));
+    uint32_t now = furi_hal_rtc_get_timestamp();
+    uint32_t worst = 0;
+    for(uint32_t i = 0; i < program_state->hot_key_count; i++) {
+        if(keys[i].key == value) {
+            keys[i].hits++;
+            keys[i].last_seen = now;
+            return;
+        }
+        if(hot_key_compare(&keys[i], &keys[worst]) > 0) {
+            worst = i;
+        }
+    }
+    if(program_state->hot_key_count < HOT_KEYS_MAX) {
+        worst = program_state->hot_key_count++;
+    }
+    keys[worst] = (HotKey){.key = value, .hits = 1, .last_seen = now};
+}
 
-    return block_pointers;
+void hot_keys_save(ProgramState* program_state) {
+    if(!program_state->hot_keys || program_state->hot_key_count == 0) {
+        return;
+    }
+    qsort(program_state->hot_keys, program_state->hot_key_count, sizeof(HotKey), hot_key_compare);
+    size_t keys_size = sizeof(HotKey) * program_state->hot_key_count;
+    HotKeysHeader header = {
+        .magic = HOT_KEYS_MAGIC,
+        .version = HOT_KEYS_VERSION,
+        .count = program_state->hot_key_count,
+        .crc = crc32_calc_buffer(0, program_state->hot_keys, keys_size),
+    };
+    Storage* storage = furi_record_open(RECORD_STORAGE);
+    Stream* stream = buffered_file_stream_alloc(storage);
+    if(buffered_file_stream_open(stream, HOT_KEYS_PATH, FSAM_WRITE, FSOM_CREATE_ALWAYS)) {
+        if(stream_write(stream, (uint8_t*)&header, sizeof(header)) != sizeof(header) ||
+           stream_write(stream, (uint8_t*)program_state->hot_keys, keys_size) != keys_size) {
+            FURI_LOG_E(TAG, "Failed to write hot key cache");
+        }
+    }
+    buffered_file_stream_close(stream);
+    stream_free(stream);
+    furi_record_close(RECORD_STORAGE);
 }
 
-bool is_full_speed() {
-    return MSB_LIMIT == 16;
+void hot_keys_free(ProgramState* program_state) {
+    free(program_state->hot_keys);
+    program_state->hot_keys = NULL;
+    program_state->hot_key_count = 0;
 }
 
-bool recover(MfClassicNonce* n, int ks2, unsigned int in, ProgramState* program_state) {
-    bool found = false;
-    const size_t block_sizes[] = {49216, 49216, 5120, 5120, 4096};
-    const size_t reduced_block_sizes[] = {24608, 24608, 5120, 5120, 4096};
-    const int num_blocks = sizeof(block_sizes) / sizeof(block_sizes[0]);
-    void** block_pointers = allocate_blocks(block_sizes, num_blocks);
-    if(block_pointers == NULL) {
-        // System has less than the guaranteed amount of RAM (140 KB) - adjust some parameters to run anyway at half speed
-        if(is_full_speed()) {
-            //eta_round_time *= 2;
-            eta_total_time *= 2;
-            MSB_LIMIT /= 2;
-        }
-        block_pointers = allocate_blocks(reduced_block_sizes, num_blocks);
-        if(block_pointers == NULL) {
-            // System has less than 70 KB of RAM - should never happen so we don't reduce speed further
-            program_state->err = InsufficientRAM;
-            program_state->mfkey_state = Error;
+// A dictionary line holding only a key, comments and anything else are copied as they are
+static bool hot_keys_parse_line(FuriString* line, uint64_t* key) {
+    const char* str = furi_string_get_cstr(line);
+    size_t len = furi_string_size(line);
+    while(len > 0 && (str[len - 1] == '\n' || str[len - 1] == '\r')) {
+        len--;
+    }
+    if(len != sizeof(MfClassicKey) * 2) {
+        return false;
+    }
+    uint64_t value = 0;
+    for(size_t i = 0; i < len; i++) {
+        char c = str[i];
+        int nibble = c >= '0' && c <= '9' ? c - '0' :
+                     c >= 'A' && c <= 'F' ? c - 'A' + 10 :
+                     c >= 'a' && c <= 'f' ? c - 'a' + 10 :
+                                            -1;
+        if(nibble < 0) {
             return false;
         }
+        value = value << 4 | nibble;
+    }
+    *key = value;
+    return true;
+}
+
+static int hot_keys_find(ProgramState* program_state, uint64_t key) {
+    for(uint32_t i = 0; i < program_state->hot_key_count; i++) {
+        if(program_state->hot_keys[i].key == key) return i;
+    }
+    return -1;
+}
+
+// Puts the user dictionary back if a rewrite was interrupted between moving it aside and
+// moving the rewritten one in
+void hot_keys_restore_user_dict(void) {
+    Storage* storage = furi_record_open(RECORD_STORAGE);
+    if(!storage_file_exists(storage, KEYS_DICT_USER_PATH) &&
+       storage_file_exists(storage, HOT_KEYS_USER_BAK)) {
+        storage_common_rename(storage, HOT_KEYS_USER_BAK, KEYS_DICT_USER_PATH);
+    }
+    furi_record_close(RECORD_STORAGE);
+}
+
+// The rename does not overwrite, so the original is moved aside until the rewritten
+// dictionary is in place, and moved back if that fails
+static bool hot_keys_replace_user_dict(Storage* storage) {
+    storage_simply_remove(storage, HOT_KEYS_USER_BAK);
+    if(storage_common_rename(storage, KEYS_DICT_USER_PATH, HOT_KEYS_USER_BAK) != FSE_OK) {
+        return false;
+    }
+    if(storage_common_rename(storage, HOT_KEYS_USER_TMP, KEYS_DICT_USER_PATH) != FSE_OK) {
+        storage_common_rename(storage, HOT_KEYS_USER_BAK, KEYS_DICT_USER_PATH);
+        return false;
+    }
+    storage_simply_remove(storage, HOT_KEYS_USER_BAK);
+    return true;
+}
+
+// Moves the hot keys to the top of the user dictionary, most hits first, so the NFC app tries
+// them before the rest. The file is only rewritten when that order is not already there.
+void hot_keys_sort_user_dict(ProgramState* program_state) {
+    if(!program_state->hot_keys || program_state->hot_key_count == 0) {
+        return;
+    }
+    qsort(program_state->hot_keys, program_state->hot_key_count, sizeof(HotKey), hot_key_compare);
+    Storage* storage = furi_record_open(RECORD_STORAGE);
+    Stream* dict = buffered_file_stream_alloc(storage);
+    Stream* sorted = buffered_file_stream_alloc(storage);
+    FuriString* line = furi_string_alloc();
+    bool* present = malloc(sizeof(bool) * program_state->hot_key_count);
+    memset(present, 0, sizeof(bool) * program_state->hot_key_count);
+    bool rewrite = false;
+    do {
+        if(!buffered_file_stream_open(dict, KEYS_DICT_USER_PATH, FSAM_READ, FSOM_OPEN_EXISTING)) {
+            break;
+        }
+        // Which hot keys the dictionary has, and the ranks of its first keys (-1: not hot)
+        int leading[HOT_KEYS_MAX];
+        uint32_t leading_count = 0;
+        uint64_t key;
+        while(stream_read_line(dict, line)) {
+            if(!hot_keys_parse_line(line, &key)) continue;
+            int rank = hot_keys_find(program_state, key);
+            if(rank >= 0) {
+                present[rank] = true;
+            }
+            if(leading_count < HOT_KEYS_MAX) {
+                leading[leading_count++] = rank;
+            }
+        }
+        uint32_t next = 0;
+        for(uint32_t i = 0; i < program_state->hot_key_count && !rewrite; i++) {
+            if(!present[i]) continue;
+            rewrite = next >= leading_count || leading[next] != (int)i;
+            next++;
+        }
+        if(!rewrite) {
+            break;
+        }
+        if(!buffered_file_stream_open(sorted, HOT_KEYS_USER_TMP, FSAM_WRITE, FSOM_CREATE_ALWAYS)) {
+            rewrite = false;
+            break;
+        }
+        for(uint32_t i = 0; i < program_state->hot_key_count; i++) {
+            if(!present[i]) continue;
+            char text[CANDIDATE_LINE + 1];
+            snprintf(
+                text,
+                sizeof(text),
+                "%012llX\n",
+                (unsigned long long)program_state->hot_keys[i].key);
+            if(stream_write(sorted, (uint8_t*)text, CANDIDATE_LINE) != CANDIDATE_LINE) {
+                rewrite = false;
+                break;
+            }
+        }
+        stream_rewind(dict);
+        while(rewrite && stream_read_line(dict, line)) {
+            if(hot_keys_parse_line(line, &key) && hot_keys_find(program_state, key) >= 0) {
+                continue;
+            }
+            size_t size = furi_string_size(line);
+            if(stream_write(sorted, (uint8_t*)furi_string_get_cstr(line), size) != size) {
+                rewrite = false;
+            }
+        }
+    } while(false);
+    // A short write leaves the tmp file incomplete, keep the original then
+    bool written = buffered_file_stream_close(sorted) && rewrite;
+    buffered_file_stream_close(dict);
+    if(written && !hot_keys_replace_user_dict(storage)) {
+        FURI_LOG_E(TAG, "Failed to replace the user dictionary");
     }
-    // Adjust estimates for static encrypted attacks
-    if(n->attack == static_encrypted) {
-        eta_round_time *= 4;
-        eta_total_time *= 4;
-        if(is_full_speed()) {
-            eta_round_time *= 4;
-            eta_total_time *= 4;
+    storage_simply_remove(storage, HOT_KEYS_USER_TMP);
+    free(present);
+    furi_string_free(line);
+    stream_free(sorted);
+    stream_free(dict);
+    furi_record_close(RECORD_STORAGE);
+}
+
+// Sets the round and nonce ETA from the average measured round time of this attack type,
+// or from the defaults if no round has completed yet
+static void eta_update(AttackType attack) {
+    int round_time = ETA_ROUND_TIME;
+    if(eta_rounds[attack] > 0) {
+        round_time = (eta_rounds_ms[attack] / eta_rounds[attack] + 500) / 1000;
+        if(round_time < 1) {
+            round_time = 1;
         }
+    } else if(attack == static_encrypted) {
+        // Every surviving state is checked against the parity bits
+        round_time *= is_full_speed() ? 16 : 4;
     }
+    eta_round_time = round_time;
+    eta_total_time = round_time * (256 / MSB_LIMIT);
+}
+
+static size_t recover_arena_size(int msb_limit) {
+    return RECOVER_BLOCKS * sizeof(void*) + 2 * msb_limit * sizeof(struct Msb) +
+           (2 * TEMP_STATES_LEN + STATES_BUFFER_LEN) * sizeof(unsigned int);
+}
+
+// Heap one recover() worker needs at msb_limit, its arena plus the reserve
+size_t recover_heap_size(int msb_limit) {
+    return recover_arena_size(msb_limit) + RECOVER_HEAP_RESERVE;
+}
+
+// Allocates the tables of one recover() worker as a single arena. MSB_LIMIT is set to the
+// largest power of two up to max_msb_limit whose tables fit the largest free block, since
+// every round rebuilds the tables from scratch: fewer rounds, less time. At MSB_LIMIT 16 the
+// blocks are the former fixed {49216, 49216, 5120, 5120, 4096} bytes.
+void** recover_alloc(ProgramState* program_state, int max_msb_limit) {
+    size_t free_block = memmgr_heap_get_max_free_block();
+    int msb_limit = max_msb_limit;
+    while(msb_limit > 1 && recover_arena_size(msb_limit) + RECOVER_HEAP_RESERVE > free_block) {
+        msb_limit /= 2;
+    }
+    size_t arena_size = recover_arena_size(msb_limit);
+    if(arena_size + RECOVER_HEAP_RESERVE > free_block) {
+        program_state->err = InsufficientRAM;
+        program_state->mfkey_state = Error;
+        return NULL;
+    }
+    if(msb_limit != MSB_LIMIT) {
+        MSB_LIMIT = msb_limit;
+        // Round times measured at the old limit no longer apply
+        memset(eta_rounds, 0, sizeof(eta_rounds));
+        memset(eta_rounds_ms, 0, sizeof(eta_rounds_ms));
+    }
+    void** block_pointers = malloc(arena_size);
+    uint8_t* next = (uint8_t*)(block_pointers + RECOVER_BLOCKS);
+    const size_t block_sizes[RECOVER_BLOCKS] = {
+        msb_limit * sizeof(struct Msb),
+        msb_limit * sizeof(struct Msb),
+        TEMP_STATES_LEN * sizeof(unsigned int),
+        TEMP_STATES_LEN * sizeof(unsigned int),
+        STATES_BUFFER_LEN * sizeof(unsigned int),
+    };
+    for(int i = 0; i < RECOVER_BLOCKS; i++) {
+        block_pointers[i] = next;
+        next += block_sizes[i];
+    }
+    return block_pointers;
+}
+
+void recover_free(void** block_pointers) {
+    free(block_pointers);
+}
+
+int recover_msb_rounds() {
+    return 256 / MSB_LIMIT;
+}
+
+// Searches MSB round msb, rounds are independent of each other
+bool recover_round(
+    MfClassicNonce* n,
+    int ks2,
+    unsigned int in,
+    int msb,
+    void** block_pointers,
+    ProgramState* program_state) {
     struct Msb* odd_msbs = block_pointers[0];
     struct Msb* even_msbs = block_pointers[1];
     unsigned int* temp_states_odd = block_pointers[2];
     unsigned int* temp_states_even = block_pointers[3];
     unsigned int* states_buffer = block_pointers[4];
     int oks = 0, eks = 0;
-    int i = 0, msb = 0;
-    for(i = 31; i >= 0; i -= 2) {
+    for(int i = 31; i >= 0; i -= 2) {
         oks = oks << 1 | BEBIT(ks2, i);
     }
-    for(i = 30; i >= 0; i -= 2) {
+    for(int i = 30; i >= 0; i -= 2) {
         eks = eks << 1 | BEBIT(ks2, i);
     }
+    return calculate_msb_tables(
+        oks,
+        eks,
+        msb,
+        n,
+        states_buffer,
+        odd_msbs,
+        even_msbs,
+        temp_states_odd,
+        temp_states_even,
+        in,
+        program_state);
+}
+
+bool recover(MfClassicNonce* n, int ks2, unsigned int in, ProgramState* program_state) {
+    bool found = false;
+    // A resumed nonce keeps at most its saved limit: recover_alloc only halves it, so msb_done
+    // stays on a round boundary and no round is searched twice
+    int max_msb_limit = checkpoint.msb_done > 0 ? (int)checkpoint.msb_limit : MSB_LIMIT_MAX;
+    void** block_pointers = recover_alloc(program_state, max_msb_limit);
+    if(block_pointers == NULL) {
+        return false;
+    }
+    int msb = 0, rounds = 256 / MSB_LIMIT;
+    eta_update(n->attack);
     int bench_start = furi_hal_rtc_get_timestamp();
     program_state->eta_total = eta_total_time;
     program_state->eta_timestamp = bench_start;
-    for(msb = 0; msb <= ((256 / MSB_LIMIT) - 1); msb++) {
+    // Resumed nonce: skip the rounds the checkpoint covers
+    int first_msb = checkpoint.msb_done / MSB_LIMIT;
+    checkpoint.msb_done = 0;
+    for(msb = first_msb; msb <= rounds - 1; msb++) {
         program_state->search = msb;
         program_state->eta_round = eta_round_time;
-        program_state->eta_total = eta_total_time - (eta_round_time * msb);
-        if(calculate_msb_tables(
-               oks,
-               eks,
-               msb,
-               n,
-               states_buffer,
-               odd_msbs,
-               even_msbs,
-               temp_states_odd,
-               temp_states_even,
-               in,
-               program_state)) {
+        program_state->eta_total = eta_round_time * (rounds - msb);
+        uint32_t round_start = furi_get_tick();
+        if(recover_round(n, ks2, in, msb, block_pointers, program_state)) {
             //int bench_stop = furi_hal_rtc_get_timestamp();
             //FURI_LOG_I(TAG, "Cracked in %i seconds", bench_stop - bench_start);
             found = true;
             break;
         }
+        if(program_state->candidates) {
+            // Candidates must be on the card before the checkpoint covers their round
+            candidate_writer_flush(program_state->candidates);
+            buffered_file_stream_sync(program_state->candidates->dict->stream);
+        }
         if(program_state->close_thread_please) {
             break;
         }
+        uint32_t round_ms = furi_get_tick() - round_start;
+        eta_rounds[n->attack]++;
+        eta_rounds_ms[n->attack] += round_ms;
+        program_state->rounds_done++;
+        program_state->rounds_ms += round_ms;
+        eta_update(n->attack);
+        checkpoint_save(program_state, checkpoint.nonce_index, (msb + 1) * MSB_LIMIT);
     }
-    // Free the allocated blocks
-    for(int i = 0; i < num_blocks; i++) {
-        free(block_pointers[i]);
-    }
-    free(block_pointers);
+    recover_free(block_pointers);
     return found;
 }
 
@@ -539,11 +1630,13 @@ bool key_already_found_for_nonce_in_solved(
             crypt_word_noret(&temp, nonce->uid_xor_nt1, 0);
             crypt_word_noret(&temp, nonce->nr1_enc, 1);
             if(nonce->ar1_enc == (crypt_word(&temp) ^ nonce->p64b)) {
+                nonce->key = keyarray[k];
                 return true;
             }
         } else if(nonce->attack == static_nested) {
             uint32_t expected_ks1 = crypt_word_ret(&temp, nonce->uid_xor_nt0, 0);
             if(nonce->ks1_1_enc == expected_ks1) {
+                nonce->key = keyarray[k];
                 return true;
             }
         }
@@ -561,6 +1654,50 @@ static void finished_beep() {
     furi_record_close("notification");
 }
 
+static uint32_t phase_ms(ProgramState* program_state, MfkeyPhase phase) {
+    return program_state->phase_cycles[phase] /
+           (furi_hal_cortex_instructions_per_microsecond() * 1000);
+}
+
+// Appends a one line summary of the run to STATS_LOG_PATH
+// Runs on the MFKeyWorker stack after recover(), so the line is formatted on the heap
+static void stats_log_write(ProgramState* program_state) {
+    FuriString* line = furi_string_alloc_printf(
+        "%lu nonces=%d cracked=%d unique=%d candidates=%d msb_limit=%d rounds=%lu round_ms=%lu "
+        "table_ms=%lu sort_ms=%lu join_ms=%lu check_ms=%lu dict_io_ms=%lu "
+        "parity_checked=%lu parity_pruned=%lu seed_checked=%lu seed_pruned=%lu "
+        "hot_key_hits=%lu\n",
+        (unsigned long)furi_hal_rtc_get_timestamp(),
+        program_state->total,
+        program_state->cracked,
+        program_state->unique_cracked,
+        program_state->num_candidates,
+        MSB_LIMIT,
+        (unsigned long)program_state->rounds_done,
+        (unsigned long)(program_state->rounds_done ?
+                            program_state->rounds_ms / program_state->rounds_done :
+                            0),
+        (unsigned long)phase_ms(program_state, PhaseTableBuild),
+        (unsigned long)phase_ms(program_state, PhaseSort),
+        (unsigned long)phase_ms(program_state, PhaseJoin),
+        (unsigned long)phase_ms(program_state, PhaseCheck),
+        (unsigned long)(program_state->dict_io_ms + program_state->candidate_flush_ticks),
+        (unsigned long)program_state->parity_checked,
+        (unsigned long)program_state->parity_pruned,
+        (unsigned long)program_state->seed_checked,
+        (unsigned long)program_state->seed_pruned,
+        (unsigned long)program_state->hot_key_hits);
+    Storage* storage = furi_record_open(RECORD_STORAGE);
+    Stream* stream = buffered_file_stream_alloc(storage);
+    if(buffered_file_stream_open(stream, STATS_LOG_PATH, FSAM_WRITE, FSOM_OPEN_APPEND)) {
+        stream_write(stream, (uint8_t*)furi_string_get_cstr(line), furi_string_size(line));
+    }
+    buffered_file_stream_close(stream);
+    stream_free(stream);
+    furi_record_close(RECORD_STORAGE);
+    furi_string_free(line);
+}
+
 void mfkey(ProgramState* program_state) {
     uint32_t ks_enc = 0, nt_xor_uid = 0;
     MfClassicKey found_key; // Recovered key
@@ -587,6 +1724,7 @@ void mfkey(ProgramState* program_state) {
         return;
     }
     // Read dictionaries (optional)
+    hot_keys_restore_user_dict();
     KeysDict* system_dict = {0};
     bool system_dict_exists = keys_dict_check_presence(KEYS_DICT_SYSTEM_PATH);
     KeysDict* user_dict = {0};
@@ -604,15 +1742,19 @@ void mfkey(ProgramState* program_state) {
     user_dict_exists = true;
     program_state->dict_count = total_dict_keys;
     program_state->mfkey_state = DictionaryAttack;
+    hot_keys_load(program_state);
     // Read nonces
     MfClassicNonceArray* nonce_arr;
+    uint32_t dict_start = furi_get_tick();
     nonce_arr = init_plugin->napi_mf_classic_nonce_array_alloc(
         system_dict, system_dict_exists, user_dict, program_state);
+    program_state->dict_io_ms += furi_get_tick() - dict_start;
     if(system_dict_exists) {
         keys_dict_free(system_dict);
     }
     if(nonce_arr->total_nonces == 0) {
-        // Nothing to crack
+        // Nothing to crack, and nothing left to resume
+        checkpoint_remove();
         program_state->err = ZeroNonces;
         program_state->mfkey_state = Error;
         init_plugin->napi_mf_classic_nonce_array_free(nonce_arr);
@@ -620,6 +1762,9 @@ void mfkey(ProgramState* program_state) {
         furi_record_close(RECORD_STORAGE);
         keys_dict_free(user_dict);
         free(keyarray);
+        // Hot keys may have solved every nonce
+        hot_keys_save(program_state);
+        hot_keys_free(program_state);
         return;
     }
     flipper_application_free(app);
@@ -632,10 +1777,21 @@ void mfkey(ProgramState* program_state) {
     stream_free(nonce_arr->stream);
     //FURI_LOG_I(TAG, "Free heap after free(): %zub", memmgr_get_free_heap());
     program_state->mfkey_state = MFKeyAttack;
+    checkpoint.nonce_arr = nonce_arr;
+    checkpoint.nonce_index = 0;
+    checkpoint.msb_done = 0;
+    if(program_state->resume && !checkpoint_load(program_state, &keyarray, &keyarray_size)) {
+        FURI_LOG_W(TAG, "Checkpoint does not match the nonces, starting over");
+    }
+    checkpoint.keys = keyarray;
+    checkpoint.key_count = keyarray_size;
+    checkpoint.enabled = true;
     // TODO: Work backwards on this array and free memory
-    for(i = 0; i < nonce_arr->total_nonces; i++) {
+    for(i = checkpoint.nonce_index; i < nonce_arr->total_nonces; i++) {
         MfClassicNonce next_nonce = nonce_arr->remaining_nonce_array[i];
+        checkpoint.nonce_index = i;
         if(key_already_found_for_nonce_in_solved(keyarray, keyarray_size, &next_nonce)) {
+            hot_keys_credit(program_state, &next_nonce.key);
             nonce_arr->remaining_nonces--;
             (program_state->cracked)++;
             (program_state->num_completed)++;
@@ -662,23 +1818,44 @@ void mfkey(ProgramState* program_state) {
                 furi_string_get_cstr(cuid_dict_path),
                 KeysDictModeOpenAlways,
                 sizeof(MfClassicKey));
+            furi_string_free(cuid_dict_path);
+            if(candidate_writer_nonce_done(program_state->cuid_dict, &next_nonce)) {
+                // Candidates were written by an earlier run
+                keys_dict_free(program_state->cuid_dict);
+                program_state->cuid_dict = NULL;
+                (program_state->num_completed)++;
+                checkpoint_save(program_state, i + 1, 0);
+                continue;
+            }
+            if(checkpoint.msb_done > 0) {
+                candidate_dict_truncate(program_state->cuid_dict, checkpoint.candidate_dict_size);
+            }
+            program_state->candidates = candidate_writer_alloc(program_state->cuid_dict);
             break;
         }
 
         if(!recover(&next_nonce, ks_enc, nt_xor_uid, program_state)) {
             if((next_nonce.attack == static_encrypted) && (program_state->cuid_dict)) {
+                bool complete = !(program_state->close_thread_please) &&
+                                program_state->mfkey_state != Error;
+                candidate_writer_free(
+                    program_state->candidates, program_state, complete ? &next_nonce : NULL);
+                program_state->candidates = NULL;
                 keys_dict_free(program_state->cuid_dict);
+                program_state->cuid_dict = NULL;
             }
             if(program_state->close_thread_please) {
                 break;
             }
             // No key found in recover() or static encrypted
             (program_state->num_completed)++;
+            checkpoint_save(program_state, i + 1, 0);
             continue;
         }
         (program_state->cracked)++;
         (program_state->num_completed)++;
         found_key = next_nonce.key;
+        hot_keys_credit(program_state, &found_key);
         bool already_found = false;
         for(j = 0; j < keyarray_size; j++) {
             if(memcmp(keyarray[j].data, found_key.data, MF_CLASSIC_KEY_SIZE) == 0) {
@@ -692,10 +1869,17 @@ void mfkey(ProgramState* program_state) {
             keyarray_size += 1;
             keyarray[keyarray_size - 1] = found_key;
             (program_state->unique_cracked)++;
+            checkpoint.keys = keyarray;
+            checkpoint.key_count = keyarray_size;
         }
+        checkpoint_save(program_state, i + 1, 0);
+    }
+    checkpoint.enabled = false;
+    // Keep the checkpoint if the user stopped the run, so it can be resumed
+    if(!(program_state->close_thread_please) && program_state->mfkey_state != Error) {
+        checkpoint_remove();
     }
     // TODO: Update display to show all keys were found
-    // TODO: Prepend found key(s) to user dictionary file
     //FURI_LOG_I(TAG, "Unique keys found:");
     for(i = 0; i < keyarray_size; i++) {
         //FURI_LOG_I(TAG, "%012" PRIx64, keyarray[i]);
@@ -707,6 +1891,10 @@ void mfkey(ProgramState* program_state) {
     free(nonce_arr);
     keys_dict_free(user_dict);
     free(keyarray);
+    hot_keys_save(program_state);
+    hot_keys_sort_user_dict(program_state);
+    hot_keys_free(program_state);
+    stats_log_write(program_state);
     if(program_state->mfkey_state == Error) {
         return;
     }
@@ -790,6 +1978,9 @@ static void render_callback(Canvas* const canvas, void* ctx) {
         }
     } else if(program_state->mfkey_state == Ready) {
         canvas_draw_str_aligned(canvas, 50, 30, AlignLeft, AlignTop, "Ready");
+        if(program_state->checkpoint_present) {
+            elements_button_left(canvas, "Resume");
+        }
         elements_button_center(canvas, "Start");
         elements_button_right(canvas, "Help");
     } else if(program_state->mfkey_state == Help) {
@@ -828,8 +2019,22 @@ static void mfkey_state_init(ProgramState* program_state) {
     program_state->unique_cracked = 0;
     program_state->num_completed = 0;
     program_state->num_candidates = 0;
+    program_state->candidate_duplicates = 0;
+    program_state->candidate_flushes = 0;
+    program_state->candidate_flush_ticks = 0;
+    program_state->seed_checked = 0;
+    program_state->seed_pruned = 0;
+    memset(program_state->phase_cycles, 0, sizeof(program_state->phase_cycles));
+    program_state->dict_io_ms = 0;
+    program_state->rounds_done = 0;
+    program_state->rounds_ms = 0;
+    program_state->cuid_dict = NULL;
+    program_state->candidates = NULL;
     program_state->total = 0;
     program_state->dict_count = 0;
+    program_state->close_thread_please = false;
+    program_state->checkpoint_present = checkpoint_exists();
+    program_state->resume = false;
 }
 
 // Entrypoint for worker thread
@@ -875,6 +2080,12 @@ int32_t mfkey_main() {
                         program_state->mfkey_state = Help;
                     }
                     break;
+                case InputKeyLeft:
+                    if(program_state->mfkey_state == Ready && program_state->checkpoint_present) {
+                        program_state->resume = true;
+                        furi_thread_start(program_state->mfkeythread);
+                    }
+                    break;
                 case InputKeyOk:
                     if(program_state->mfkey_state == Ready) {
                         furi_thread_start(program_state->mfkeythread);
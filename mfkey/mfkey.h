@@ -12,11 +12,42 @@
 struct Crypto1State {
     uint32_t odd, even;
 };
+// Until calculate_msb_tables() compacts it, states is an open addressing hash set
 struct Msb {
     int tail;
     uint32_t states[768];
 };
 
+// Candidate keys of a static encrypted nonce, collected in a hash set and appended to the
+// per-UID dictionary in sorted batches
+typedef struct {
+    KeysDict* dict;
+    uint64_t* set; // CANDIDATE_SET_SIZE slots, 0 = empty
+    size_t count;
+    char* text; // Formatted batch, one stream_write() per flush
+    uint32_t written;
+    uint32_t duplicates; // Keys already in the batch or anywhere in the dictionary
+    uint32_t flushes;
+    uint32_t flush_ticks;
+} CandidateWriter;
+
+// Phases timed by MFKEY_PHASE_TIMERS in mfkey.c
+typedef enum {
+    PhaseTableBuild, // MSB table generation in calculate_msb_tables()
+    PhaseSort, // Sorting the tables in old_recover()
+    PhaseJoin, // Extending and merge-joining the tables, less sort and check
+    PhaseCheck, // Testing the candidate states
+    PhaseCount,
+} MfkeyPhase;
+
+// Hot key cache (nfc/.mfkey_hot_keys.bin): recovered keys ranked by the nonces they solved
+#define HOT_KEYS_MAX 32
+typedef struct {
+    uint64_t key;
+    uint32_t hits; // Nonces solved by this key, over all runs
+    uint32_t last_seen; // RTC timestamp of the last one
+} HotKey;
+
 typedef enum {
     MissingNonces,
     ZeroNonces,
@@ -51,8 +82,35 @@ typedef struct {
     bool mfkey32_present;
     bool nested_present;
     bool close_thread_please;
+    bool checkpoint_present; // A saved run can be resumed from the Ready screen
+    bool resume;
     FuriThread* mfkeythread;
     KeysDict* cuid_dict;
+    CandidateWriter* candidates;
+    // Hot keys, tested against the nonces before the dictionaries (room for HOT_KEYS_MAX)
+    HotKey* hot_keys;
+    uint32_t hot_key_count;
+    uint32_t hot_key_hits; // Nonces solved by them in this run
+    // Candidate writer totals, summed over all static encrypted nonces
+    uint32_t candidate_duplicates;
+    uint32_t candidate_flushes;
+    uint32_t candidate_flush_ticks;
+    // MSB table deduplication counters, summed over all recover() calls
+    uint32_t msb_lookups;
+    uint32_t msb_probes;
+    uint32_t msb_collisions;
+    // States rejected by the parity bit of their last keystream byte, before any other check
+    uint32_t parity_checked;
+    uint32_t parity_pruned;
+    // Static encrypted states that matched ks0, and those rejected because nt0 is not a nonce
+    // the tag's PRNG generates from its upper 16 bits
+    uint32_t seed_checked;
+    uint32_t seed_pruned;
+    // Phase timers in cycles (furi_hal_cortex_timer_get()) and completed MSB rounds
+    uint64_t phase_cycles[PhaseCount];
+    uint32_t dict_io_ms; // Nonce loading and dictionary attack
+    uint32_t rounds_done;
+    uint32_t rounds_ms;
 } ProgramState;
 
 typedef enum {
@@ -69,6 +127,11 @@ typedef struct {
     uint32_t nt1; // tag challenge second
     uint32_t uid_xor_nt0; // uid ^ nt0
     uint32_t uid_xor_nt1; // uid ^ nt1
+    // Parity bits as logged, MSB first: {nr0}{ar0} / {nr1}{ar1} (Mfkey32, 8 bits each) or the
+    // nt0 / nt1 bytes (nested, 4 bits each)
+    uint8_t par_1;
+    uint8_t par_2;
+    bool parity; // par_1 and par_2 are known and agree with the keystream
     union {
         // Mfkey32
         struct {
@@ -83,10 +146,9 @@ typedef struct {
         struct {
             uint32_t ks1_1_enc; // first encrypted keystream
             uint32_t ks1_2_enc; // second encrypted keystream
+            uint32_t nt0_seeded; // nt0 as the tag's PRNG generates it from its upper half
             char par_1_str[5]; // first parity bits (string representation)
             char par_2_str[5]; // second parity bits (string representation)
-            uint8_t par_1; // first parity bits
-            uint8_t par_2; // second parity bits
         };
     };
 } MfClassicNonce;
@@ -96,6 +158,7 @@ typedef struct {
     uint32_t total_nonces;
     MfClassicNonce* remaining_nonce_array;
     size_t remaining_nonces;
+    size_t capacity; // allocated entries of remaining_nonce_array
 } MfClassicNonceArray;
 
 struct KeysDict {